@@ -11,6 +11,7 @@ import os
 import subprocess
 import sys
 import tempfile
+import threading
 import unittest
 import dbusmock
 
@@ -125,12 +126,14 @@ class FwupdTest(dbusmock.DBusTestCase):
     # Daemon control and D-BUS I/O
     #
 
-    def start_daemon(self):
+    def start_daemon(self, extra_env=None):
         """Start daemon and create DBus proxy.
 
         When done, this sets self.proxy as the Gio.DBusProxy for power-profiles-daemon.
         """
         env = os.environ.copy()
+        if extra_env:
+            env.update(extra_env)
         env["G_DEBUG"] = "fatal-criticals"
         env["G_MESSAGES_DEBUG"] = "all"
         # note: Python doesn't propagate the setenv from Testbed.new(), so we
@@ -321,6 +324,156 @@ class VeryBasicTest(FwupdTest):
         # Should be at least the CPU test is running on
         self.assertGreater(len(devices), 0)
 
+    def test_get_devices_if_changed(self):
+        """Test GetDevicesIfChanged only skips the transfer for the same daemon."""
+        self.start_daemon()
+
+        devices, generation = self.proxy.call_sync(
+            "GetDevicesIfChanged",
+            GLib.Variant("(t)", (0,)),
+            Gio.DBusCallFlags.NONE,
+            -1,
+            None,
+        ).unpack()
+        self.assertGreater(len(devices), 0)
+
+        # nothing changed
+        devices, generation_new = self.proxy.call_sync(
+            "GetDevicesIfChanged",
+            GLib.Variant("(t)", (generation,)),
+            Gio.DBusCallFlags.NONE,
+            -1,
+            None,
+        ).unpack()
+        self.assertEqual(len(devices), 0)
+        self.assertEqual(generation_new, generation)
+
+        # a restarted daemon must not match the generation from before
+        self.stop_daemon()
+        self.start_daemon()
+        devices, generation_new = self.proxy.call_sync(
+            "GetDevicesIfChanged",
+            GLib.Variant("(t)", (generation,)),
+            Gio.DBusCallFlags.NONE,
+            -1,
+            None,
+        ).unpack()
+        self.assertGreater(len(devices), 0)
+        self.assertNotEqual(generation_new, generation)
+
+    def test_get_devices_while_busy(self):
+        """Test GetDevices is answered while an install is blocked."""
+        try:
+            gi.require_version("GCab", "1.0")
+            from gi.repository import GCab  # pylint: disable=import-outside-toplevel
+        except (ValueError, ImportError):
+            self.skipTest("GCab not available to build the archive")
+
+        # enable the test plugin and make the write wait until we delete the file
+        # pylint: disable=consider-using-with
+        sysconfdir = tempfile.TemporaryDirectory()
+        self.addCleanup(sysconfdir.cleanup)
+        os.makedirs(os.path.join(sysconfdir.name, "fwupd"))
+        block_fn = os.path.join(sysconfdir.name, "write-block")
+        self.addCleanup(lambda: os.path.exists(block_fn) and os.unlink(block_fn))
+        with open(
+            os.path.join(sysconfdir.name, "fwupd", "fwupd.conf"), "w", encoding="utf-8"
+        ) as f:
+            f.write(
+                f"[fwupd]\nTestDevices=true\n[test]\nWriteBlockFilename={block_fn}\n"
+            )
+        self.start_daemon({"FWUPD_SYSCONFDIR": sysconfdir.name})
+
+        # build the archive from the files shipped alongside this test
+        srcdir = os.path.dirname(os.path.abspath(__file__))
+        cab_fn = os.path.join(sysconfdir.name, "fakedevice124.cab")
+        cabinet = GCab.Cabinet.new()
+        folder = GCab.Folder.new(GCab.Compression.NONE)
+        for basename in [
+            "fakedevice124.bin",
+            "fakedevice124.jcat",
+            "fakedevice124.metainfo.xml",
+        ]:
+            file = Gio.File.new_for_path(os.path.join(srcdir, basename))
+            folder.add_file(GCab.File.new_with_file(basename, file), False, None)
+        cabinet.add_folder(folder)
+        stream = Gio.File.new_for_path(cab_fn).replace(
+            None, False, Gio.FileCreateFlags.NONE, None
+        )
+        cabinet.write_simple(stream, None, None)
+        stream.close(None)
+
+        device_id = None
+        for device in self.client.get_devices():
+            if device.has_guid("b585990a-003e-5270-89d5-3705a17f9a43"):
+                device_id = device.get_id()
+        self.assertIsNotNone(device_id, "no test device")
+
+        # the install blocks the main loop of the daemon until the file is deleted
+        error = []
+
+        def install_cb():
+            gi.require_version("Fwupd", "2.0")
+            from gi.repository import Fwupd  # pylint: disable=import-outside-toplevel
+
+            try:
+                Fwupd.Client().install(device_id, cab_fn, Fwupd.InstallFlags.NONE, None)
+            except GLib.Error as exc:
+                error.append(exc)
+
+        thread = threading.Thread(target=install_cb)
+        thread.start()
+        self.assert_eventually(
+            lambda: os.path.exists(block_fn),
+            timeout=30000,
+            message="write did not start",
+        )
+
+        # the write cannot finish, but GetDevices is answered from the snapshot
+        val = self.proxy.call_sync(
+            "GetDevices", None, Gio.DBusCallFlags.NONE, 10000, None
+        )
+        self.assertGreater(len(val.unpack()[0]), 0)
+        self.assertTrue(os.path.exists(block_fn))
+
+        # these need the engine, so are queued until the write has finished
+        replies = {}
+
+        def call_cb(proxy, res, method_name):
+            try:
+                replies[method_name] = proxy.call_finish(res)
+            except GLib.Error as exc:
+                replies[method_name] = exc
+
+        for method_name, parameters in [
+            ("GetReleases", GLib.Variant("(s)", (device_id,))),
+            ("GetUpgrades", GLib.Variant("(s)", (device_id,))),
+            ("GetHistory", None),
+        ]:
+            self.proxy.call(
+                method_name,
+                parameters,
+                Gio.DBusCallFlags.NONE,
+                30000,
+                None,
+                call_cb,
+                method_name,
+            )
+        os.unlink(block_fn)
+        thread.join()
+        self.assertEqual(error, [])
+
+        # every call got a reply from the daemon, even if it was a fwupd error
+        self.assert_eventually(lambda: len(replies) == 3, timeout=30000)
+        for method_name, reply in replies.items():
+            if isinstance(reply, GLib.Error):
+                self.assertTrue(
+                    Gio.DBusError.get_remote_error(reply).startswith(
+                        "org.freedesktop.fwupd."
+                    ),
+                    f"{method_name}: {reply.message}",
+                )
+
 
 if __name__ == "__main__":
     # run ourselves under umockdev
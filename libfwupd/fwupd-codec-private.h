@@ -20,3 +20,6 @@ fwupd_codec_json_append_int(JsonBuilder *builder, const gchar *key, guint64 valu
 void
 fwupd_codec_json_append_bool(JsonBuilder *builder, const gchar *key, gboolean value)
     G_GNUC_NON_NULL(1, 2);
+guint
+fwupd_codec_key_lookup(GHashTable **keys, const gchar *const *strs, guint strsz, const gchar *key)
+    G_GNUC_NON_NULL(1, 2);
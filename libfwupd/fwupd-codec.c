@@ -585,3 +585,32 @@ fwupd_codec_json_append_strv(JsonBuilder *builder, const gchar *key, gchar **val
 		json_builder_add_string_value(builder, value[i]);
 	json_builder_end_array(builder);
 }
+
+/**
+ * fwupd_codec_key_lookup: (skip):
+ * @keys: (inout): a static #GHashTable, created on first use
+ * @strs: key names, indexed by value
+ * @strsz: number of elements in @strs
+ * @key: (nullable): a key name, e.g. `Name`
+ *
+ * Converts a dictionary key into a table index using a hash table that is built once, rather
+ * than comparing @key against every known key name in turn.
+ *
+ * Returns: index into @strs, or 0 if @key is unknown
+ **/
+guint
+fwupd_codec_key_lookup(GHashTable **keys, const gchar *const *strs, guint strsz, const gchar *key)
+{
+	if (g_once_init_enter(keys)) {
+		GHashTable *keys_tmp = g_hash_table_new(g_str_hash, g_str_equal);
+		for (guint i = 0; i < strsz; i++) {
+			if (strs[i] == NULL)
+				continue;
+			g_hash_table_insert(keys_tmp, (gpointer)strs[i], GUINT_TO_POINTER(i));
+		}
+		g_once_init_leave(keys, keys_tmp);
+	}
+	if (key == NULL)
+		return 0;
+	return GPOINTER_TO_UINT(g_hash_table_lookup(*keys, key));
+}
@@ -729,12 +729,19 @@ fwupd_unix_input_stream_from_bytes(GBytes *bytes, GError **error)
 {
 	gint fd;
 	gssize rc;
+	gsize bufsz = 0;
+	gsize offset = 0;
+	const guint8 *buf = g_bytes_get_data(bytes, &bufsz);
 #ifndef HAVE_MEMFD_CREATE
 	gchar tmp_file[] = "/tmp/fwupd.XXXXXX";
 #endif
 
 #ifdef HAVE_MEMFD_CREATE
+#ifdef MFD_ALLOW_SEALING
+	fd = memfd_create("fwupd", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
 	fd = memfd_create("fwupd", MFD_CLOEXEC);
+#endif
 #else
 	/* emulate in-memory file by an unlinked temporary file */
 	fd = g_mkstemp(tmp_file);
@@ -761,15 +768,28 @@ fwupd_unix_input_stream_from_bytes(GBytes *bytes, GError **error)
 				    "failed to create memfd");
 		return NULL;
 	}
-	rc = write(fd, g_bytes_get_data(bytes, NULL), g_bytes_get_size(bytes));
-	if (rc < 0) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INVALID_FILE,
-			    "failed to write %" G_GSSIZE_FORMAT,
-			    rc);
-		return NULL;
+	while (offset < bufsz) {
+		rc = write(fd, buf + offset, bufsz - offset);
+		if (rc < 0 && errno == EINTR)
+			continue;
+		if (rc <= 0) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "failed to write %" G_GSSIZE_FORMAT,
+				    rc);
+			g_close(fd, NULL);
+			return NULL;
+		}
+		offset += rc;
 	}
+
+#if defined(HAVE_MEMFD_CREATE) && defined(F_ADD_SEALS)
+	/* the daemon can then map this rather than reading it, and we cannot change it after it
+	 * has been validated -- old kernels do not support this, so failure is not fatal */
+	if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0)
+		g_debug("failed to seal memfd: %s", g_strerror(errno));
+#endif
 	if (lseek(fd, 0, SEEK_SET) < 0) {
 		g_set_error(error,
 			    FWUPD_ERROR,
@@ -787,11 +807,23 @@ fwupd_unix_input_stream_from_bytes(GBytes *bytes, GError **error)
 GUnixInputStream *
 fwupd_unix_input_stream_from_fn(const gchar *fn, GError **error)
 {
-	gint fd = open(fn, O_RDONLY);
-	if (fd < 0) {
-		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE, "failed to open %s", fn);
+	g_autoptr(GBytes) bytes = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GMappedFile) mmap = NULL;
+
+	/* copied into a sealed memfd so that the daemon can map it, and so the file can be
+	 * modified or deleted once the request has been sent */
+	mmap = g_mapped_file_new(fn, FALSE, &error_local);
+	if (mmap == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "failed to open %s: %s",
+			    fn,
+			    error_local->message);
 		return NULL;
 	}
-	return G_UNIX_INPUT_STREAM(g_unix_input_stream_new(fd, TRUE));
+	bytes = g_mapped_file_get_bytes(mmap);
+	return fwupd_unix_input_stream_from_bytes(bytes, error);
 }
 #endif
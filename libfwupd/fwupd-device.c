@@ -35,10 +35,10 @@ typedef struct {
 	guint64 flags;
 	guint64 request_flags;
 	guint64 problems;
-	GPtrArray *guids;
+	GPtrArray *guids; /* (element-type utf-8) interned */
 	GPtrArray *vendor_ids;
 	GPtrArray *protocols;
-	GPtrArray *instance_ids;
+	GPtrArray *instance_ids; /* (element-type utf-8) interned */
 	GPtrArray *icons;
 	GPtrArray *issues; /* of utf-8 */
 	gchar *name;
@@ -636,6 +636,20 @@ fwupd_device_get_guids(FwupdDevice *self)
 	return priv->guids;
 }
 
+/*
+ * The GUIDs and instance IDs are shared by many devices, and so are stored in the GLib interned
+ * string table -- which means the canonical pointer can be compared rather than the contents.
+ * Returns %NULL if @str has never been interned, and so cannot be used by any device.
+ */
+static const gchar *
+fwupd_device_intern_lookup(const gchar *str)
+{
+	GQuark quark = g_quark_try_string(str);
+	if (quark == 0)
+		return NULL;
+	return g_quark_to_string(quark);
+}
+
 /**
  * fwupd_device_has_guid:
  * @self: a #FwupdDevice
@@ -651,13 +665,16 @@ gboolean
 fwupd_device_has_guid(FwupdDevice *self, const gchar *guid)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	const gchar *guid_interned;
 
 	g_return_val_if_fail(FWUPD_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(guid != NULL, FALSE);
 
+	guid_interned = fwupd_device_intern_lookup(guid);
+	if (guid_interned == NULL)
+		return FALSE;
 	for (guint i = 0; i < priv->guids->len; i++) {
-		const gchar *guid_tmp = g_ptr_array_index(priv->guids, i);
-		if (g_strcmp0(guid, guid_tmp) == 0)
+		if (g_ptr_array_index(priv->guids, i) == guid_interned)
 			return TRUE;
 	}
 	return FALSE;
@@ -680,7 +697,7 @@ fwupd_device_add_guid(FwupdDevice *self, const gchar *guid)
 	g_return_if_fail(guid != NULL);
 	if (fwupd_device_has_guid(self, guid))
 		return;
-	g_ptr_array_add(priv->guids, g_strdup(guid));
+	g_ptr_array_add(priv->guids, (gpointer)g_intern_string(guid));
 }
 
 /**
@@ -736,13 +753,16 @@ gboolean
 fwupd_device_has_instance_id(FwupdDevice *self, const gchar *instance_id)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	const gchar *instance_id_interned;
 
 	g_return_val_if_fail(FWUPD_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(instance_id != NULL, FALSE);
 
+	instance_id_interned = fwupd_device_intern_lookup(instance_id);
+	if (instance_id_interned == NULL)
+		return FALSE;
 	for (guint i = 0; i < priv->instance_ids->len; i++) {
-		const gchar *instance_id_tmp = g_ptr_array_index(priv->instance_ids, i);
-		if (g_strcmp0(instance_id, instance_id_tmp) == 0)
+		if (g_ptr_array_index(priv->instance_ids, i) == instance_id_interned)
 			return TRUE;
 	}
 	return FALSE;
@@ -765,7 +785,7 @@ fwupd_device_add_instance_id(FwupdDevice *self, const gchar *instance_id)
 	g_return_if_fail(instance_id != NULL);
 	if (fwupd_device_has_instance_id(self, instance_id))
 		return;
-	g_ptr_array_add(priv->instance_ids, g_strdup(instance_id));
+	g_ptr_array_add(priv->instance_ids, (gpointer)g_intern_string(instance_id));
 }
 
 /**
@@ -2223,10 +2243,109 @@ fwupd_device_to_variant(FwupdCodec *converter, FwupdCodecFlags flags)
 	return g_variant_new("a{sv}", &builder);
 }
 
+typedef enum {
+	FWUPD_DEVICE_KEY_UNKNOWN,
+	FWUPD_DEVICE_KEY_RELEASE,
+	FWUPD_DEVICE_KEY_DEVICE_ID,
+	FWUPD_DEVICE_KEY_PARENT_DEVICE_ID,
+	FWUPD_DEVICE_KEY_COMPOSITE_ID,
+	FWUPD_DEVICE_KEY_FLAGS,
+	FWUPD_DEVICE_KEY_PROBLEMS,
+	FWUPD_DEVICE_KEY_REQUEST_FLAGS,
+	FWUPD_DEVICE_KEY_CREATED,
+	FWUPD_DEVICE_KEY_MODIFIED,
+	FWUPD_DEVICE_KEY_VERSION_BUILD_DATE,
+	FWUPD_DEVICE_KEY_GUID,
+	FWUPD_DEVICE_KEY_INSTANCE_IDS,
+	FWUPD_DEVICE_KEY_ICON,
+	FWUPD_DEVICE_KEY_NAME,
+	FWUPD_DEVICE_KEY_VENDOR,
+	FWUPD_DEVICE_KEY_VENDOR_ID,
+	FWUPD_DEVICE_KEY_SERIAL,
+	FWUPD_DEVICE_KEY_SUMMARY,
+	FWUPD_DEVICE_KEY_BRANCH,
+	FWUPD_DEVICE_KEY_CHECKSUM,
+	FWUPD_DEVICE_KEY_PLUGIN,
+	FWUPD_DEVICE_KEY_PROTOCOL,
+	FWUPD_DEVICE_KEY_ISSUES,
+	FWUPD_DEVICE_KEY_VERSION,
+	FWUPD_DEVICE_KEY_VERSION_LOWEST,
+	FWUPD_DEVICE_KEY_VERSION_BOOTLOADER,
+	FWUPD_DEVICE_KEY_FLASHES_LEFT,
+	FWUPD_DEVICE_KEY_BATTERY_LEVEL,
+	FWUPD_DEVICE_KEY_BATTERY_THRESHOLD,
+	FWUPD_DEVICE_KEY_INSTALL_DURATION,
+	FWUPD_DEVICE_KEY_UPDATE_ERROR,
+	FWUPD_DEVICE_KEY_UPDATE_MESSAGE,
+	FWUPD_DEVICE_KEY_UPDATE_IMAGE,
+	FWUPD_DEVICE_KEY_UPDATE_STATE,
+	FWUPD_DEVICE_KEY_STATUS,
+	FWUPD_DEVICE_KEY_PERCENTAGE,
+	FWUPD_DEVICE_KEY_VERSION_FORMAT,
+	FWUPD_DEVICE_KEY_VERSION_RAW,
+	FWUPD_DEVICE_KEY_VERSION_LOWEST_RAW,
+	FWUPD_DEVICE_KEY_VERSION_BOOTLOADER_RAW,
+	FWUPD_DEVICE_KEY_LAST
+} FwupdDeviceKey;
+
+static const gchar *const fwupd_device_keys[] = {
+    [FWUPD_DEVICE_KEY_RELEASE] = FWUPD_RESULT_KEY_RELEASE,
+    [FWUPD_DEVICE_KEY_DEVICE_ID] = FWUPD_RESULT_KEY_DEVICE_ID,
+    [FWUPD_DEVICE_KEY_PARENT_DEVICE_ID] = FWUPD_RESULT_KEY_PARENT_DEVICE_ID,
+    [FWUPD_DEVICE_KEY_COMPOSITE_ID] = FWUPD_RESULT_KEY_COMPOSITE_ID,
+    [FWUPD_DEVICE_KEY_FLAGS] = FWUPD_RESULT_KEY_FLAGS,
+    [FWUPD_DEVICE_KEY_PROBLEMS] = FWUPD_RESULT_KEY_PROBLEMS,
+    [FWUPD_DEVICE_KEY_REQUEST_FLAGS] = FWUPD_RESULT_KEY_REQUEST_FLAGS,
+    [FWUPD_DEVICE_KEY_CREATED] = FWUPD_RESULT_KEY_CREATED,
+    [FWUPD_DEVICE_KEY_MODIFIED] = FWUPD_RESULT_KEY_MODIFIED,
+    [FWUPD_DEVICE_KEY_VERSION_BUILD_DATE] = FWUPD_RESULT_KEY_VERSION_BUILD_DATE,
+    [FWUPD_DEVICE_KEY_GUID] = FWUPD_RESULT_KEY_GUID,
+    [FWUPD_DEVICE_KEY_INSTANCE_IDS] = FWUPD_RESULT_KEY_INSTANCE_IDS,
+    [FWUPD_DEVICE_KEY_ICON] = FWUPD_RESULT_KEY_ICON,
+    [FWUPD_DEVICE_KEY_NAME] = FWUPD_RESULT_KEY_NAME,
+    [FWUPD_DEVICE_KEY_VENDOR] = FWUPD_RESULT_KEY_VENDOR,
+    [FWUPD_DEVICE_KEY_VENDOR_ID] = FWUPD_RESULT_KEY_VENDOR_ID,
+    [FWUPD_DEVICE_KEY_SERIAL] = FWUPD_RESULT_KEY_SERIAL,
+    [FWUPD_DEVICE_KEY_SUMMARY] = FWUPD_RESULT_KEY_SUMMARY,
+    [FWUPD_DEVICE_KEY_BRANCH] = FWUPD_RESULT_KEY_BRANCH,
+    [FWUPD_DEVICE_KEY_CHECKSUM] = FWUPD_RESULT_KEY_CHECKSUM,
+    [FWUPD_DEVICE_KEY_PLUGIN] = FWUPD_RESULT_KEY_PLUGIN,
+    [FWUPD_DEVICE_KEY_PROTOCOL] = FWUPD_RESULT_KEY_PROTOCOL,
+    [FWUPD_DEVICE_KEY_ISSUES] = FWUPD_RESULT_KEY_ISSUES,
+    [FWUPD_DEVICE_KEY_VERSION] = FWUPD_RESULT_KEY_VERSION,
+    [FWUPD_DEVICE_KEY_VERSION_LOWEST] = FWUPD_RESULT_KEY_VERSION_LOWEST,
+    [FWUPD_DEVICE_KEY_VERSION_BOOTLOADER] = FWUPD_RESULT_KEY_VERSION_BOOTLOADER,
+    [FWUPD_DEVICE_KEY_FLASHES_LEFT] = FWUPD_RESULT_KEY_FLASHES_LEFT,
+    [FWUPD_DEVICE_KEY_BATTERY_LEVEL] = FWUPD_RESULT_KEY_BATTERY_LEVEL,
+    [FWUPD_DEVICE_KEY_BATTERY_THRESHOLD] = FWUPD_RESULT_KEY_BATTERY_THRESHOLD,
+    [FWUPD_DEVICE_KEY_INSTALL_DURATION] = FWUPD_RESULT_KEY_INSTALL_DURATION,
+    [FWUPD_DEVICE_KEY_UPDATE_ERROR] = FWUPD_RESULT_KEY_UPDATE_ERROR,
+    [FWUPD_DEVICE_KEY_UPDATE_MESSAGE] = FWUPD_RESULT_KEY_UPDATE_MESSAGE,
+    [FWUPD_DEVICE_KEY_UPDATE_IMAGE] = FWUPD_RESULT_KEY_UPDATE_IMAGE,
+    [FWUPD_DEVICE_KEY_UPDATE_STATE] = FWUPD_RESULT_KEY_UPDATE_STATE,
+    [FWUPD_DEVICE_KEY_STATUS] = FWUPD_RESULT_KEY_STATUS,
+    [FWUPD_DEVICE_KEY_PERCENTAGE] = FWUPD_RESULT_KEY_PERCENTAGE,
+    [FWUPD_DEVICE_KEY_VERSION_FORMAT] = FWUPD_RESULT_KEY_VERSION_FORMAT,
+    [FWUPD_DEVICE_KEY_VERSION_RAW] = FWUPD_RESULT_KEY_VERSION_RAW,
+    [FWUPD_DEVICE_KEY_VERSION_LOWEST_RAW] = FWUPD_RESULT_KEY_VERSION_LOWEST_RAW,
+    [FWUPD_DEVICE_KEY_VERSION_BOOTLOADER_RAW] = FWUPD_RESULT_KEY_VERSION_BOOTLOADER_RAW,
+};
+
+static FwupdDeviceKey
+fwupd_device_key_from_string(const gchar *key)
+{
+	static GHashTable *keys = NULL;
+	return fwupd_codec_key_lookup(&keys,
+				      fwupd_device_keys,
+				      G_N_ELEMENTS(fwupd_device_keys),
+				      key);
+}
+
 static void
 fwupd_device_from_key_value(FwupdDevice *self, const gchar *key, GVariant *value)
 {
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_RELEASE) == 0) {
+	switch (fwupd_device_key_from_string(key)) {
+	case FWUPD_DEVICE_KEY_RELEASE: {
 		GVariantIter iter;
 		GVariant *child;
 		g_variant_iter_init(&iter, value);
@@ -2236,182 +2355,153 @@ fwupd_device_from_key_value(FwupdDevice *self, const gchar *key, GVariant *value
 				fwupd_device_add_release(self, release);
 			g_variant_unref(child);
 		}
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_DEVICE_ID) == 0) {
+	case FWUPD_DEVICE_KEY_DEVICE_ID:
 		fwupd_device_set_id(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_PARENT_DEVICE_ID) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_PARENT_DEVICE_ID:
 		fwupd_device_set_parent_id(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_COMPOSITE_ID) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_COMPOSITE_ID:
 		fwupd_device_set_composite_id(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_FLAGS) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_FLAGS:
 		fwupd_device_set_flags(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_PROBLEMS) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_PROBLEMS:
 		fwupd_device_set_problems(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_REQUEST_FLAGS) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_REQUEST_FLAGS:
 		fwupd_device_set_request_flags(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_CREATED) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_CREATED:
 		fwupd_device_set_created(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_MODIFIED) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_MODIFIED:
 		fwupd_device_set_modified(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_BUILD_DATE) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_VERSION_BUILD_DATE:
 		fwupd_device_set_version_build_date(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_GUID) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_GUID: {
 		g_autofree const gchar **guids = g_variant_get_strv(value, NULL);
 		for (guint i = 0; guids != NULL && guids[i] != NULL; i++)
 			fwupd_device_add_guid(self, guids[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_INSTANCE_IDS) == 0) {
+	case FWUPD_DEVICE_KEY_INSTANCE_IDS: {
 		g_autofree const gchar **instance_ids = g_variant_get_strv(value, NULL);
 		for (guint i = 0; instance_ids != NULL && instance_ids[i] != NULL; i++)
 			fwupd_device_add_instance_id(self, instance_ids[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_ICON) == 0) {
+	case FWUPD_DEVICE_KEY_ICON: {
 		g_autofree const gchar **icons = g_variant_get_strv(value, NULL);
 		for (guint i = 0; icons != NULL && icons[i] != NULL; i++)
 			fwupd_device_add_icon(self, icons[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_NAME) == 0) {
+	case FWUPD_DEVICE_KEY_NAME:
 		fwupd_device_set_name(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VENDOR) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_VENDOR:
 		fwupd_device_set_vendor(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VENDOR_ID) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_VENDOR_ID: {
 		g_auto(GStrv) vendor_ids = NULL;
 		vendor_ids = g_strsplit(g_variant_get_string(value, NULL), "|", -1);
 		for (guint i = 0; vendor_ids[i] != NULL; i++)
 			fwupd_device_add_vendor_id(self, vendor_ids[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_SERIAL) == 0) {
+	case FWUPD_DEVICE_KEY_SERIAL:
 		fwupd_device_set_serial(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_SUMMARY) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_SUMMARY:
 		fwupd_device_set_summary(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_BRANCH) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_BRANCH:
 		fwupd_device_set_branch(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_CHECKSUM) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_CHECKSUM: {
 		const gchar *checksums = g_variant_get_string(value, NULL);
 		if (checksums != NULL) {
 			g_auto(GStrv) split = g_strsplit(checksums, ",", -1);
 			for (guint i = 0; split[i] != NULL; i++)
 				fwupd_device_add_checksum(self, split[i]);
 		}
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_PLUGIN) == 0) {
+	case FWUPD_DEVICE_KEY_PLUGIN:
 		fwupd_device_set_plugin(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_PROTOCOL) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_PROTOCOL: {
 		g_auto(GStrv) protocols = NULL;
 		protocols = g_strsplit(g_variant_get_string(value, NULL), "|", -1);
 		for (guint i = 0; protocols[i] != NULL; i++)
 			fwupd_device_add_protocol(self, protocols[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_ISSUES) == 0) {
+	case FWUPD_DEVICE_KEY_ISSUES: {
 		g_autofree const gchar **strv = g_variant_get_strv(value, NULL);
 		for (guint i = 0; strv[i] != NULL; i++)
 			fwupd_device_add_issue(self, strv[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION) == 0) {
+	case FWUPD_DEVICE_KEY_VERSION:
 		fwupd_device_set_version(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_LOWEST) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_VERSION_LOWEST:
 		fwupd_device_set_version_lowest(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_BOOTLOADER) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_VERSION_BOOTLOADER:
 		fwupd_device_set_version_bootloader(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_FLASHES_LEFT) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_FLASHES_LEFT:
 		fwupd_device_set_flashes_left(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_BATTERY_LEVEL) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_BATTERY_LEVEL:
 		fwupd_device_set_battery_level(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_BATTERY_THRESHOLD) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_BATTERY_THRESHOLD:
 		fwupd_device_set_battery_threshold(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_INSTALL_DURATION) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_INSTALL_DURATION:
 		fwupd_device_set_install_duration(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_ERROR) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_UPDATE_ERROR:
 		fwupd_device_set_update_error(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_MESSAGE) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_UPDATE_MESSAGE:
 		fwupd_device_set_update_message(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_IMAGE) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_UPDATE_IMAGE:
 		fwupd_device_set_update_image(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_STATE) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_UPDATE_STATE:
 		fwupd_device_set_update_state(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_STATUS) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_STATUS:
 		fwupd_device_set_status(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_PERCENTAGE) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_PERCENTAGE:
 		fwupd_device_set_percentage(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_FORMAT) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_VERSION_FORMAT:
 		fwupd_device_set_version_format(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_RAW) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_VERSION_RAW:
 		fwupd_device_set_version_raw(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_LOWEST_RAW) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_VERSION_LOWEST_RAW:
 		fwupd_device_set_version_lowest_raw(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_BOOTLOADER_RAW) == 0) {
+		break;
+	case FWUPD_DEVICE_KEY_VERSION_BOOTLOADER_RAW:
 		fwupd_device_set_version_bootloader_raw(self, g_variant_get_uint64(value));
-		return;
+		break;
+	default:
+		break;
 	}
 }
 
@@ -3882,8 +3972,8 @@ static void
 fwupd_device_init(FwupdDevice *self)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
-	priv->guids = g_ptr_array_new_with_free_func(g_free);
-	priv->instance_ids = g_ptr_array_new_with_free_func(g_free);
+	priv->guids = g_ptr_array_new();
+	priv->instance_ids = g_ptr_array_new();
 	priv->icons = g_ptr_array_new_with_free_func(g_free);
 	priv->checksums = g_ptr_array_new_with_free_func(g_free);
 	priv->vendor_ids = g_ptr_array_new_with_free_func(g_free);
@@ -1760,151 +1760,209 @@ fwupd_release_to_variant(FwupdCodec *converter, FwupdCodecFlags flags)
 	return g_variant_new("a{sv}", &builder);
 }
 
+typedef enum {
+	FWUPD_RELEASE_KEY_UNKNOWN,
+	FWUPD_RELEASE_KEY_REMOTE_ID,
+	FWUPD_RELEASE_KEY_APPSTREAM_ID,
+	FWUPD_RELEASE_KEY_RELEASE_ID,
+	FWUPD_RELEASE_KEY_DETACH_CAPTION,
+	FWUPD_RELEASE_KEY_DETACH_IMAGE,
+	FWUPD_RELEASE_KEY_FILENAME,
+	FWUPD_RELEASE_KEY_PROTOCOL,
+	FWUPD_RELEASE_KEY_LICENSE,
+	FWUPD_RELEASE_KEY_NAME,
+	FWUPD_RELEASE_KEY_NAME_VARIANT_SUFFIX,
+	FWUPD_RELEASE_KEY_SIZE,
+	FWUPD_RELEASE_KEY_CREATED,
+	FWUPD_RELEASE_KEY_SUMMARY,
+	FWUPD_RELEASE_KEY_BRANCH,
+	FWUPD_RELEASE_KEY_DESCRIPTION,
+	FWUPD_RELEASE_KEY_CATEGORIES,
+	FWUPD_RELEASE_KEY_ISSUES,
+	FWUPD_RELEASE_KEY_CHECKSUM,
+	FWUPD_RELEASE_KEY_LOCATIONS,
+	FWUPD_RELEASE_KEY_TAGS,
+	FWUPD_RELEASE_KEY_URI,
+	FWUPD_RELEASE_KEY_HOMEPAGE,
+	FWUPD_RELEASE_KEY_DETAILS_URL,
+	FWUPD_RELEASE_KEY_SOURCE_URL,
+	FWUPD_RELEASE_KEY_VERSION,
+	FWUPD_RELEASE_KEY_VENDOR,
+	FWUPD_RELEASE_KEY_TRUST_FLAGS,
+	FWUPD_RELEASE_KEY_URGENCY,
+	FWUPD_RELEASE_KEY_INSTALL_DURATION,
+	FWUPD_RELEASE_KEY_UPDATE_MESSAGE,
+	FWUPD_RELEASE_KEY_UPDATE_IMAGE,
+	FWUPD_RELEASE_KEY_METADATA,
+	FWUPD_RELEASE_KEY_REPORTS,
+	FWUPD_RELEASE_KEY_LAST
+} FwupdReleaseKey;
+
+static const gchar *const fwupd_release_keys[] = {
+    [FWUPD_RELEASE_KEY_REMOTE_ID] = FWUPD_RESULT_KEY_REMOTE_ID,
+    [FWUPD_RELEASE_KEY_APPSTREAM_ID] = FWUPD_RESULT_KEY_APPSTREAM_ID,
+    [FWUPD_RELEASE_KEY_RELEASE_ID] = FWUPD_RESULT_KEY_RELEASE_ID,
+    [FWUPD_RELEASE_KEY_DETACH_CAPTION] = FWUPD_RESULT_KEY_DETACH_CAPTION,
+    [FWUPD_RELEASE_KEY_DETACH_IMAGE] = FWUPD_RESULT_KEY_DETACH_IMAGE,
+    [FWUPD_RELEASE_KEY_FILENAME] = FWUPD_RESULT_KEY_FILENAME,
+    [FWUPD_RELEASE_KEY_PROTOCOL] = FWUPD_RESULT_KEY_PROTOCOL,
+    [FWUPD_RELEASE_KEY_LICENSE] = FWUPD_RESULT_KEY_LICENSE,
+    [FWUPD_RELEASE_KEY_NAME] = FWUPD_RESULT_KEY_NAME,
+    [FWUPD_RELEASE_KEY_NAME_VARIANT_SUFFIX] = FWUPD_RESULT_KEY_NAME_VARIANT_SUFFIX,
+    [FWUPD_RELEASE_KEY_SIZE] = FWUPD_RESULT_KEY_SIZE,
+    [FWUPD_RELEASE_KEY_CREATED] = FWUPD_RESULT_KEY_CREATED,
+    [FWUPD_RELEASE_KEY_SUMMARY] = FWUPD_RESULT_KEY_SUMMARY,
+    [FWUPD_RELEASE_KEY_BRANCH] = FWUPD_RESULT_KEY_BRANCH,
+    [FWUPD_RELEASE_KEY_DESCRIPTION] = FWUPD_RESULT_KEY_DESCRIPTION,
+    [FWUPD_RELEASE_KEY_CATEGORIES] = FWUPD_RESULT_KEY_CATEGORIES,
+    [FWUPD_RELEASE_KEY_ISSUES] = FWUPD_RESULT_KEY_ISSUES,
+    [FWUPD_RELEASE_KEY_CHECKSUM] = FWUPD_RESULT_KEY_CHECKSUM,
+    [FWUPD_RELEASE_KEY_LOCATIONS] = FWUPD_RESULT_KEY_LOCATIONS,
+    [FWUPD_RELEASE_KEY_TAGS] = FWUPD_RESULT_KEY_TAGS,
+    [FWUPD_RELEASE_KEY_URI] = FWUPD_RESULT_KEY_URI,
+    [FWUPD_RELEASE_KEY_HOMEPAGE] = FWUPD_RESULT_KEY_HOMEPAGE,
+    [FWUPD_RELEASE_KEY_DETAILS_URL] = FWUPD_RESULT_KEY_DETAILS_URL,
+    [FWUPD_RELEASE_KEY_SOURCE_URL] = FWUPD_RESULT_KEY_SOURCE_URL,
+    [FWUPD_RELEASE_KEY_VERSION] = FWUPD_RESULT_KEY_VERSION,
+    [FWUPD_RELEASE_KEY_VENDOR] = FWUPD_RESULT_KEY_VENDOR,
+    [FWUPD_RELEASE_KEY_TRUST_FLAGS] = FWUPD_RESULT_KEY_TRUST_FLAGS,
+    [FWUPD_RELEASE_KEY_URGENCY] = FWUPD_RESULT_KEY_URGENCY,
+    [FWUPD_RELEASE_KEY_INSTALL_DURATION] = FWUPD_RESULT_KEY_INSTALL_DURATION,
+    [FWUPD_RELEASE_KEY_UPDATE_MESSAGE] = FWUPD_RESULT_KEY_UPDATE_MESSAGE,
+    [FWUPD_RELEASE_KEY_UPDATE_IMAGE] = FWUPD_RESULT_KEY_UPDATE_IMAGE,
+    [FWUPD_RELEASE_KEY_METADATA] = FWUPD_RESULT_KEY_METADATA,
+    [FWUPD_RELEASE_KEY_REPORTS] = FWUPD_RESULT_KEY_REPORTS,
+};
+
+static FwupdReleaseKey
+fwupd_release_key_from_string(const gchar *key)
+{
+	static GHashTable *keys = NULL;
+	return fwupd_codec_key_lookup(&keys,
+				      fwupd_release_keys,
+				      G_N_ELEMENTS(fwupd_release_keys),
+				      key);
+}
+
 static void
 fwupd_release_from_key_value(FwupdRelease *self, const gchar *key, GVariant *value)
 {
 	FwupdReleasePrivate *priv = GET_PRIVATE(self);
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_REMOTE_ID) == 0) {
+	switch (fwupd_release_key_from_string(key)) {
+	case FWUPD_RELEASE_KEY_REMOTE_ID:
 		fwupd_release_set_remote_id(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_APPSTREAM_ID) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_APPSTREAM_ID:
 		fwupd_release_set_appstream_id(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_RELEASE_ID) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_RELEASE_ID:
 		fwupd_release_set_id(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_DETACH_CAPTION) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_DETACH_CAPTION:
 		fwupd_release_set_detach_caption(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_DETACH_IMAGE) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_DETACH_IMAGE:
 		fwupd_release_set_detach_image(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_FILENAME) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_FILENAME:
 		fwupd_release_set_filename(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_PROTOCOL) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_PROTOCOL:
 		fwupd_release_set_protocol(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_LICENSE) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_LICENSE:
 		fwupd_release_set_license(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_NAME) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_NAME:
 		fwupd_release_set_name(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_NAME_VARIANT_SUFFIX) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_NAME_VARIANT_SUFFIX:
 		fwupd_release_set_name_variant_suffix(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_SIZE) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_SIZE:
 		fwupd_release_set_size(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_CREATED) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_CREATED:
 		fwupd_release_set_created(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_SUMMARY) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_SUMMARY:
 		fwupd_release_set_summary(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_BRANCH) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_BRANCH:
 		fwupd_release_set_branch(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_DESCRIPTION) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_DESCRIPTION:
 		fwupd_release_set_description(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_CATEGORIES) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_CATEGORIES: {
 		g_autofree const gchar **strv = g_variant_get_strv(value, NULL);
 		for (guint i = 0; strv[i] != NULL; i++)
 			fwupd_release_add_category(self, strv[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_ISSUES) == 0) {
+	case FWUPD_RELEASE_KEY_ISSUES: {
 		g_autofree const gchar **strv = g_variant_get_strv(value, NULL);
 		for (guint i = 0; strv[i] != NULL; i++)
 			fwupd_release_add_issue(self, strv[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_CHECKSUM) == 0) {
+	case FWUPD_RELEASE_KEY_CHECKSUM: {
 		const gchar *checksums = g_variant_get_string(value, NULL);
 		g_auto(GStrv) split = g_strsplit(checksums, ",", -1);
 		for (guint i = 0; split[i] != NULL; i++)
 			fwupd_release_add_checksum(self, split[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_LOCATIONS) == 0) {
+	case FWUPD_RELEASE_KEY_LOCATIONS: {
 		g_autofree const gchar **strv = g_variant_get_strv(value, NULL);
 		for (guint i = 0; strv[i] != NULL; i++)
 			fwupd_release_add_location(self, strv[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_TAGS) == 0) {
+	case FWUPD_RELEASE_KEY_TAGS: {
 		g_autofree const gchar **strv = g_variant_get_strv(value, NULL);
 		for (guint i = 0; strv[i] != NULL; i++)
 			fwupd_release_add_tag(self, strv[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_URI) == 0) {
+	case FWUPD_RELEASE_KEY_URI:
 		fwupd_release_add_location(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_HOMEPAGE) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_HOMEPAGE:
 		fwupd_release_set_homepage(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_DETAILS_URL) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_DETAILS_URL:
 		fwupd_release_set_details_url(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_SOURCE_URL) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_SOURCE_URL:
 		fwupd_release_set_source_url(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_VERSION:
 		fwupd_release_set_version(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_VENDOR) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_VENDOR:
 		fwupd_release_set_vendor(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_TRUST_FLAGS) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_TRUST_FLAGS:
 		fwupd_release_set_flags(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_URGENCY) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_URGENCY:
 		fwupd_release_set_urgency(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_INSTALL_DURATION) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_INSTALL_DURATION:
 		fwupd_release_set_install_duration(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_MESSAGE) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_UPDATE_MESSAGE:
 		fwupd_release_set_update_message(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_IMAGE) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_UPDATE_IMAGE:
 		fwupd_release_set_update_image(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_METADATA) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_METADATA:
 		g_hash_table_unref(priv->metadata);
 		priv->metadata = fwupd_variant_to_hash_kv(value);
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_REPORTS) == 0) {
+		break;
+	case FWUPD_RELEASE_KEY_REPORTS: {
 		GVariantIter iter;
 		GVariant *child;
 		g_variant_iter_init(&iter, value);
@@ -1914,7 +1972,10 @@ fwupd_release_from_key_value(FwupdRelease *self, const gchar *key, GVariant *val
 				fwupd_release_add_report(self, report);
 			g_variant_unref(child);
 		}
-		return;
+		break;
+	}
+	default:
+		break;
 	}
 }
 
@@ -1336,96 +1336,140 @@ fwupd_security_attr_add_metadata(FwupdSecurityAttr *self, const gchar *key, cons
 	g_hash_table_insert(priv->metadata, g_strdup(key), g_strdup(value));
 }
 
+typedef enum {
+	FWUPD_SECURITY_ATTR_KEY_UNKNOWN,
+	FWUPD_SECURITY_ATTR_KEY_APPSTREAM_ID,
+	FWUPD_SECURITY_ATTR_KEY_CREATED,
+	FWUPD_SECURITY_ATTR_KEY_NAME,
+	FWUPD_SECURITY_ATTR_KEY_SUMMARY,
+	FWUPD_SECURITY_ATTR_KEY_DESCRIPTION,
+	FWUPD_SECURITY_ATTR_KEY_PLUGIN,
+	FWUPD_SECURITY_ATTR_KEY_URI,
+	FWUPD_SECURITY_ATTR_KEY_FLAGS,
+	FWUPD_SECURITY_ATTR_KEY_HSI_LEVEL,
+	FWUPD_SECURITY_ATTR_KEY_HSI_RESULT,
+	FWUPD_SECURITY_ATTR_KEY_HSI_RESULT_FALLBACK,
+	FWUPD_SECURITY_ATTR_KEY_HSI_RESULT_SUCCESS,
+	FWUPD_SECURITY_ATTR_KEY_GUID,
+	FWUPD_SECURITY_ATTR_KEY_METADATA,
+	FWUPD_SECURITY_ATTR_KEY_BIOS_SETTING_ID,
+	FWUPD_SECURITY_ATTR_KEY_BIOS_SETTING_TARGET_VALUE,
+	FWUPD_SECURITY_ATTR_KEY_BIOS_SETTING_CURRENT_VALUE,
+	FWUPD_SECURITY_ATTR_KEY_KERNEL_CURRENT_VALUE,
+	FWUPD_SECURITY_ATTR_KEY_KERNEL_TARGET_VALUE,
+	FWUPD_SECURITY_ATTR_KEY_LAST
+} FwupdSecurityAttrKey;
+
+static const gchar *const fwupd_security_attr_keys[] = {
+    [FWUPD_SECURITY_ATTR_KEY_APPSTREAM_ID] = FWUPD_RESULT_KEY_APPSTREAM_ID,
+    [FWUPD_SECURITY_ATTR_KEY_CREATED] = FWUPD_RESULT_KEY_CREATED,
+    [FWUPD_SECURITY_ATTR_KEY_NAME] = FWUPD_RESULT_KEY_NAME,
+    [FWUPD_SECURITY_ATTR_KEY_SUMMARY] = FWUPD_RESULT_KEY_SUMMARY,
+    [FWUPD_SECURITY_ATTR_KEY_DESCRIPTION] = FWUPD_RESULT_KEY_DESCRIPTION,
+    [FWUPD_SECURITY_ATTR_KEY_PLUGIN] = FWUPD_RESULT_KEY_PLUGIN,
+    [FWUPD_SECURITY_ATTR_KEY_URI] = FWUPD_RESULT_KEY_URI,
+    [FWUPD_SECURITY_ATTR_KEY_FLAGS] = FWUPD_RESULT_KEY_FLAGS,
+    [FWUPD_SECURITY_ATTR_KEY_HSI_LEVEL] = FWUPD_RESULT_KEY_HSI_LEVEL,
+    [FWUPD_SECURITY_ATTR_KEY_HSI_RESULT] = FWUPD_RESULT_KEY_HSI_RESULT,
+    [FWUPD_SECURITY_ATTR_KEY_HSI_RESULT_FALLBACK] = FWUPD_RESULT_KEY_HSI_RESULT_FALLBACK,
+    [FWUPD_SECURITY_ATTR_KEY_HSI_RESULT_SUCCESS] = FWUPD_RESULT_KEY_HSI_RESULT_SUCCESS,
+    [FWUPD_SECURITY_ATTR_KEY_GUID] = FWUPD_RESULT_KEY_GUID,
+    [FWUPD_SECURITY_ATTR_KEY_METADATA] = FWUPD_RESULT_KEY_METADATA,
+    [FWUPD_SECURITY_ATTR_KEY_BIOS_SETTING_ID] = FWUPD_RESULT_KEY_BIOS_SETTING_ID,
+    [FWUPD_SECURITY_ATTR_KEY_BIOS_SETTING_TARGET_VALUE] =
+	FWUPD_RESULT_KEY_BIOS_SETTING_TARGET_VALUE,
+    [FWUPD_SECURITY_ATTR_KEY_BIOS_SETTING_CURRENT_VALUE] =
+	FWUPD_RESULT_KEY_BIOS_SETTING_CURRENT_VALUE,
+    [FWUPD_SECURITY_ATTR_KEY_KERNEL_CURRENT_VALUE] = FWUPD_RESULT_KEY_KERNEL_CURRENT_VALUE,
+    [FWUPD_SECURITY_ATTR_KEY_KERNEL_TARGET_VALUE] = FWUPD_RESULT_KEY_KERNEL_TARGET_VALUE,
+};
+
+static FwupdSecurityAttrKey
+fwupd_security_attr_key_from_string(const gchar *key)
+{
+	static GHashTable *keys = NULL;
+	return fwupd_codec_key_lookup(&keys,
+				      fwupd_security_attr_keys,
+				      G_N_ELEMENTS(fwupd_security_attr_keys),
+				      key);
+}
+
 static void
 fwupd_security_attr_from_key_value(FwupdSecurityAttr *self, const gchar *key, GVariant *value)
 {
 	FwupdSecurityAttrPrivate *priv = GET_PRIVATE(self);
 
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_APPSTREAM_ID) == 0) {
+	switch (fwupd_security_attr_key_from_string(key)) {
+	case FWUPD_SECURITY_ATTR_KEY_APPSTREAM_ID:
 		fwupd_security_attr_set_appstream_id(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_CREATED) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_CREATED:
 		fwupd_security_attr_set_created(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_NAME) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_NAME:
 		fwupd_security_attr_set_name(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_SUMMARY) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_SUMMARY:
 		fwupd_security_attr_set_title(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_DESCRIPTION) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_DESCRIPTION:
 		fwupd_security_attr_set_description(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_PLUGIN) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_PLUGIN:
 		fwupd_security_attr_set_plugin(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_URI) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_URI:
 		fwupd_security_attr_set_url(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_FLAGS) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_FLAGS:
 		fwupd_security_attr_set_flags(self, g_variant_get_uint64(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_HSI_LEVEL) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_HSI_LEVEL:
 		fwupd_security_attr_set_level(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_HSI_RESULT) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_HSI_RESULT:
 		fwupd_security_attr_set_result(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_HSI_RESULT_FALLBACK) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_HSI_RESULT_FALLBACK:
 		fwupd_security_attr_set_result_fallback(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_HSI_RESULT_SUCCESS) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_HSI_RESULT_SUCCESS:
 		fwupd_security_attr_set_result_success(self, g_variant_get_uint32(value));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_GUID) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_GUID: {
 		g_autofree const gchar **strv = g_variant_get_strv(value, NULL);
 		for (guint i = 0; strv[i] != NULL; i++)
 			fwupd_security_attr_add_guid(self, strv[i]);
-		return;
+		break;
 	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_METADATA) == 0) {
+	case FWUPD_SECURITY_ATTR_KEY_METADATA:
 		if (priv->metadata != NULL)
 			g_hash_table_unref(priv->metadata);
 		priv->metadata = fwupd_variant_to_hash_kv(value);
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_BIOS_SETTING_ID) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_BIOS_SETTING_ID:
 		fwupd_security_attr_set_bios_setting_id(self, g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_BIOS_SETTING_TARGET_VALUE) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_BIOS_SETTING_TARGET_VALUE:
 		fwupd_security_attr_set_bios_setting_target_value(
 		    self,
 		    g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_BIOS_SETTING_CURRENT_VALUE) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_BIOS_SETTING_CURRENT_VALUE:
 		fwupd_security_attr_set_bios_setting_current_value(
 		    self,
 		    g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_KERNEL_CURRENT_VALUE) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_KERNEL_CURRENT_VALUE:
 		fwupd_security_attr_set_kernel_current_value(self,
 							     g_variant_get_string(value, NULL));
-		return;
-	}
-	if (g_strcmp0(key, FWUPD_RESULT_KEY_KERNEL_TARGET_VALUE) == 0) {
+		break;
+	case FWUPD_SECURITY_ATTR_KEY_KERNEL_TARGET_VALUE:
 		fwupd_security_attr_set_kernel_target_value(self,
 							    g_variant_get_string(value, NULL));
-		return;
+		break;
+	default:
+		break;
 	}
 }
 
@@ -563,6 +563,7 @@ fwupd_device_func(void)
 {
 	gboolean ret;
 	g_autofree gchar *data = NULL;
+	g_autofree gchar *guid_copy = NULL;
 	g_autofree gchar *str = NULL;
 	g_autoptr(FwupdDevice) dev = NULL;
 	g_autoptr(FwupdDevice) dev2 = fwupd_device_new();
@@ -612,6 +613,12 @@ fwupd_device_func(void)
 	g_assert_true(fwupd_device_has_guid(dev, "00000000-0000-0000-0000-000000000000"));
 	g_assert_false(fwupd_device_has_guid(dev, "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"));
 
+	/* GUIDs are shared between devices, and match from any copy of the string */
+	guid_copy = g_strdup("2082b5e0-7a64-478a-b1b2-e3404fab6dad");
+	g_assert_true(fwupd_device_has_guid(dev, guid_copy));
+	g_assert_true(g_ptr_array_index(fwupd_device_get_guids(dev), 0) ==
+		      g_intern_string(guid_copy));
+
 	/* convert the new non-breaking space back into a normal space:
 	 * https://gitlab.gnome.org/GNOME/glib/commit/76af5dabb4a25956a6c41a75c0c7feeee74496da */
 	str_ascii = g_string_new(str);
@@ -31,6 +31,8 @@
 struct _FuArchive {
 	GObject parent_instance;
 	GHashTable *entries; /* str:GBytes */
+	GHashTable *index;   /* str:guint of entry number + 1, only for lazy archives */
+	GBytes *blob;	     /* nullable, only for lazy archives */
 };
 
 G_DEFINE_TYPE(FuArchive, fu_archive, G_TYPE_OBJECT)
@@ -41,6 +43,9 @@ fu_archive_finalize(GObject *obj)
 	FuArchive *self = FU_ARCHIVE(obj);
 
 	g_hash_table_unref(self->entries);
+	g_hash_table_unref(self->index);
+	if (self->blob != NULL)
+		g_bytes_unref(self->blob);
 	G_OBJECT_CLASS(fu_archive_parent_class)->finalize(obj);
 }
 
@@ -56,6 +61,7 @@ fu_archive_init(FuArchive *self)
 {
 	self->entries =
 	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_bytes_unref);
+	self->index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 }
 
 /**
@@ -77,70 +83,6 @@ fu_archive_add_entry(FuArchive *self, const gchar *fn, GBytes *blob)
 	g_hash_table_insert(self->entries, g_strdup(fn), g_bytes_ref(blob));
 }
 
-/**
- * fu_archive_lookup_by_fn:
- * @self: a #FuArchive
- * @fn: a filename
- * @error: (nullable): optional return location for an error
- *
- * Finds the blob referenced by filename
- *
- * Returns: (transfer full): a #GBytes, or %NULL if the filename was not found
- *
- * Since: 1.2.2
- **/
-GBytes *
-fu_archive_lookup_by_fn(FuArchive *self, const gchar *fn, GError **error)
-{
-	GBytes *bytes;
-
-	g_return_val_if_fail(FU_IS_ARCHIVE(self), NULL);
-	g_return_val_if_fail(fn != NULL, NULL);
-	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
-
-	bytes = g_hash_table_lookup(self->entries, fn);
-	if (bytes == NULL) {
-		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND, "no blob for %s", fn);
-		return NULL;
-	}
-	return g_bytes_ref(bytes);
-}
-
-/**
- * fu_archive_iterate:
- * @self: a #FuArchive
- * @callback: (scope call) (closure user_data): a #FuArchiveIterateFunc.
- * @user_data: user data
- * @error: (nullable): optional return location for an error
- *
- * Iterates over the archive contents, calling the given function for each
- * of the files found. If any @callback returns %FALSE scanning is aborted.
- *
- * Returns: True if no @callback returned FALSE
- *
- * Since: 1.3.4
- */
-gboolean
-fu_archive_iterate(FuArchive *self,
-		   FuArchiveIterateFunc callback,
-		   gpointer user_data,
-		   GError **error)
-{
-	GHashTableIter iter;
-	gpointer key, value;
-
-	g_return_val_if_fail(FU_IS_ARCHIVE(self), FALSE);
-	g_return_val_if_fail(callback != NULL, FALSE);
-	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
-
-	g_hash_table_iter_init(&iter, self->entries);
-	while (g_hash_table_iter_next(&iter, &key, &value)) {
-		if (!callback(self, (const gchar *)key, (GBytes *)value, user_data, error))
-			return FALSE;
-	}
-	return TRUE;
-}
-
 #ifdef HAVE_LIBARCHIVE
 /* workaround the struct types of libarchive */
 typedef struct archive _archive_read_ctx;
@@ -242,21 +184,20 @@ fu_archive_set_compression(_archive_write_ctx *arch, FuArchiveCompression compre
 }
 #endif
 
-static gboolean
-fu_archive_load(FuArchive *self, GBytes *blob, FuArchiveFlags flags, GError **error)
-{
 #ifdef HAVE_LIBARCHIVE
+static _archive_read_ctx *
+fu_archive_read_new(GBytes *blob, GError **error)
+{
 	int r;
 	g_autoptr(_archive_read_ctx) arch = NULL;
 
-	/* decompress anything matching either glob */
 	arch = archive_read_new();
 	if (arch == NULL) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
 				    "libarchive startup failed");
-		return FALSE;
+		return NULL;
 	}
 	archive_read_support_format_all(arch);
 	archive_read_support_filter_all(arch);
@@ -269,69 +210,220 @@ fu_archive_load(FuArchive *self, GBytes *blob, FuArchiveFlags flags, GError **er
 			    FWUPD_ERROR_NOT_SUPPORTED,
 			    "cannot open: %s",
 			    archive_error_string(arch));
+		return NULL;
+	}
+	return g_steal_pointer(&arch);
+}
+
+static gboolean
+fu_archive_read_next_header(_archive_read_ctx *arch,
+			    struct archive_entry **entry,
+			    gboolean *eof,
+			    GError **error)
+{
+	int r = archive_read_next_header(arch, entry);
+	if (r == ARCHIVE_EOF) {
+		*eof = TRUE;
+		return TRUE;
+	}
+	if (r != ARCHIVE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "cannot read header: %s",
+			    archive_error_string(arch));
 		return FALSE;
 	}
-	while (TRUE) {
-		const gchar *fn;
-		gint64 bufsz;
-		gssize rc;
-		struct archive_entry *entry;
-		g_autofree gchar *fn_key = NULL;
-		g_autofree guint8 *buf = NULL;
+	if (archive_entry_size(*entry) > 1024 * 1024 * 1024) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "cannot read huge files");
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static GBytes *
+fu_archive_read_data(_archive_read_ctx *arch, struct archive_entry *entry, GError **error)
+{
+	gint64 bufsz = archive_entry_size(entry);
+	gssize rc;
+	g_autofree guint8 *buf = g_malloc(bufsz);
+
+	rc = archive_read_data(arch, buf, (gsize)bufsz);
+	if (rc < 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "cannot read data: %s",
+			    archive_error_string(arch));
+		return NULL;
+	}
+	if (rc != bufsz) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "read %" G_GSSIZE_FORMAT " of %" G_GINT64_FORMAT,
+			    rc,
+			    bufsz);
+		return NULL;
+	}
+	return g_bytes_new_take(g_steal_pointer(&buf), bufsz);
+}
+
+static gchar *
+fu_archive_entry_get_key(struct archive_entry *entry, FuArchiveFlags flags)
+{
+	const gchar *fn = archive_entry_pathname(entry);
+	if (fn == NULL)
+		return NULL;
+	if (flags & FU_ARCHIVE_FLAG_IGNORE_PATH)
+		return g_path_get_basename(fn);
+	return g_strdup(fn);
+}
+#endif
+
+/* decompress a single entry of a lazy archive, skipping over all the others */
+static GBytes *
+fu_archive_extract(FuArchive *self, const gchar *fn, GError **error)
+{
+#ifdef HAVE_LIBARCHIVE
+	guint idx = GPOINTER_TO_UINT(g_hash_table_lookup(self->index, fn));
+	g_autoptr(_archive_read_ctx) arch = NULL;
+
+	arch = fu_archive_read_new(self->blob, error);
+	if (arch == NULL)
+		return NULL;
+	for (guint i = 1;; i++) {
+		gboolean eof = FALSE;
+		struct archive_entry *entry = NULL;
 		g_autoptr(GBytes) bytes = NULL;
 
-		r = archive_read_next_header(arch, &entry);
-		if (r == ARCHIVE_EOF)
+		if (!fu_archive_read_next_header(arch, &entry, &eof, error))
+			return NULL;
+		if (eof)
 			break;
-		if (r != ARCHIVE_OK) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_DATA,
-				    "cannot read header: %s",
-				    archive_error_string(arch));
-			return FALSE;
-		}
+		if (i != idx)
+			continue;
+		bytes = fu_archive_read_data(arch, entry, error);
+		if (bytes == NULL)
+			return NULL;
+		g_debug("extracted %s [%" G_GSIZE_FORMAT "]", fn, g_bytes_get_size(bytes));
+		fu_archive_add_entry(self, fn, bytes);
+		return g_steal_pointer(&bytes);
+	}
+	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND, "no blob for %s", fn);
+	return NULL;
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "missing libarchive support");
+	return NULL;
+#endif
+}
 
-		/* only extract if valid */
-		fn = archive_entry_pathname(entry);
+/* decompress everything in a lazy archive that has not already been looked up */
+static gboolean
+fu_archive_ensure_entries(FuArchive *self, GError **error)
+{
+#ifdef HAVE_LIBARCHIVE
+	GHashTableIter iter;
+	gpointer key, value;
+	g_autoptr(GHashTable) fns = NULL;
+	g_autoptr(_archive_read_ctx) arch = NULL;
+#endif
+
+	/* not lazy, or already done */
+	if (self->blob == NULL)
+		return TRUE;
+
+#ifdef HAVE_LIBARCHIVE
+	fns = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	/* the last entry with a duplicate name wins, like in fu_archive_load() */
+	g_hash_table_iter_init(&iter, self->index);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		if (!g_hash_table_contains(self->entries, key))
+			g_hash_table_insert(fns, value, key);
+	}
+	arch = fu_archive_read_new(self->blob, error);
+	if (arch == NULL)
+		return FALSE;
+	for (guint i = 1; g_hash_table_size(fns) > 0; i++) {
+		const gchar *fn;
+		gboolean eof = FALSE;
+		struct archive_entry *entry = NULL;
+		g_autoptr(GBytes) bytes = NULL;
+
+		if (!fu_archive_read_next_header(arch, &entry, &eof, error))
+			return FALSE;
+		if (eof)
+			break;
+		fn = g_hash_table_lookup(fns, GUINT_TO_POINTER(i));
 		if (fn == NULL)
 			continue;
-		bufsz = archive_entry_size(entry);
-		if (bufsz > 1024 * 1024 * 1024) {
-			g_set_error_literal(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_NOT_SUPPORTED,
-					    "cannot read huge files");
+		bytes = fu_archive_read_data(arch, entry, error);
+		if (bytes == NULL)
 			return FALSE;
-		}
-		buf = g_malloc(bufsz);
-		rc = archive_read_data(arch, buf, (gsize)bufsz);
-		if (rc < 0) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_READ,
-				    "cannot read data: %s",
-				    archive_error_string(arch));
+		fu_archive_add_entry(self, fn, bytes);
+		g_hash_table_remove(fns, GUINT_TO_POINTER(i));
+	}
+
+	/* everything is now in memory */
+	g_hash_table_remove_all(self->index);
+	g_clear_pointer(&self->blob, g_bytes_unref);
+	return TRUE;
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "missing libarchive support");
+	return FALSE;
+#endif
+}
+
+static gboolean
+fu_archive_load(FuArchive *self, GBytes *blob, FuArchiveFlags flags, GError **error)
+{
+#ifdef HAVE_LIBARCHIVE
+	g_autoptr(_archive_read_ctx) arch = NULL;
+
+	arch = fu_archive_read_new(blob, error);
+	if (arch == NULL)
+		return FALSE;
+	for (guint i = 1;; i++) {
+		gboolean eof = FALSE;
+		struct archive_entry *entry = NULL;
+		g_autofree gchar *fn_key = NULL;
+		g_autoptr(GBytes) bytes = NULL;
+
+		if (!fu_archive_read_next_header(arch, &entry, &eof, error))
 			return FALSE;
+		if (eof)
+			break;
+
+		/* only extract if valid */
+		fn_key = fu_archive_entry_get_key(entry, flags);
+		if (fn_key == NULL)
+			continue;
+
+		/* just remember where it is, the data is skipped by the next header read */
+		if (flags & FU_ARCHIVE_FLAG_LAZY) {
+			g_hash_table_insert(self->index,
+					    g_steal_pointer(&fn_key),
+					    GUINT_TO_POINTER(i));
+			continue;
 		}
-		if (rc != bufsz) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_READ,
-				    "read %" G_GSSIZE_FORMAT " of %" G_GINT64_FORMAT,
-				    rc,
-				    bufsz);
+		bytes = fu_archive_read_data(arch, entry, error);
+		if (bytes == NULL)
 			return FALSE;
-		}
-		if (flags & FU_ARCHIVE_FLAG_IGNORE_PATH) {
-			fn_key = g_path_get_basename(fn);
-		} else {
-			fn_key = g_strdup(fn);
-		}
-		g_debug("adding %s [%" G_GINT64_FORMAT "]", fn_key, bufsz);
-		bytes = g_bytes_new_take(g_steal_pointer(&buf), bufsz);
+		g_debug("adding %s [%" G_GSIZE_FORMAT "]", fn_key, g_bytes_get_size(bytes));
 		fu_archive_add_entry(self, fn_key, bytes);
 	}
+	if (flags & FU_ARCHIVE_FLAG_LAZY)
+		self->blob = g_bytes_ref(blob);
 
 	/* success */
 	return TRUE;
@@ -344,6 +436,74 @@ fu_archive_load(FuArchive *self, GBytes *blob, FuArchiveFlags flags, GError **er
 #endif
 }
 
+/**
+ * fu_archive_lookup_by_fn:
+ * @self: a #FuArchive
+ * @fn: a filename
+ * @error: (nullable): optional return location for an error
+ *
+ * Finds the blob referenced by filename
+ *
+ * Returns: (transfer full): a #GBytes, or %NULL if the filename was not found
+ *
+ * Since: 1.2.2
+ **/
+GBytes *
+fu_archive_lookup_by_fn(FuArchive *self, const gchar *fn, GError **error)
+{
+	GBytes *bytes;
+
+	g_return_val_if_fail(FU_IS_ARCHIVE(self), NULL);
+	g_return_val_if_fail(fn != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	bytes = g_hash_table_lookup(self->entries, fn);
+	if (bytes == NULL) {
+		if (g_hash_table_contains(self->index, fn))
+			return fu_archive_extract(self, fn, error);
+		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND, "no blob for %s", fn);
+		return NULL;
+	}
+	return g_bytes_ref(bytes);
+}
+
+/**
+ * fu_archive_iterate:
+ * @self: a #FuArchive
+ * @callback: (scope call) (closure user_data): a #FuArchiveIterateFunc.
+ * @user_data: user data
+ * @error: (nullable): optional return location for an error
+ *
+ * Iterates over the archive contents, calling the given function for each
+ * of the files found. If any @callback returns %FALSE scanning is aborted.
+ *
+ * Returns: True if no @callback returned FALSE
+ *
+ * Since: 1.3.4
+ */
+gboolean
+fu_archive_iterate(FuArchive *self,
+		   FuArchiveIterateFunc callback,
+		   gpointer user_data,
+		   GError **error)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+
+	g_return_val_if_fail(FU_IS_ARCHIVE(self), FALSE);
+	g_return_val_if_fail(callback != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (!fu_archive_ensure_entries(self, error))
+		return FALSE;
+	g_hash_table_iter_init(&iter, self->entries);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		if (!callback(self, (const gchar *)key, (GBytes *)value, user_data, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
 /**
  * fu_archive_new:
  * @data: (nullable): archive contents
@@ -352,6 +512,9 @@ fu_archive_load(FuArchive *self, GBytes *blob, FuArchiveFlags flags, GError **er
  *
  * Parses @data as an archive and decompresses all files to memory blobs.
  *
+ * If @flags includes %FU_ARCHIVE_FLAG_LAZY then only the list of filenames is read, and each
+ * file is decompressed when it is first looked up.
+ *
  * If @data is unspecified then a new empty archive is created.
  *
  * Returns: a #FuArchive, or %NULL if the archive was invalid in any way.
@@ -445,6 +608,10 @@ fu_archive_write(FuArchive *self,
 	}
 #endif
 
+	/* get anything not already decompressed */
+	if (!fu_archive_ensure_entries(self, error))
+		return NULL;
+
 	/* compress anything matching either glob */
 	arch = archive_write_new();
 	if (arch == NULL) {
@@ -20,3 +20,5 @@ fu_backend_save(FuBackend *self,
 		const gchar *tag,
 		FuBackendSaveFlags flags,
 		GError **error) G_GNUC_NON_NULL(1, 2);
+void
+fu_backend_add_runner_stats(FuBackend *self, GVariantBuilder *builder) G_GNUC_NON_NULL(1, 2);
@@ -9,6 +9,7 @@
 #include "config.h"
 
 #include "fu-backend-private.h"
+#include "fu-runner-stats-private.h"
 #include "fu-string.h"
 
 /**
@@ -27,6 +28,7 @@ typedef struct {
 	gboolean can_invalidate;
 	GHashTable *devices; /* device_id : * FuDevice */
 	GThread *thread_init;
+	FuRunnerStats *runner_stats;
 } FuBackendPrivate;
 
 enum { SIGNAL_ADDED, SIGNAL_REMOVED, SIGNAL_CHANGED, SIGNAL_LAST };
@@ -51,6 +53,7 @@ void
 fu_backend_device_added(FuBackend *self, FuDevice *device)
 {
 	FuBackendPrivate *priv = GET_PRIVATE(self);
+	gint64 begin_us;
 	g_return_if_fail(FU_IS_BACKEND(self));
 	g_return_if_fail(FU_IS_DEVICE(device));
 	g_return_if_fail(priv->thread_init == g_thread_self());
@@ -73,7 +76,9 @@ fu_backend_device_added(FuBackend *self, FuDevice *device)
 	g_hash_table_insert(priv->devices,
 			    g_strdup(fu_device_get_backend_id(device)),
 			    g_object_ref(device));
+	begin_us = g_get_monotonic_time();
 	g_signal_emit(self, signals[SIGNAL_ADDED], 0, device);
+	fu_runner_stats_add(priv->runner_stats, "device_added", begin_us, FALSE, TRUE);
 }
 
 /**
@@ -89,10 +94,13 @@ void
 fu_backend_device_removed(FuBackend *self, FuDevice *device)
 {
 	FuBackendPrivate *priv = GET_PRIVATE(self);
+	gint64 begin_us;
 	g_return_if_fail(FU_IS_BACKEND(self));
 	g_return_if_fail(FU_IS_DEVICE(device));
 	g_return_if_fail(priv->thread_init == g_thread_self());
+	begin_us = g_get_monotonic_time();
 	g_signal_emit(self, signals[SIGNAL_REMOVED], 0, device);
+	fu_runner_stats_add(priv->runner_stats, "device_removed", begin_us, FALSE, TRUE);
 	g_hash_table_remove(priv->devices, fu_device_get_backend_id(device));
 }
 
@@ -109,10 +117,13 @@ void
 fu_backend_device_changed(FuBackend *self, FuDevice *device)
 {
 	FuBackendPrivate *priv = GET_PRIVATE(self);
+	gint64 begin_us;
 	g_return_if_fail(FU_IS_BACKEND(self));
 	g_return_if_fail(FU_IS_DEVICE(device));
 	g_return_if_fail(priv->thread_init == g_thread_self());
+	begin_us = g_get_monotonic_time();
 	g_signal_emit(self, signals[SIGNAL_CHANGED], 0, device);
+	fu_runner_stats_add(priv->runner_stats, "device_changed", begin_us, FALSE, TRUE);
 }
 
 /**
@@ -220,7 +231,10 @@ fu_backend_setup(FuBackend *self, FuProgress *progress, GError **error)
 	if (priv->done_setup)
 		return TRUE;
 	if (klass->setup != NULL) {
-		if (!klass->setup(self, progress, error)) {
+		gint64 begin_us = g_get_monotonic_time();
+		gboolean ret = klass->setup(self, progress, error);
+		fu_runner_stats_add(priv->runner_stats, "setup", begin_us, FALSE, ret);
+		if (!ret) {
 			priv->enabled = FALSE;
 			return FALSE;
 		}
@@ -314,13 +328,38 @@ gboolean
 fu_backend_coldplug(FuBackend *self, FuProgress *progress, GError **error)
 {
 	FuBackendClass *klass = FU_BACKEND_GET_CLASS(self);
+	FuBackendPrivate *priv = GET_PRIVATE(self);
+	gboolean ret;
+	gint64 begin_us;
 	g_return_val_if_fail(FU_IS_BACKEND(self), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 	if (!fu_backend_setup(self, progress, error))
 		return FALSE;
 	if (klass->coldplug == NULL)
 		return TRUE;
-	return klass->coldplug(self, progress, error);
+	begin_us = g_get_monotonic_time();
+	ret = klass->coldplug(self, progress, error);
+	fu_runner_stats_add(priv->runner_stats, "coldplug", begin_us, FALSE, ret);
+	return ret;
+}
+
+/**
+ * fu_backend_add_runner_stats:
+ * @self: a #FuBackend
+ * @builder: a #GVariantBuilder of type `aa{sv}`
+ *
+ * Adds the call count and latency of the backend vfuncs, and of the signal handlers run for
+ * each hotplug event.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_backend_add_runner_stats(FuBackend *self, GVariantBuilder *builder)
+{
+	FuBackendPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_BACKEND(self));
+	g_return_if_fail(builder != NULL);
+	fu_runner_stats_add_variant(priv->runner_stats, "Backend", priv->name, builder);
 }
 
 /**
@@ -496,6 +535,7 @@ fu_backend_init(FuBackend *self)
 	FuBackendPrivate *priv = GET_PRIVATE(self);
 	priv->enabled = TRUE;
 	priv->thread_init = g_thread_self();
+	priv->runner_stats = fu_runner_stats_new();
 	priv->devices =
 	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_object_unref);
 }
@@ -518,6 +558,7 @@ fu_backend_finalize(GObject *object)
 		g_object_unref(priv->ctx);
 	g_free(priv->name);
 	g_hash_table_unref(priv->devices);
+	fu_runner_stats_free(priv->runner_stats);
 	G_OBJECT_CLASS(fu_backend_parent_class)->finalize(object);
 }
 
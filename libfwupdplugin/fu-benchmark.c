@@ -0,0 +1,317 @@
+/*
+ * Copyright 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "config.h"
+
+#define G_LOG_DOMAIN "FuBenchmark"
+
+#include <fwupdplugin.h>
+
+#include <json-glib/json-glib.h>
+#include <locale.h>
+#ifdef HAVE_MALLOC_H
+#include <malloc.h>
+#endif
+
+#include "fu-coswid-firmware.h"
+
+#define FU_BENCHMARK_DURATION_MIN 200000 /* us */
+
+typedef struct {
+	GType gtype;
+	const gchar *xml_fn;
+} FuBenchmarkItem;
+
+typedef struct {
+	guint iterations;
+	gint64 elapsed;	   /* us */
+	gint64 heap_bytes; /* retained by the parsed firmware */
+} FuBenchmarkResult;
+
+static gint64
+fu_benchmark_get_heap_used(void)
+{
+#ifdef HAVE_MALLINFO2
+	struct mallinfo2 info = mallinfo2();
+	return (gint64)info.uordblks;
+#else
+	return 0;
+#endif
+}
+
+/* make every image larger by repeating the payload, so the parsers have more work to do */
+static void
+fu_benchmark_scale_firmware(FuFirmware *firmware, guint scale)
+{
+	g_autoptr(GBytes) blob = fu_firmware_get_bytes(firmware, NULL);
+	g_autoptr(GPtrArray) imgs = fu_firmware_get_images(firmware);
+
+	if (blob != NULL && g_bytes_get_size(blob) > 0) {
+		g_autoptr(GByteArray) buf = g_byte_array_new();
+		g_autoptr(GBytes) blob_scaled = NULL;
+		for (guint i = 0; i < scale; i++)
+			fu_byte_array_append_bytes(buf, blob);
+		blob_scaled = g_bytes_new(buf->data, buf->len);
+		fu_firmware_set_bytes(firmware, blob_scaled);
+	}
+	for (guint i = 0; i < imgs->len; i++) {
+		FuFirmware *img = g_ptr_array_index(imgs, i);
+		fu_benchmark_scale_firmware(img, scale);
+	}
+}
+
+static gboolean
+fu_benchmark_parse(GType gtype,
+		   GBytes *blob,
+		   guint iterations,
+		   FuBenchmarkResult *result,
+		   GError **error)
+{
+	gint64 start = g_get_monotonic_time();
+
+	for (guint i = 0; iterations == 0 || i < iterations; i++) {
+		gint64 heap_used = fu_benchmark_get_heap_used();
+		g_autoptr(FuFirmware) firmware = g_object_new(gtype, NULL);
+		g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_bytes(blob);
+
+		if (!fu_firmware_parse_stream(firmware, stream, 0x0, FWUPD_INSTALL_FLAG_NONE, error))
+			return FALSE;
+		result->heap_bytes = MAX(result->heap_bytes, fu_benchmark_get_heap_used() - heap_used);
+		result->iterations++;
+		result->elapsed = g_get_monotonic_time() - start;
+		if (iterations == 0 && result->elapsed > FU_BENCHMARK_DURATION_MIN)
+			break;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_write(FuFirmware *firmware,
+		   guint iterations,
+		   FuBenchmarkResult *result,
+		   GError **error)
+{
+	gint64 start = g_get_monotonic_time();
+
+	for (guint i = 0; iterations == 0 || i < iterations; i++) {
+		g_autoptr(GBytes) blob = fu_firmware_write(firmware, error);
+		if (blob == NULL)
+			return FALSE;
+		result->iterations++;
+		result->elapsed = g_get_monotonic_time() - start;
+		if (iterations == 0 && result->elapsed > FU_BENCHMARK_DURATION_MIN)
+			break;
+	}
+	return TRUE;
+}
+
+static gdouble
+fu_benchmark_result_get_throughput(FuBenchmarkResult *result, gsize bufsz)
+{
+	if (result->elapsed == 0)
+		return 0;
+	return ((gdouble)bufsz * result->iterations) / result->elapsed; /* bytes per us == MB/s */
+}
+
+static gboolean
+fu_benchmark_run_item(FuBenchmarkItem *item,
+		      const gchar *testdatadir,
+		      guint scale,
+		      guint iterations,
+		      JsonBuilder *builder,
+		      GError **error)
+{
+	FuBenchmarkResult result_parse = {0};
+	FuBenchmarkResult result_write = {0};
+	g_autofree gchar *filename = g_build_filename(testdatadir, item->xml_fn, NULL);
+	g_autoptr(FuFirmware) firmware = g_object_new(item->gtype, NULL);
+	g_autoptr(GBytes) blob = NULL;
+
+	/* build the firmware, and make it bigger */
+	if (!fu_firmware_build_from_filename(firmware, filename, error))
+		return FALSE;
+	if (scale > 1)
+		fu_benchmark_scale_firmware(firmware, scale);
+	blob = fu_firmware_write(firmware, error);
+	if (blob == NULL)
+		return FALSE;
+
+	/* time each operation */
+	if (!fu_benchmark_parse(item->gtype, blob, iterations, &result_parse, error)) {
+		g_prefix_error(error, "failed to parse: ");
+		return FALSE;
+	}
+	if (!fu_benchmark_write(firmware, iterations, &result_write, error)) {
+		g_prefix_error(error, "failed to write: ");
+		return FALSE;
+	}
+
+	json_builder_set_member_name(builder, "Size");
+	json_builder_add_int_value(builder, g_bytes_get_size(blob));
+	json_builder_set_member_name(builder, "ParseIterations");
+	json_builder_add_int_value(builder, result_parse.iterations);
+	json_builder_set_member_name(builder, "ParseThroughput");
+	json_builder_add_double_value(
+	    builder,
+	    fu_benchmark_result_get_throughput(&result_parse, g_bytes_get_size(blob)));
+	json_builder_set_member_name(builder, "WriteIterations");
+	json_builder_add_int_value(builder, result_write.iterations);
+	json_builder_set_member_name(builder, "WriteThroughput");
+	json_builder_add_double_value(
+	    builder,
+	    fu_benchmark_result_get_throughput(&result_write, g_bytes_get_size(blob)));
+	json_builder_set_member_name(builder, "HeapBytes");
+	json_builder_add_int_value(builder, result_parse.heap_bytes);
+	return TRUE;
+}
+
+int
+main(int argc, char **argv)
+{
+	guint iterations = 0;
+	gboolean verbose = FALSE;
+	g_autofree gchar *filter = NULL;
+	g_autofree gchar *output = NULL;
+	g_autofree gchar *scales_str = NULL;
+	g_autofree gchar *testdatadir = NULL;
+	g_autofree gchar *json = NULL;
+	g_auto(GStrv) scales = NULL;
+	g_autoptr(GOptionContext) context = g_option_context_new(NULL);
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonGenerator) json_generator = json_generator_new();
+	g_autoptr(JsonNode) json_root = NULL;
+	g_autoptr(GError) error = NULL;
+	FuBenchmarkItem items[] = {
+	    {FU_TYPE_CAB_FIRMWARE, "cab.builder.xml"},
+	    {FU_TYPE_CAB_FIRMWARE, "cab-compressed.builder.xml"},
+	    {FU_TYPE_DFU_FIRMWARE, "dfu.builder.xml"},
+	    {FU_TYPE_DFUSE_FIRMWARE, "dfuse.builder.xml"},
+	    {FU_TYPE_PEFILE_FIRMWARE, "pefile.builder.xml"},
+	    {FU_TYPE_LINEAR_FIRMWARE, "linear.builder.xml"},
+	    {FU_TYPE_HID_DESCRIPTOR, "hid-descriptor.builder.xml"},
+	    {FU_TYPE_SBATLEVEL_SECTION, "sbatlevel.builder.xml"},
+	    {FU_TYPE_CSV_FIRMWARE, "csv.builder.xml"},
+	    {FU_TYPE_FDT_FIRMWARE, "fdt.builder.xml"},
+	    {FU_TYPE_FIT_FIRMWARE, "fit.builder.xml"},
+	    {FU_TYPE_SREC_FIRMWARE, "srec.builder.xml"},
+	    {FU_TYPE_IHEX_FIRMWARE, "ihex.builder.xml"},
+	    {FU_TYPE_FMAP_FIRMWARE, "fmap.builder.xml"},
+	    {FU_TYPE_EFI_LOAD_OPTION, "efi-load-option.builder.xml"},
+	    {FU_TYPE_EDID, "edid.builder.xml"},
+	    {FU_TYPE_EFI_SECTION, "efi-section.builder.xml"},
+	    {FU_TYPE_EFI_FILE, "efi-file.builder.xml"},
+	    {FU_TYPE_EFI_FILESYSTEM, "efi-filesystem.builder.xml"},
+	    {FU_TYPE_EFI_SIGNATURE_LIST, "efi-signature-list.builder.xml"},
+	    {FU_TYPE_EFI_VOLUME, "efi-volume.builder.xml"},
+	    {FU_TYPE_IFD_FIRMWARE, "ifd.builder.xml"},
+	    {FU_TYPE_CFU_OFFER, "cfu-offer.builder.xml"},
+	    {FU_TYPE_CFU_PAYLOAD, "cfu-payload.builder.xml"},
+	    {FU_TYPE_IFWI_CPD_FIRMWARE, "ifwi-cpd.builder.xml"},
+	    {FU_TYPE_IFWI_FPT_FIRMWARE, "ifwi-fpt.builder.xml"},
+	    {FU_TYPE_OPROM_FIRMWARE, "oprom.builder.xml"},
+	    {FU_TYPE_INTEL_THUNDERBOLT_NVM, "intel-thunderbolt.builder.xml"},
+#ifdef HAVE_CBOR
+	    {FU_TYPE_USWID_FIRMWARE, "uswid.builder.xml"},
+	    {FU_TYPE_USWID_FIRMWARE, "uswid-compressed.builder.xml"},
+#endif
+	    {G_TYPE_INVALID, NULL}};
+	const GOptionEntry options[] = {
+	    {"verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose, "Be verbose", NULL},
+	    {"iterations",
+	     'i',
+	     0,
+	     G_OPTION_ARG_INT,
+	     &iterations,
+	     "Number of iterations, or 0 to run for a fixed time",
+	     NULL},
+	    {"scales",
+	     's',
+	     0,
+	     G_OPTION_ARG_STRING,
+	     &scales_str,
+	     "Comma separated payload multipliers, e.g. 1,64,4096",
+	     NULL},
+	    {"filter", 'f', 0, G_OPTION_ARG_STRING, &filter, "Only run matching builders", NULL},
+	    {"output", 'o', 0, G_OPTION_ARG_FILENAME, &output, "Write JSON results to file", NULL},
+	    {NULL}};
+
+	setlocale(LC_ALL, "");
+
+	g_option_context_add_main_entries(context, options, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("Failed to parse arguments: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+	if (verbose)
+		(void)g_setenv("G_MESSAGES_DEBUG", "all", TRUE);
+	scales = g_strsplit(scales_str != NULL ? scales_str : "1,64,4096", ",", -1);
+
+	/* use the same test data as the self tests */
+	if (g_getenv("G_TEST_SRCDIR") != NULL)
+		testdatadir = g_build_filename(g_getenv("G_TEST_SRCDIR"), "tests", NULL);
+	else
+		testdatadir = g_build_filename(SRCDIR, "tests", NULL);
+	g_type_ensure(FU_TYPE_COSWID_FIRMWARE);
+
+	json_builder_begin_object(builder);
+	json_builder_set_member_name(builder, "FwupdVersion");
+	json_builder_add_string_value(builder, PACKAGE_VERSION);
+	json_builder_set_member_name(builder, "Results");
+	json_builder_begin_array(builder);
+	for (guint i = 0; items[i].gtype != G_TYPE_INVALID; i++) {
+		if (filter != NULL && !g_pattern_match_simple(filter, items[i].xml_fn))
+			continue;
+		for (guint j = 0; scales[j] != NULL; j++) {
+			guint64 scale = 0;
+			g_autoptr(GError) error_local = NULL;
+
+			if (!fu_strtoull(scales[j], &scale, 1, G_MAXUINT32, &error)) {
+				g_printerr("Failed to parse scale: %s\n", error->message);
+				return EXIT_FAILURE;
+			}
+			json_builder_begin_object(builder);
+			json_builder_set_member_name(builder, "Builder");
+			json_builder_add_string_value(builder, items[i].xml_fn);
+			json_builder_set_member_name(builder, "GType");
+			json_builder_add_string_value(builder, g_type_name(items[i].gtype));
+			json_builder_set_member_name(builder, "Scale");
+			json_builder_add_int_value(builder, scale);
+
+			/* some formats have fixed sizes, so cannot be scaled */
+			if (!fu_benchmark_run_item(&items[i],
+						   testdatadir,
+						   scale,
+						   iterations,
+						   builder,
+						   &error_local)) {
+				g_debug("%s@%u: %s",
+					items[i].xml_fn,
+					(guint)scale,
+					error_local->message);
+				json_builder_set_member_name(builder, "Error");
+				json_builder_add_string_value(builder, error_local->message);
+			}
+			json_builder_end_object(builder);
+		}
+	}
+	json_builder_end_array(builder);
+	json_builder_end_object(builder);
+
+	/* export as a string */
+	json_root = json_builder_get_root(builder);
+	json_generator_set_pretty(json_generator, TRUE);
+	json_generator_set_root(json_generator, json_root);
+	json = json_generator_to_data(json_generator, NULL);
+	if (output != NULL) {
+		if (!g_file_set_contents(output, json, -1, &error)) {
+			g_printerr("Failed to save: %s\n", error->message);
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+	g_print("%s\n", json);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+/*
+ * Copyright 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include "fu-cab-firmware.h"
+
+void
+fu_cab_firmware_set_max_threads(FuCabFirmware *self, guint max_threads) G_GNUC_NON_NULL(1);
@@ -12,7 +12,7 @@
 
 #include "fu-byte-array.h"
 #include "fu-bytes.h"
-#include "fu-cab-firmware.h"
+#include "fu-cab-firmware-private.h"
 #include "fu-cab-image.h"
 #include "fu-cab-struct.h"
 #include "fu-chunk-array.h"
@@ -25,6 +25,7 @@
 typedef struct {
 	gboolean compressed;
 	gboolean only_basename;
+	guint max_threads; /* 0 for the number of CPUs */
 } FuCabFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuCabFirmware, fu_cab_firmware, FU_TYPE_FIRMWARE)
@@ -68,6 +69,24 @@ fu_cab_firmware_set_compressed(FuCabFirmware *self, gboolean compressed)
 	priv->compressed = compressed;
 }
 
+/**
+ * fu_cab_firmware_set_max_threads:
+ * @self: a #FuCabFirmware
+ * @max_threads: integer, or 0 to use one thread per CPU
+ *
+ * Sets the maximum number of threads used to compress the CFDATA blocks, where 1 compresses
+ * every block in the calling thread. The output does not depend on this value.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_cab_firmware_set_max_threads(FuCabFirmware *self, guint max_threads)
+{
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_CAB_FIRMWARE(self));
+	priv->max_threads = max_threads;
+}
+
 /**
  * fu_cab_firmware_get_only_basename:
  * @self: a #FuCabFirmware
@@ -626,6 +645,151 @@ fu_cab_firmware_parse(FuFirmware *firmware,
 	return TRUE;
 }
 
+/* each CFDATA block is deflated with a fresh stream, so blocks can be compressed in any order */
+static GByteArray *
+fu_cab_firmware_compress_chunk(FuChunk *chk, gboolean compressed, GError **error)
+{
+	g_autoptr(GByteArray) chunk_zlib = g_byte_array_new();
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+
+	fu_byte_array_set_size(chunk_zlib, fu_chunk_get_data_sz(chk) * 2, 0x0);
+	if (compressed) {
+		int zret;
+		z_stream zstrm = {
+		    .zalloc = zalloc,
+		    .zfree = zfree,
+		    .opaque = Z_NULL,
+		    .next_in = (guint8 *)fu_chunk_get_data(chk),
+		    .avail_in = fu_chunk_get_data_sz(chk),
+		    .next_out = chunk_zlib->data,
+		    .avail_out = chunk_zlib->len,
+		};
+		g_autoptr(z_stream_deflater) zstrm_deflater = &zstrm;
+		zret = deflateInit2(zstrm_deflater,
+				    Z_DEFAULT_COMPRESSION,
+				    Z_DEFLATED,
+				    -15,
+				    8,
+				    Z_DEFAULT_STRATEGY);
+		if (zret != Z_OK) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "failed to initialize deflate: %s",
+				    zError(zret));
+			return NULL;
+		}
+		zret = deflate(zstrm_deflater, Z_FINISH);
+		if (zret != Z_OK && zret != Z_STREAM_END) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "zlib deflate failed: %s",
+				    zError(zret));
+			return NULL;
+		}
+		fu_byte_array_append_uint8(buf, (guint8)'C');
+		fu_byte_array_append_uint8(buf, (guint8)'K');
+		g_byte_array_append(buf, chunk_zlib->data, zstrm.total_out);
+	} else {
+		g_byte_array_append(buf, fu_chunk_get_data(chk), fu_chunk_get_data_sz(chk));
+	}
+	return g_steal_pointer(&buf);
+}
+
+typedef struct {
+	FuChunk *chk;
+	GByteArray *buf;
+	GError *error;
+} FuCabFirmwareCompressHelper;
+
+static void
+fu_cab_firmware_compress_helper_free(FuCabFirmwareCompressHelper *helper)
+{
+	g_object_unref(helper->chk);
+	if (helper->buf != NULL)
+		g_byte_array_unref(helper->buf);
+	if (helper->error != NULL)
+		g_error_free(helper->error);
+	g_free(helper);
+}
+
+static void
+fu_cab_firmware_compress_thread_cb(gpointer data, gpointer user_data)
+{
+	FuCabFirmwareCompressHelper *helper = (FuCabFirmwareCompressHelper *)data;
+	helper->buf = fu_cab_firmware_compress_chunk(helper->chk, TRUE, &helper->error);
+}
+
+static GPtrArray *
+fu_cab_firmware_compress_chunks(FuCabFirmware *self, FuChunkArray *chunks, GError **error)
+{
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	guint chunks_len = fu_chunk_array_length(chunks);
+	guint max_threads = priv->max_threads > 0 ? priv->max_threads : g_get_num_processors();
+	GThreadPool *pool;
+	g_autoptr(GPtrArray) helpers =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_cab_firmware_compress_helper_free);
+	g_autoptr(GPtrArray) chunks_zlib =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_byte_array_unref);
+
+	/* not worth starting any threads */
+	max_threads = MIN(chunks_len, max_threads);
+	if (!priv->compressed || max_threads < 2) {
+		for (guint i = 0; i < chunks_len; i++) {
+			g_autoptr(FuChunk) chk = NULL;
+			g_autoptr(GByteArray) buf = NULL;
+
+			chk = fu_chunk_array_index(chunks, i, error);
+			if (chk == NULL)
+				return NULL;
+			buf = fu_cab_firmware_compress_chunk(chk, priv->compressed, error);
+			if (buf == NULL)
+				return NULL;
+			g_ptr_array_add(chunks_zlib, g_steal_pointer(&buf));
+		}
+		return g_steal_pointer(&chunks_zlib);
+	}
+
+	/* the chunks are created here as FuChunkArray is not thread-safe */
+	for (guint i = 0; i < chunks_len; i++) {
+		FuCabFirmwareCompressHelper *helper;
+		FuChunk *chk = fu_chunk_array_index(chunks, i, error);
+		if (chk == NULL)
+			return NULL;
+		helper = g_new0(FuCabFirmwareCompressHelper, 1);
+		helper->chk = chk;
+		g_ptr_array_add(helpers, helper);
+	}
+
+	/* deflate every block on a worker thread, and wait for them all to finish */
+	pool = g_thread_pool_new(fu_cab_firmware_compress_thread_cb,
+				 NULL,
+				 max_threads,
+				 FALSE,
+				 error);
+	if (pool == NULL)
+		return NULL;
+	for (guint i = 0; i < helpers->len; i++) {
+		if (!g_thread_pool_push(pool, g_ptr_array_index(helpers, i), error)) {
+			g_thread_pool_free(pool, FALSE, TRUE);
+			return NULL;
+		}
+	}
+	g_thread_pool_free(pool, FALSE, TRUE);
+
+	/* keep the original block order so the output is identical to compressing serially */
+	for (guint i = 0; i < helpers->len; i++) {
+		FuCabFirmwareCompressHelper *helper = g_ptr_array_index(helpers, i);
+		if (helper->error != NULL) {
+			g_propagate_error(error, g_steal_pointer(&helper->error));
+			return NULL;
+		}
+		g_ptr_array_add(chunks_zlib, g_steal_pointer(&helper->buf));
+	}
+	return g_steal_pointer(&chunks_zlib);
+}
+
 static GByteArray *
 fu_cab_firmware_write(FuFirmware *firmware, GError **error)
 {
@@ -640,8 +804,7 @@ fu_cab_firmware_write(FuFirmware *firmware, GError **error)
 	g_autoptr(GByteArray) cfdata_linear = g_byte_array_new();
 	g_autoptr(GBytes) cfdata_linear_blob = NULL;
 	g_autoptr(FuChunkArray) chunks = NULL;
-	g_autoptr(GPtrArray) chunks_zlib =
-	    g_ptr_array_new_with_free_func((GDestroyNotify)g_byte_array_unref);
+	g_autoptr(GPtrArray) chunks_zlib = NULL;
 
 	/* create linear CFDATA block */
 	for (guint i = 0; i < imgs->len; i++) {
@@ -673,58 +836,9 @@ fu_cab_firmware_write(FuFirmware *firmware, GError **error)
 	cfdata_linear_blob =
 	    g_byte_array_free_to_bytes(g_steal_pointer(&cfdata_linear)); /* nocheck */
 	chunks = fu_chunk_array_new_from_bytes(cfdata_linear_blob, 0x0, 0x8000);
-	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
-		g_autoptr(FuChunk) chk = NULL;
-		g_autoptr(GByteArray) chunk_zlib = g_byte_array_new();
-		g_autoptr(GByteArray) buf = g_byte_array_new();
-
-		chk = fu_chunk_array_index(chunks, i, error);
-		if (chk == NULL)
-			return NULL;
-		fu_byte_array_set_size(chunk_zlib, fu_chunk_get_data_sz(chk) * 2, 0x0);
-		if (priv->compressed) {
-			int zret;
-			z_stream zstrm = {
-			    .zalloc = zalloc,
-			    .zfree = zfree,
-			    .opaque = Z_NULL,
-			    .next_in = (guint8 *)fu_chunk_get_data(chk),
-			    .avail_in = fu_chunk_get_data_sz(chk),
-			    .next_out = chunk_zlib->data,
-			    .avail_out = chunk_zlib->len,
-			};
-			g_autoptr(z_stream_deflater) zstrm_deflater = &zstrm;
-			zret = deflateInit2(zstrm_deflater,
-					    Z_DEFAULT_COMPRESSION,
-					    Z_DEFLATED,
-					    -15,
-					    8,
-					    Z_DEFAULT_STRATEGY);
-			if (zret != Z_OK) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_NOT_SUPPORTED,
-					    "failed to initialize deflate: %s",
-					    zError(zret));
-				return NULL;
-			}
-			zret = deflate(zstrm_deflater, Z_FINISH);
-			if (zret != Z_OK && zret != Z_STREAM_END) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_NOT_SUPPORTED,
-					    "zlib deflate failed: %s",
-					    zError(zret));
-				return NULL;
-			}
-			fu_byte_array_append_uint8(buf, (guint8)'C');
-			fu_byte_array_append_uint8(buf, (guint8)'K');
-			g_byte_array_append(buf, chunk_zlib->data, zstrm.total_out);
-		} else {
-			g_byte_array_append(buf, fu_chunk_get_data(chk), fu_chunk_get_data_sz(chk));
-		}
-		g_ptr_array_add(chunks_zlib, g_steal_pointer(&buf));
-	}
+	chunks_zlib = fu_cab_firmware_compress_chunks(self, chunks, error);
+	if (chunks_zlib == NULL)
+		return NULL;
 
 	/* create header */
 	archive_size = FU_STRUCT_CAB_HEADER_SIZE;
@@ -25,6 +25,8 @@ struct _FuChunkArray {
 	GObject parent_instance;
 	GBytes *blob;
 	GInputStream *stream;
+	GBytes *readahead;
+	gsize readahead_offset;
 	guint32 addr_start;
 	guint32 packet_sz;
 	guint total_chunks;
@@ -33,6 +35,9 @@ struct _FuChunkArray {
 
 G_DEFINE_TYPE(FuChunkArray, fu_chunk_array, G_TYPE_OBJECT)
 
+/* read this much of the stream at once rather than doing a seek and read for each packet */
+#define FU_CHUNK_ARRAY_READAHEAD_SIZE 0x10000
+
 /**
  * fu_chunk_array_length:
  * @self: a #FuChunkArray
@@ -50,6 +55,35 @@ fu_chunk_array_length(FuChunkArray *self)
 	return self->total_chunks;
 }
 
+static gboolean
+fu_chunk_array_ensure_readahead(FuChunkArray *self, gsize offset, gsize length, GError **error)
+{
+	gsize bufsz = MAX(FU_CHUNK_ARRAY_READAHEAD_SIZE / self->packet_sz, 1) * self->packet_sz;
+	gsize offset_new = offset;
+
+	/* already cached */
+	if (self->readahead != NULL && offset >= self->readahead_offset &&
+	    offset + length <= self->readahead_offset + g_bytes_get_size(self->readahead))
+		return TRUE;
+
+	/* some plugins write the chunks in reverse order, so cache the packets *before* this one */
+	if (self->readahead != NULL && offset < self->readahead_offset && offset + length > bufsz)
+		offset_new = offset + length - bufsz;
+	else if (self->readahead != NULL && offset < self->readahead_offset)
+		offset_new = 0;
+	bufsz = MIN(bufsz, self->total_size - offset_new);
+
+	if (self->readahead != NULL) {
+		g_bytes_unref(self->readahead);
+		self->readahead = NULL;
+	}
+	self->readahead = fu_input_stream_read_bytes(self->stream, offset_new, bufsz, error);
+	if (self->readahead == NULL)
+		return FALSE;
+	self->readahead_offset = offset_new;
+	return TRUE;
+}
+
 /**
  * fu_chunk_array_index:
  * @self: a #FuChunkArray
@@ -87,14 +121,16 @@ fu_chunk_array_index(FuChunkArray *self, guint idx, GError **error)
 	if (self->blob != NULL) {
 		blob_chk = g_bytes_new_from_bytes(self->blob, offset, length);
 	} else if (self->stream != NULL) {
-		blob_chk = fu_input_stream_read_bytes(self->stream, offset, length, error);
-		if (blob_chk == NULL) {
+		if (!fu_chunk_array_ensure_readahead(self, offset, length, error)) {
 			g_prefix_error(error,
 				       "failed to get stream at 0x%x for 0x%x: ",
 				       (guint)offset,
 				       (guint)length);
 			return NULL;
 		}
+		blob_chk = g_bytes_new_from_bytes(self->readahead,
+						  offset - self->readahead_offset,
+						  length);
 	} else {
 		blob_chk = g_bytes_new(NULL, 0);
 	}
@@ -180,6 +216,8 @@ fu_chunk_array_finalize(GObject *object)
 		g_bytes_unref(self->blob);
 	if (self->stream != NULL)
 		g_object_unref(self->stream);
+	if (self->readahead != NULL)
+		g_bytes_unref(self->readahead);
 	G_OBJECT_CLASS(fu_chunk_array_parent_class)->finalize(object);
 }
 
@@ -57,6 +57,19 @@ fu_context_get_plugin_names_for_udev_subsystem(FuContext *self,
 					       const gchar *subsystem,
 					       GError **error) G_GNUC_NON_NULL(1, 2);
 void
+fu_context_set_udev_cache_enabled(FuContext *self, gboolean enabled) G_GNUC_NON_NULL(1);
+gboolean
+fu_context_get_udev_cache_enabled(FuContext *self) G_GNUC_NON_NULL(1);
+GObject *
+fu_context_lookup_udev_parent(FuContext *self, const gchar *sysfs_path) G_GNUC_NON_NULL(1, 2);
+GObject *
+fu_context_add_udev_parent(FuContext *self,
+			   const gchar *sysfs_path,
+			   const gchar *parent_sysfs_path,
+			   GObject *udev_parent) G_GNUC_NON_NULL(1, 2, 3, 4);
+void
+fu_context_invalidate_udev_device(FuContext *self, const gchar *sysfs_path) G_GNUC_NON_NULL(1, 2);
+void
 fu_context_add_esp_volume(FuContext *self, FuVolume *volume) G_GNUC_NON_NULL(1);
 FuSmbios *
 fu_context_get_smbios(FuContext *self) G_GNUC_NON_NULL(1);
@@ -65,4 +78,8 @@ fu_context_get_hwids(FuContext *self) G_GNUC_NON_NULL(1);
 FuConfig *
 fu_context_get_config(FuContext *self) G_GNUC_NON_NULL(1);
 void
+fu_context_add_sleep_skipped(FuContext *self, guint delay_ms) G_GNUC_NON_NULL(1);
+guint
+fu_context_get_sleep_skipped(FuContext *self) G_GNUC_NON_NULL(1);
+void
 fu_context_set_chassis_kind(FuContext *self, FuSmbiosChassisKind chassis_kind) G_GNUC_NON_NULL(1);
@@ -8,6 +8,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "fu-bios-settings-private.h"
 #include "fu-common-private.h"
 #include "fu-config-private.h"
@@ -35,6 +37,10 @@ typedef struct {
 	GHashTable *runtime_versions;
 	GHashTable *compile_versions;
 	GHashTable *udev_subsystems; /* utf8:GPtrArray */
+	GHashTable *udev_devices;    /* sysfs:GUdevDevice, only while udev_cache_enabled */
+	GHashTable *udev_parents;    /* sysfs:sysfs of the parent */
+	gboolean udev_cache_enabled;
+	GMutex udev_devices_mutex;
 	GPtrArray *esp_volumes;
 	GHashTable *firmware_gtypes; /* utf8:GType */
 	GHashTable *hwid_flags;	     /* str: */
@@ -46,6 +52,7 @@ typedef struct {
 	FuBiosSettings *host_bios_settings;
 	FuFirmware *fdt; /* optional */
 	gchar *esp_location;
+	gint sleep_skipped_ms; /* atomic */
 } FuContextPrivate;
 
 enum { SIGNAL_SECURITY_CHANGED, SIGNAL_LAST };
@@ -189,6 +196,41 @@ fu_context_get_config(FuContext *self)
 	return priv->config;
 }
 
+/**
+ * fu_context_add_sleep_skipped:
+ * @self: a #FuContext
+ * @delay_ms: delay in milliseconds
+ *
+ * Records a delay that was not performed because the device is emulated.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_context_add_sleep_skipped(FuContext *self, guint delay_ms)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_CONTEXT(self));
+	g_atomic_int_add(&priv->sleep_skipped_ms, (gint)delay_ms);
+}
+
+/**
+ * fu_context_get_sleep_skipped:
+ * @self: a #FuContext
+ *
+ * Gets the total delay that was not performed because devices were emulated.
+ *
+ * Returns: delay in milliseconds
+ *
+ * Since: 2.0.0
+ **/
+guint
+fu_context_get_sleep_skipped(FuContext *self)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CONTEXT(self), 0);
+	return (guint)g_atomic_int_get(&priv->sleep_skipped_ms);
+}
+
 /**
  * fu_context_get_smbios_string:
  * @self: a #FuContext
@@ -710,6 +752,176 @@ fu_context_get_udev_subsystems(FuContext *self)
 	return g_steal_pointer(&subsystems);
 }
 
+/**
+ * fu_context_set_udev_cache_enabled: (skip):
+ * @self: a #FuContext
+ * @enabled: boolean
+ *
+ * Shares the udev parent nodes between devices, typically only during coldplug. Sharing the
+ * node means the parent is only resolved once, and the attributes that have already been read
+ * for it do not need to be read again. Disabling the cache drops all the shared nodes.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_context_set_udev_cache_enabled(FuContext *self, gboolean enabled)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->udev_devices_mutex);
+
+	g_return_if_fail(FU_IS_CONTEXT(self));
+
+	priv->udev_cache_enabled = enabled;
+	if (!enabled) {
+		g_hash_table_remove_all(priv->udev_devices);
+		g_hash_table_remove_all(priv->udev_parents);
+	}
+}
+
+/**
+ * fu_context_get_udev_cache_enabled: (skip):
+ * @self: a #FuContext
+ *
+ * Gets if the udev parent nodes are being shared between devices.
+ *
+ * Returns: boolean
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_context_get_udev_cache_enabled(FuContext *self)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->udev_devices_mutex);
+	g_return_val_if_fail(FU_IS_CONTEXT(self), FALSE);
+	return priv->udev_cache_enabled;
+}
+
+/**
+ * fu_context_lookup_udev_parent: (skip):
+ * @self: a #FuContext
+ * @sysfs_path: a sysfs path, e.g. `/sys/devices/pci0000:00/0000:00:14.0`
+ *
+ * Finds the shared parent node of a sysfs path.
+ *
+ * Returns: (transfer full): a #GUdevDevice, or %NULL if not cached
+ *
+ * Since: 2.0.0
+ **/
+GObject *
+fu_context_lookup_udev_parent(FuContext *self, const gchar *sysfs_path)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	const gchar *parent_sysfs_path;
+	GObject *udev_parent;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->udev_devices_mutex);
+
+	g_return_val_if_fail(FU_IS_CONTEXT(self), NULL);
+	g_return_val_if_fail(sysfs_path != NULL, NULL);
+
+	parent_sysfs_path = g_hash_table_lookup(priv->udev_parents, sysfs_path);
+	if (parent_sysfs_path == NULL)
+		return NULL;
+	udev_parent = g_hash_table_lookup(priv->udev_devices, parent_sysfs_path);
+	if (udev_parent == NULL)
+		return NULL;
+	return g_object_ref(udev_parent);
+}
+
+/**
+ * fu_context_add_udev_parent: (skip):
+ * @self: a #FuContext
+ * @sysfs_path: a sysfs path, e.g. `/sys/devices/pci0000:00/0000:00:14.0`
+ * @parent_sysfs_path: the sysfs path of the parent, e.g. `/sys/devices/pci0000:00`
+ * @udev_parent: a #GUdevDevice for @parent_sysfs_path
+ *
+ * Adds the parent node of a sysfs path so that it can be shared with other devices. If another
+ * device already added a node for @parent_sysfs_path then that node is used instead.
+ *
+ * Returns: (transfer full): the shared #GUdevDevice, or @udev_parent if the cache is disabled
+ *
+ * Since: 2.0.0
+ **/
+GObject *
+fu_context_add_udev_parent(FuContext *self,
+			   const gchar *sysfs_path,
+			   const gchar *parent_sysfs_path,
+			   GObject *udev_parent)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	GObject *udev_parent_shared;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->udev_devices_mutex);
+
+	g_return_val_if_fail(FU_IS_CONTEXT(self), NULL);
+	g_return_val_if_fail(sysfs_path != NULL, NULL);
+	g_return_val_if_fail(parent_sysfs_path != NULL, NULL);
+	g_return_val_if_fail(G_IS_OBJECT(udev_parent), NULL);
+
+	if (!priv->udev_cache_enabled)
+		return g_object_ref(udev_parent);
+	udev_parent_shared = g_hash_table_lookup(priv->udev_devices, parent_sysfs_path);
+	if (udev_parent_shared == NULL) {
+		udev_parent_shared = udev_parent;
+		g_hash_table_insert(priv->udev_devices,
+				    g_strdup(parent_sysfs_path),
+				    g_object_ref(udev_parent));
+	}
+	g_hash_table_insert(priv->udev_parents, g_strdup(sysfs_path), g_strdup(parent_sysfs_path));
+	return g_object_ref(udev_parent_shared);
+}
+
+static gboolean
+fu_context_udev_device_path_contains(const gchar *sysfs_path, const gchar *prefix)
+{
+	gsize prefixsz = strlen(prefix);
+	return strncmp(sysfs_path, prefix, prefixsz) == 0 &&
+	       (sysfs_path[prefixsz] == '\0' || sysfs_path[prefixsz] == '/');
+}
+
+static gboolean
+fu_context_invalidate_udev_device_cb(gpointer key, gpointer value, gpointer user_data)
+{
+	const gchar *sysfs_path = (const gchar *)key;
+	const gchar *sysfs_path_changed = (const gchar *)user_data;
+	return fu_context_udev_device_path_contains(sysfs_path, sysfs_path_changed) ||
+	       fu_context_udev_device_path_contains(sysfs_path_changed, sysfs_path);
+}
+
+static gboolean
+fu_context_invalidate_udev_parent_cb(gpointer key, gpointer value, gpointer user_data)
+{
+	return fu_context_invalidate_udev_device_cb(key, NULL, user_data) ||
+	       fu_context_invalidate_udev_device_cb(value, NULL, user_data);
+}
+
+/**
+ * fu_context_invalidate_udev_device: (skip):
+ * @self: a #FuContext
+ * @sysfs_path: a sysfs path, e.g. `/sys/devices/pci0000:00`
+ *
+ * Removes a shared sysfs node, and all the nodes above and below it, typically because the
+ * device has changed or been removed. The parents are removed too as a USB device that
+ * re-enumerates at the same port keeps the same sysfs path but may have new attributes.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_context_invalidate_udev_device(FuContext *self, const gchar *sysfs_path)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->udev_devices_mutex);
+
+	g_return_if_fail(FU_IS_CONTEXT(self));
+	g_return_if_fail(sysfs_path != NULL);
+
+	g_hash_table_foreach_remove(priv->udev_devices,
+				    fu_context_invalidate_udev_device_cb,
+				    (gpointer)sysfs_path);
+	g_hash_table_foreach_remove(priv->udev_parents,
+				    fu_context_invalidate_udev_parent_cb,
+				    (gpointer)sysfs_path);
+}
+
 /**
  * fu_context_add_firmware_gtype:
  * @self: a #FuContext
@@ -1577,6 +1789,9 @@ fu_context_finalize(GObject *object)
 	g_object_unref(priv->host_bios_settings);
 	g_hash_table_unref(priv->firmware_gtypes);
 	g_hash_table_unref(priv->udev_subsystems);
+	g_hash_table_unref(priv->udev_devices);
+	g_hash_table_unref(priv->udev_parents);
+	g_mutex_clear(&priv->udev_devices_mutex);
 	g_ptr_array_unref(priv->esp_volumes);
 
 	G_OBJECT_CLASS(fu_context_parent_class)->finalize(object);
@@ -1725,6 +1940,10 @@ fu_context_init(FuContext *self)
 						      g_str_equal,
 						      g_free,
 						      (GDestroyNotify)g_ptr_array_unref);
+	priv->udev_devices =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_object_unref);
+	priv->udev_parents = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	g_mutex_init(&priv->udev_devices_mutex);
 	priv->firmware_gtypes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	priv->quirks = fu_quirks_new();
 	priv->host_bios_settings = fu_bios_settings_new();
@@ -75,3 +75,5 @@ gboolean
 fu_device_has_counterpart_guid(FuDevice *self, const gchar *guid) G_GNUC_NON_NULL(1, 2);
 GPtrArray *
 fu_device_get_counterpart_guids(FuDevice *self) G_GNUC_NON_NULL(1);
+void
+fu_device_add_report_metadata_timing(FuDevice *self, GHashTable *metadata) G_GNUC_NON_NULL(1, 2);
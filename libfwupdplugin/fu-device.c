@@ -16,6 +16,7 @@
 
 #include "fu-bytes.h"
 #include "fu-common.h"
+#include "fu-context-private.h"
 #include "fu-device-private.h"
 #include "fu-input-stream.h"
 #include "fu-quirks.h"
@@ -53,10 +54,10 @@ typedef struct {
 	FuContext *ctx;
 	GHashTable *inhibits; /* (nullable) */
 	GHashTable *metadata; /* (nullable) */
-	GPtrArray *parent_guids;	/* (nullable) (element-type utf-8) */
+	GPtrArray *parent_guids;	/* (nullable) (element-type utf-8) interned */
 	GPtrArray *parent_physical_ids; /* (nullable) */
 	GPtrArray *parent_backend_ids;	/* (nullable) */
-	GPtrArray *counterpart_guids;	/* (nullable) */
+	GPtrArray *counterpart_guids;	/* (nullable) (element-type utf-8) interned */
 	guint remove_delay;		/* ms */
 	guint acquiesce_delay;		/* ms */
 	guint request_cnts[FWUPD_REQUEST_KIND_LAST];
@@ -73,10 +74,12 @@ typedef struct {
 	GType specialized_gtype;
 	GType proxy_gtype;
 	GType firmware_gtype;
-	GPtrArray *possible_plugins;   /* (element-type utf-8) */
+	GPtrArray *possible_plugins;   /* (element-type utf-8) interned */
 	GPtrArray *instance_id_quirks; /* (nullable) (element-type utf-8) */
 	GPtrArray *retry_recs;	       /* (nullable) (element-type FuDeviceRetryRecovery) */
 	guint retry_delay;
+	guint retry_cnt;  /* failed tries that were retried */
+	guint64 sleep_ms; /* total requested by fu_device_sleep() */
 	FuDeviceInternalFlags internal_flags;
 	guint64 private_flags;
 	GPtrArray *private_flag_items; /* (nullable) */
@@ -84,6 +87,7 @@ typedef struct {
 	gulong notify_flags_handler_id;
 	GHashTable *instance_hash; /* (nullable) */
 	FuProgress *progress; /* provided for FuDevice notify callbacks */
+	FuVersionKey *version_key; /* (nullable) */
 } FuDevicePrivate;
 
 typedef struct {
@@ -649,6 +653,16 @@ fu_device_set_private_flags(FuDevice *self, guint64 flag)
 	g_object_notify(G_OBJECT(self), "private-flags");
 }
 
+/* the canonical pointer if @str has ever been interned, as done for GUIDs and plugin names */
+static const gchar *
+fu_device_intern_lookup(const gchar *str)
+{
+	GQuark quark = g_quark_try_string(str);
+	if (quark == 0)
+		return NULL;
+	return g_quark_to_string(quark);
+}
+
 /**
  * fu_device_get_possible_plugins:
  * @self: a #FuDevice
@@ -687,9 +701,10 @@ fu_device_add_possible_plugin(FuDevice *self, const gchar *plugin)
 	g_return_if_fail(plugin != NULL);
 
 	/* add if it does not already exist */
-	if (g_ptr_array_find_with_equal_func(priv->possible_plugins, plugin, g_str_equal, NULL))
+	plugin = g_intern_string(plugin);
+	if (g_ptr_array_find(priv->possible_plugins, plugin, NULL))
 		return;
-	g_ptr_array_add(priv->possible_plugins, g_strdup(plugin));
+	g_ptr_array_add(priv->possible_plugins, (gpointer)plugin);
 }
 
 /**
@@ -744,6 +759,33 @@ fu_device_retry_set_delay(FuDevice *self, guint delay)
 	priv->retry_delay = delay;
 }
 
+/* returns %FALSE if a recovery function failed, or if recovery is not possible */
+static gboolean
+fu_device_retry_recover(FuDevice *self, GError **error_local, gpointer user_data, GError **error)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+
+	priv->retry_cnt++;
+	if (priv->retry_recs == NULL)
+		return TRUE;
+
+	/* find the condition that matches */
+	for (guint j = 0; j < priv->retry_recs->len; j++) {
+		FuDeviceRetryRecovery *rec = g_ptr_array_index(priv->retry_recs, j);
+		if (!g_error_matches(*error_local, rec->domain, rec->code))
+			continue;
+		if (rec->recovery_func == NULL) {
+			g_propagate_prefixed_error(error,
+						   g_steal_pointer(error_local),
+						   "device recovery not possible: ");
+			return FALSE;
+		}
+		if (!rec->recovery_func(self, user_data, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
 /**
  * fu_device_retry_full:
  * @self: a #FuDevice
@@ -772,8 +814,6 @@ fu_device_retry_full(FuDevice *self,
 		     gpointer user_data,
 		     GError **error)
 {
-	FuDevicePrivate *priv = GET_PRIVATE(self);
-
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(func != NULL, FALSE);
 	g_return_val_if_fail(count >= 1, FALSE);
@@ -809,27 +849,94 @@ fu_device_retry_full(FuDevice *self,
 		}
 
 		/* show recoverable error on the console */
-		if (priv->retry_recs == NULL || priv->retry_recs->len == 0) {
-			g_info("failed on try %u of %u: %s", i + 1, count, error_local->message);
-			continue;
+		g_info("failed on try %u of %u: %s", i + 1, count, error_local->message);
+		if (!fu_device_retry_recover(self, &error_local, user_data, error))
+			return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+}
+
+/**
+ * fu_device_retry_backoff:
+ * @self: a #FuDevice
+ * @func: (scope async) (closure user_data): a function to execute
+ * @delay: the initial delay between tries in ms
+ * @timeout: the maximum total delay in ms
+ * @user_data: (nullable): a helper to pass to @func
+ * @error: (nullable): optional return location for an error
+ *
+ * Calls a specific function until it succeeds, doubling the delay between each try (up to 50s)
+ * until @timeout has been spent waiting. A small amount of jitter is added to each delay so that
+ * devices of the same type do not all poll in lockstep.
+ *
+ * This should be used instead of a fixed fu_device_sleep() when @func can check that the device
+ * is ready, as it will usually return much sooner than the worst-case delay.
+ *
+ * Errors are handled using the recovery functions set with fu_device_retry_add_recovery() in the
+ * same way as fu_device_retry_full().
+ *
+ * Returns: %TRUE if @func succeeded
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_device_retry_backoff(FuDevice *self,
+			FuDeviceRetryFunc func,
+			guint delay,
+			guint timeout,
+			gpointer user_data,
+			GError **error)
+{
+	guint delay_total = 0;
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
+	g_return_val_if_fail(func != NULL, FALSE);
+	g_return_val_if_fail(delay > 0 && delay <= 50000, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	for (guint i = 0;; i++) {
+		guint delay_next;
+		g_autoptr(GError) error_local = NULL;
+
+		/* run function, if success return success */
+		if (func(self, user_data, &error_local))
+			break;
+
+		/* sanity check */
+		if (error_local == NULL) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "exec failed but no error set!");
+			return FALSE;
 		}
 
-		/* find the condition that matches */
-		for (guint j = 0; j < priv->retry_recs->len; j++) {
-			FuDeviceRetryRecovery *rec = g_ptr_array_index(priv->retry_recs, j);
-			if (g_error_matches(error_local, rec->domain, rec->code)) {
-				if (rec->recovery_func != NULL) {
-					if (!rec->recovery_func(self, user_data, error))
-						return FALSE;
-				} else {
-					g_propagate_prefixed_error(
-					    error,
-					    g_steal_pointer(&error_local),
-					    "device recovery not possible: ");
-					return FALSE;
-				}
-			}
+		/* out of time */
+		if (delay_total >= timeout) {
+			g_propagate_prefixed_error(error,
+						   g_steal_pointer(&error_local),
+						   "failed after %u tries in %ums: ",
+						   i + 1,
+						   delay_total);
+			return FALSE;
 		}
+
+		/* show recoverable error on the console */
+		g_info("failed on try %u, %ums remaining: %s",
+		       i + 1,
+		       timeout - delay_total,
+		       error_local->message);
+		if (!fu_device_retry_recover(self, &error_local, user_data, error))
+			return FALSE;
+
+		/* +/- 12.5% jitter, and never wait longer than the time remaining */
+		delay_next = delay + g_random_int_range(0, (delay / 4) + 1) - (delay / 8);
+		delay_next = CLAMP(delay_next, 1, timeout - delay_total);
+		fu_device_sleep(self, delay_next);
+		delay_total += delay_next;
+		delay = MIN(delay * 2, 50000);
 	}
 
 	/* success */
@@ -866,6 +973,18 @@ fu_device_retry(FuDevice *self,
 	return fu_device_retry_full(self, func, count, priv->retry_delay, user_data, error);
 }
 
+/* no delays are performed for emulated devices */
+static gboolean
+fu_device_sleep_is_emulated(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	if (fu_device_has_flag(self, FWUPD_DEVICE_FLAG_EMULATED))
+		return TRUE;
+	if (priv->proxy != NULL && fu_device_has_flag(priv->proxy, FWUPD_DEVICE_FLAG_EMULATED))
+		return TRUE;
+	return FALSE;
+}
+
 /**
  * fu_device_sleep:
  * @self: a #FuDevice
@@ -887,12 +1006,17 @@ fu_device_sleep(FuDevice *self, guint delay_ms)
 	g_return_if_fail(FU_IS_DEVICE(self));
 	g_return_if_fail(delay_ms < 100000);
 
-	if (fu_device_has_flag(self, FWUPD_DEVICE_FLAG_EMULATED))
-		return;
-	if (priv->proxy != NULL && fu_device_has_flag(priv->proxy, FWUPD_DEVICE_FLAG_EMULATED))
+	if (fu_device_sleep_is_emulated(self)) {
+		if (priv->ctx != NULL)
+			fu_context_add_sleep_skipped(priv->ctx, delay_ms);
 		return;
-	if (delay_ms > 0)
+	}
+	if (delay_ms > 0) {
+		priv->sleep_ms += delay_ms;
+		if (priv->progress != NULL)
+			fu_progress_add_sleep(priv->progress, delay_ms);
 		g_usleep(delay_ms * 1000);
+	}
 }
 
 /**
@@ -915,12 +1039,15 @@ fu_device_sleep_full(FuDevice *self, guint delay_ms, FuProgress *progress)
 	g_return_if_fail(delay_ms < 1000000);
 	g_return_if_fail(FU_IS_PROGRESS(progress));
 
-	if (fu_device_has_flag(self, FWUPD_DEVICE_FLAG_EMULATED))
-		return;
-	if (priv->proxy != NULL && fu_device_has_flag(priv->proxy, FWUPD_DEVICE_FLAG_EMULATED))
+	if (fu_device_sleep_is_emulated(self)) {
+		if (priv->ctx != NULL)
+			fu_context_add_sleep_skipped(priv->ctx, delay_ms);
 		return;
-	if (delay_ms > 0)
+	}
+	if (delay_ms > 0) {
+		priv->sleep_ms += delay_ms;
 		fu_progress_sleep(progress, delay_ms);
+	}
 }
 
 static gboolean
@@ -1540,7 +1667,7 @@ fu_device_ensure_parent_guids(FuDevice *self)
 	FuDevicePrivate *priv = GET_PRIVATE(self);
 	if (priv->parent_guids != NULL)
 		return;
-	priv->parent_guids = g_ptr_array_new_with_free_func(g_free);
+	priv->parent_guids = g_ptr_array_new();
 }
 
 /**
@@ -1584,12 +1711,10 @@ fu_device_has_parent_guid(FuDevice *self, const gchar *guid)
 
 	if (priv->parent_guids == NULL)
 		return FALSE;
-	for (guint i = 0; i < priv->parent_guids->len; i++) {
-		const gchar *guid_tmp = g_ptr_array_index(priv->parent_guids, i);
-		if (g_strcmp0(guid_tmp, guid) == 0)
-			return TRUE;
-	}
-	return FALSE;
+	guid = fu_device_intern_lookup(guid);
+	if (guid == NULL)
+		return FALSE;
+	return g_ptr_array_find(priv->parent_guids, guid, NULL);
 }
 
 /**
@@ -1625,14 +1750,14 @@ fu_device_add_parent_guid(FuDevice *self, const gchar *guid)
 		if (fu_device_has_parent_guid(self, tmp))
 			return;
 		g_debug("using %s for %s", tmp, guid);
-		g_ptr_array_add(priv->parent_guids, g_steal_pointer(&tmp));
+		g_ptr_array_add(priv->parent_guids, (gpointer)g_intern_string(tmp));
 		return;
 	}
 
 	/* already valid */
 	if (fu_device_has_parent_guid(self, guid))
 		return;
-	g_ptr_array_add(priv->parent_guids, g_strdup(guid));
+	g_ptr_array_add(priv->parent_guids, (gpointer)g_intern_string(guid));
 }
 
 /**
@@ -2551,12 +2676,10 @@ fu_device_has_counterpart_guid(FuDevice *self, const gchar *guid)
 	}
 
 	/* any defined? */
-	for (guint i = 0; i < priv->counterpart_guids->len; i++) {
-		const gchar *counterpart_guid = g_ptr_array_index(priv->counterpart_guids, i);
-		if (g_strcmp0(guid, counterpart_guid) == 0)
-			return TRUE;
-	}
-	return FALSE;
+	guid = fu_device_intern_lookup(guid);
+	if (guid == NULL)
+		return FALSE;
+	return g_ptr_array_find(priv->counterpart_guids, guid, NULL);
 }
 
 static void
@@ -2565,7 +2688,7 @@ fu_device_ensure_counterpart_guids(FuDevice *self)
 	FuDevicePrivate *priv = GET_PRIVATE(self);
 	if (priv->counterpart_guids != NULL)
 		return;
-	priv->counterpart_guids = g_ptr_array_new_with_free_func(g_free);
+	priv->counterpart_guids = g_ptr_array_new();
 }
 
 /**
@@ -2620,12 +2743,13 @@ fu_device_add_counterpart_guid(FuDevice *self, const gchar *guid)
 
 	/* make valid */
 	if (!fwupd_guid_is_valid(guid)) {
-		g_ptr_array_add(priv->counterpart_guids, fwupd_guid_hash_string(guid));
+		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
+		g_ptr_array_add(priv->counterpart_guids, (gpointer)g_intern_string(tmp));
 		return;
 	}
 
 	/* already valid */
-	g_ptr_array_add(priv->counterpart_guids, g_strdup(guid));
+	g_ptr_array_add(priv->counterpart_guids, (gpointer)g_intern_string(guid));
 }
 
 /**
@@ -2961,6 +3085,40 @@ fu_device_set_id(FuDevice *self, const gchar *id)
 	}
 }
 
+static void
+fu_device_ensure_version_key(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_clear_pointer(&priv->version_key, fu_version_key_free);
+	priv->version_key =
+	    fu_version_key_new(fu_device_get_version(self), fu_device_get_version_format(self));
+}
+
+/**
+ * fu_device_get_version_key:
+ * @self: a #FuDevice
+ *
+ * Gets the device version parsed using the device version format, which can be used to compare
+ * versions many times without allocating memory.
+ *
+ * Returns: (nullable): a #FuVersionKey, or %NULL if the version is unset
+ *
+ * Since: 2.0.0
+ **/
+const FuVersionKey *
+fu_device_get_version_key(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
+
+	/* the version may have been set using fwupd_device_set_version() */
+	if (!fu_version_key_matches(priv->version_key,
+				    fu_device_get_version(self),
+				    fu_device_get_version_format(self)))
+		fu_device_ensure_version_key(self);
+	return priv->version_key;
+}
+
 /**
  * fu_device_set_version_format:
  * @self: a #FuDevice
@@ -2985,6 +3143,7 @@ fu_device_set_version_format(FuDevice *self, FwupdVersionFormat fmt)
 			fwupd_version_format_to_string(fmt));
 	}
 	fwupd_device_set_version_format(FWUPD_DEVICE(self), fmt);
+	fu_device_ensure_version_key(self);
 
 	/* convert this, now we know */
 	if (device_class->convert_version != NULL && fu_device_get_version(self) != NULL &&
@@ -3036,6 +3195,7 @@ fu_device_set_version(FuDevice *self, const gchar *version)
 				version_safe);
 		}
 		fwupd_device_set_version(FWUPD_DEVICE(self), version_safe);
+		fu_device_ensure_version_key(self);
 	}
 }
 
@@ -4245,6 +4405,8 @@ fu_device_to_string_impl(FuDevice *self, guint idt, GString *str)
 	fwupd_codec_string_append(str, idt, "ProxyGuid", priv->proxy_guid);
 	fwupd_codec_string_append_int(str, idt, "RemoveDelay", priv->remove_delay);
 	fwupd_codec_string_append_int(str, idt, "AcquiesceDelay", priv->acquiesce_delay);
+	fwupd_codec_string_append_int(str, idt, "RetryCount", priv->retry_cnt);
+	fwupd_codec_string_append_int(str, idt, "SleepMs", priv->sleep_ms);
 	fwupd_codec_string_append(str, idt, "CustomFlags", priv->custom_flags);
 	if (priv->specialized_gtype != G_TYPE_INVALID)
 		fwupd_codec_string_append(str, idt, "GType", g_type_name(priv->specialized_gtype));
@@ -4468,6 +4630,25 @@ fu_device_get_results(FuDevice *self, GError **error)
 	return device_class->get_results(self, error);
 }
 
+/* sleeps are recorded on the progress of the vfunc being run, and the progress of any outer
+ * vfunc is restored when it returns; the returned value is passed to fu_device_pop_progress() */
+static FuProgress *
+fu_device_push_progress(FuDevice *self, FuProgress *progress)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuProgress *progress_old = g_steal_pointer(&priv->progress);
+	priv->progress = g_object_ref(progress);
+	return progress_old;
+}
+
+static void
+fu_device_pop_progress(FuDevice *self, FuProgress *progress_old)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_clear_object(&priv->progress);
+	priv->progress = progress_old;
+}
+
 /**
  * fu_device_write_firmware:
  * @self: a #FuDevice
@@ -4491,6 +4672,8 @@ fu_device_write_firmware(FuDevice *self,
 {
 	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
 	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuProgress *progress_old;
+	gboolean ret;
 	g_autoptr(FuFirmware) firmware = NULL;
 	g_autofree gchar *str = NULL;
 
@@ -4523,8 +4706,10 @@ fu_device_write_firmware(FuDevice *self,
 	fu_progress_step_done(progress);
 
 	/* call vfunc */
-	g_set_object(&priv->progress, fu_progress_get_child(progress));
-	if (!device_class->write_firmware(self, firmware, priv->progress, flags, error))
+	progress_old = fu_device_push_progress(self, fu_progress_get_child(progress));
+	ret = device_class->write_firmware(self, firmware, priv->progress, flags, error);
+	fu_device_pop_progress(self, progress_old);
+	if (!ret)
 		return FALSE;
 	fu_progress_step_done(progress);
 
@@ -4653,7 +4838,6 @@ FuFirmware *
 fu_device_read_firmware(FuDevice *self, FuProgress *progress, GError **error)
 {
 	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
-	FuDevicePrivate *priv = GET_PRIVATE(self);
 	g_autoptr(GBytes) fw = NULL;
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
@@ -4670,9 +4854,12 @@ fu_device_read_firmware(FuDevice *self, FuProgress *progress, GError **error)
 	}
 
 	/* call vfunc */
-	g_set_object(&priv->progress, progress);
-	if (device_class->read_firmware != NULL)
-		return device_class->read_firmware(self, progress, error);
+	if (device_class->read_firmware != NULL) {
+		FuProgress *progress_old = fu_device_push_progress(self, progress);
+		FuFirmware *firmware = device_class->read_firmware(self, progress, error);
+		fu_device_pop_progress(self, progress_old);
+		return firmware;
+	}
 
 	/* use the default FuFirmware when only ->dump_firmware is provided */
 	fw = fu_device_dump_firmware(self, progress, error);
@@ -4700,7 +4887,8 @@ GBytes *
 fu_device_dump_firmware(FuDevice *self, FuProgress *progress, GError **error)
 {
 	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
-	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuProgress *progress_old;
+	GBytes *fw;
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
 	g_return_val_if_fail(FU_IS_PROGRESS(progress), NULL);
@@ -4716,8 +4904,10 @@ fu_device_dump_firmware(FuDevice *self, FuProgress *progress, GError **error)
 	}
 
 	/* proxy */
-	g_set_object(&priv->progress, progress);
-	return device_class->dump_firmware(self, progress, error);
+	progress_old = fu_device_push_progress(self, progress);
+	fw = device_class->dump_firmware(self, progress, error);
+	fu_device_pop_progress(self, progress_old);
+	return fw;
 }
 
 /**
@@ -4754,7 +4944,8 @@ gboolean
 fu_device_detach_full(FuDevice *self, FuProgress *progress, GError **error)
 {
 	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
-	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuProgress *progress_old;
+	gboolean ret;
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
@@ -4765,8 +4956,10 @@ fu_device_detach_full(FuDevice *self, FuProgress *progress, GError **error)
 		return TRUE;
 
 	/* call vfunc */
-	g_set_object(&priv->progress, progress);
-	return device_class->detach(self, progress, error);
+	progress_old = fu_device_push_progress(self, progress);
+	ret = device_class->detach(self, progress, error);
+	fu_device_pop_progress(self, progress_old);
+	return ret;
 }
 
 /**
@@ -4803,7 +4996,8 @@ gboolean
 fu_device_attach_full(FuDevice *self, FuProgress *progress, GError **error)
 {
 	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
-	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuProgress *progress_old;
+	gboolean ret;
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
@@ -4814,8 +5008,10 @@ fu_device_attach_full(FuDevice *self, FuProgress *progress, GError **error)
 		return TRUE;
 
 	/* call vfunc */
-	g_set_object(&priv->progress, progress);
-	return device_class->attach(self, progress, error);
+	progress_old = fu_device_push_progress(self, progress);
+	ret = device_class->attach(self, progress, error);
+	fu_device_pop_progress(self, progress_old);
+	return ret;
 }
 
 /**
@@ -4864,18 +5060,26 @@ fu_device_prepare(FuDevice *self, FuProgress *progress, FwupdInstallFlags flags,
 {
 	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
 	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuProgress *progress_old;
+	gboolean ret;
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	/* only count the sleeps and retries for this update */
+	priv->sleep_ms = 0;
+	priv->retry_cnt = 0;
+
 	/* no plugin-specific method */
 	if (device_class->prepare == NULL)
 		return TRUE;
 
 	/* call vfunc */
-	g_set_object(&priv->progress, progress);
-	return device_class->prepare(self, progress, flags, error);
+	progress_old = fu_device_push_progress(self, progress);
+	ret = device_class->prepare(self, progress, flags, error);
+	fu_device_pop_progress(self, progress_old);
+	return ret;
 }
 
 /**
@@ -4896,7 +5100,8 @@ gboolean
 fu_device_cleanup(FuDevice *self, FuProgress *progress, FwupdInstallFlags flags, GError **error)
 {
 	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
-	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuProgress *progress_old;
+	gboolean ret;
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
@@ -4907,8 +5112,10 @@ fu_device_cleanup(FuDevice *self, FuProgress *progress, FwupdInstallFlags flags,
 		return TRUE;
 
 	/* call vfunc */
-	g_set_object(&priv->progress, progress);
-	return device_class->cleanup(self, progress, flags, error);
+	progress_old = fu_device_push_progress(self, progress);
+	ret = device_class->cleanup(self, progress, flags, error);
+	fu_device_pop_progress(self, progress_old);
+	return ret;
 }
 
 static gboolean
@@ -5347,7 +5554,6 @@ gboolean
 fu_device_activate(FuDevice *self, FuProgress *progress, GError **error)
 {
 	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
-	FuDevicePrivate *priv = GET_PRIVATE(self);
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
@@ -5355,8 +5561,10 @@ fu_device_activate(FuDevice *self, FuProgress *progress, GError **error)
 
 	/* subclassed */
 	if (device_class->activate != NULL) {
-		g_set_object(&priv->progress, progress);
-		if (!device_class->activate(self, progress, error))
+		FuProgress *progress_old = fu_device_push_progress(self, progress);
+		gboolean ret = device_class->activate(self, progress, error);
+		fu_device_pop_progress(self, progress_old);
+		if (!ret)
 			return FALSE;
 	}
 
@@ -5416,12 +5624,45 @@ fu_device_report_metadata_pre(FuDevice *self)
 	return g_steal_pointer(&metadata);
 }
 
+/**
+ * fu_device_add_report_metadata_timing:
+ * @self: a #FuDevice
+ * @metadata: a #GHashTable of key:value
+ *
+ * Adds the total time spent in fu_device_sleep() and the number of failed retries since the
+ * device was last prepared for an update, if either is non-zero.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_device_add_report_metadata_timing(FuDevice *self, GHashTable *metadata)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+
+	g_return_if_fail(FU_IS_DEVICE(self));
+	g_return_if_fail(metadata != NULL);
+
+	if (priv->sleep_ms > 0) {
+		g_hash_table_insert(metadata,
+				    g_strdup("DeviceSleepMs"),
+				    g_strdup_printf("%" G_GUINT64_FORMAT, priv->sleep_ms));
+	}
+	if (priv->retry_cnt > 0) {
+		g_hash_table_insert(metadata,
+				    g_strdup("DeviceRetryCount"),
+				    g_strdup_printf("%u", priv->retry_cnt));
+	}
+}
+
 /**
  * fu_device_report_metadata_post:
  * @self: a #FuDevice
  *
  * Collects metadata that would be useful for debugging a failed update report.
  *
+ * The total time spent in fu_device_sleep() and the number of failed retries are also included,
+ * so that slow updates can be attributed to fixed delays.
+ *
  * Returns: (transfer full) (nullable): a #GHashTable, or %NULL if there is no data
  *
  * Since: 1.5.0
@@ -5430,17 +5671,21 @@ GHashTable *
 fu_device_report_metadata_post(FuDevice *self)
 {
 	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
+	FuDevicePrivate *priv = GET_PRIVATE(self);
 	g_autoptr(GHashTable) metadata = NULL;
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
 
 	/* not implemented */
-	if (device_class->report_metadata_post == NULL)
+	if (device_class->report_metadata_post == NULL && priv->sleep_ms == 0 &&
+	    priv->retry_cnt == 0)
 		return NULL;
 
 	/* metadata for all devices */
 	metadata = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
-	device_class->report_metadata_post(self, metadata);
+	fu_device_add_report_metadata_timing(self, metadata);
+	if (device_class->report_metadata_post != NULL)
+		device_class->report_metadata_post(self, metadata);
 	return g_steal_pointer(&metadata);
 }
 
@@ -5645,6 +5890,10 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 		fu_device_set_proxy_guid(self, priv_donor->proxy_guid);
 	if (priv->custom_flags == NULL && priv_donor->custom_flags != NULL)
 		fu_device_set_custom_flags(self, priv_donor->custom_flags);
+	if (priv->sleep_ms == 0)
+		priv->sleep_ms = priv_donor->sleep_ms;
+	if (priv->retry_cnt == 0)
+		priv->retry_cnt = priv_donor->retry_cnt;
 	if (priv->ctx == NULL)
 		fu_device_set_context(self, fu_device_get_context(donor));
 	if (priv_donor->parent_guids != NULL) {
@@ -5744,10 +5993,16 @@ void
 fu_device_replace(FuDevice *self, FuDevice *donor)
 {
 	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuDevicePrivate *priv_donor = GET_PRIVATE(donor);
 
 	g_return_if_fail(FU_IS_DEVICE(self));
 	g_return_if_fail(FU_IS_DEVICE(donor));
 
+	/* the update may have started on the old device */
+	priv->sleep_ms += priv_donor->sleep_ms;
+	priv->retry_cnt += priv_donor->retry_cnt;
+
 	/* optional subclass */
 	if (device_class->replace != NULL)
 		device_class->replace(self, donor);
@@ -6746,7 +7001,7 @@ fu_device_init(FuDevice *self)
 {
 	FuDevicePrivate *priv = GET_PRIVATE(self);
 	priv->order = G_MAXINT;
-	priv->possible_plugins = g_ptr_array_new_with_free_func(g_free);
+	priv->possible_plugins = g_ptr_array_new();
 	priv->acquiesce_delay = 50; /* ms */
 	priv->notify_flags_handler_id = g_signal_connect(FWUPD_DEVICE(self),
 							 "notify::flags",
@@ -6794,6 +7049,8 @@ fu_device_finalize(GObject *object)
 		g_ptr_array_unref(priv->instance_id_quirks);
 	if (priv->parent_guids != NULL)
 		g_ptr_array_unref(priv->parent_guids);
+	if (priv->version_key != NULL)
+		fu_version_key_free(priv->version_key);
 	g_ptr_array_unref(priv->possible_plugins);
 	g_free(priv->equivalent_id);
 	g_free(priv->physical_id);
@@ -683,6 +683,8 @@ void
 fu_device_set_id(FuDevice *self, const gchar *id) G_GNUC_NON_NULL(1);
 void
 fu_device_set_version_format(FuDevice *self, FwupdVersionFormat fmt) G_GNUC_NON_NULL(1);
+const FuVersionKey *
+fu_device_get_version_key(FuDevice *self) G_GNUC_NON_NULL(1);
 void
 fu_device_set_version(FuDevice *self, const gchar *version) G_GNUC_NON_NULL(1);
 void
@@ -868,6 +870,13 @@ fu_device_retry_full(FuDevice *self,
 		     guint delay,
 		     gpointer user_data,
 		     GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+gboolean
+fu_device_retry_backoff(FuDevice *self,
+			FuDeviceRetryFunc func,
+			guint delay,
+			guint timeout,
+			gpointer user_data,
+			GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
 void
 fu_device_sleep(FuDevice *self, guint delay_ms) G_GNUC_NON_NULL(1);
 void
@@ -18,6 +18,8 @@ fu_efivar_exists_impl(const gchar *guid, const gchar *name) G_GNUC_NON_NULL(1);
 GFileMonitor *
 fu_efivar_get_monitor_impl(const gchar *guid, const gchar *name, GError **error)
     G_GNUC_NON_NULL(1, 2);
+GFileMonitor *
+fu_efivar_get_directory_monitor_impl(GError **error);
 gboolean
 fu_efivar_get_data_impl(const gchar *guid,
 			const gchar *name,
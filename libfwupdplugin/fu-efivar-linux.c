@@ -335,6 +335,21 @@ fu_efivar_get_monitor_impl(const gchar *guid, const gchar *name, GError **error)
 	return g_steal_pointer(&monitor);
 }
 
+GFileMonitor *
+fu_efivar_get_directory_monitor_impl(GError **error)
+{
+	g_autofree gchar *efivardir = fu_efivar_get_path();
+	g_autoptr(GFile) file = g_file_new_for_path(efivardir);
+	g_autoptr(GFileMonitor) monitor = NULL;
+
+	monitor = g_file_monitor_directory(file, G_FILE_MONITOR_WATCH_MOVES, NULL, error);
+	if (monitor == NULL) {
+		fwupd_error_convert(error);
+		return NULL;
+	}
+	return g_steal_pointer(&monitor);
+}
+
 guint64
 fu_efivar_space_used_impl(GError **error)
 {
@@ -251,6 +251,16 @@ fu_efivar_get_monitor_impl(const gchar *guid, const gchar *name, GError **error)
 	return NULL;
 }
 
+GFileMonitor *
+fu_efivar_get_directory_monitor_impl(GError **error)
+{
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "monitoring EFI variables is not supported on Windows");
+	return NULL;
+}
+
 guint64
 fu_efivar_space_used_impl(GError **error)
 {
@@ -7,10 +7,176 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "fwupd-error.h"
 
+#include "fu-efi-load-option.h"
 #include "fu-efivar-impl.h"
 
+typedef struct {
+	GBytes *blob;
+	guint32 attr;
+} FuEfivarCacheItem;
+
+/* the same variables are read many times by different plugins */
+static GMutex fu_efivar_cache_mutex;
+static GHashTable *fu_efivar_cache = NULL; /* (nullable) basename:FuEfivarCacheItem */
+static GFileMonitor *fu_efivar_cache_monitor = NULL; /* (nullable) of the whole directory */
+static gboolean fu_efivar_cache_monitor_failed = FALSE;
+static guint fu_efivar_cache_hits = 0;
+static guint fu_efivar_cache_misses = 0;
+
+static void
+fu_efivar_cache_item_free(FuEfivarCacheItem *item)
+{
+	g_bytes_unref(item->blob);
+	g_free(item);
+}
+
+/* this matches the basename of the file in efivarfs */
+static gchar *
+fu_efivar_cache_get_key(const gchar *guid, const gchar *name)
+{
+	return g_strdup_printf("%s-%s", name, guid);
+}
+
+static void
+fu_efivar_cache_remove(const gchar *key)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_efivar_cache_mutex);
+	if (fu_efivar_cache != NULL)
+		g_hash_table_remove(fu_efivar_cache, key);
+}
+
+static void
+fu_efivar_cache_monitor_changed_cb(GFileMonitor *monitor,
+				   GFile *file,
+				   GFile *other_file,
+				   GFileMonitorEvent event_type,
+				   gpointer user_data)
+{
+	g_autofree gchar *basename = g_file_get_basename(file);
+	fu_efivar_cache_remove(basename);
+	if (other_file != NULL) {
+		g_autofree gchar *basename_other = g_file_get_basename(other_file);
+		fu_efivar_cache_remove(basename_other);
+	}
+}
+
+/* a single monitor covers every variable, as there can be hundreds of them */
+static gboolean
+fu_efivar_cache_ensure_monitor(void)
+{
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_efivar_cache_mutex);
+
+	if (fu_efivar_cache_monitor != NULL)
+		return TRUE;
+	if (fu_efivar_cache_monitor_failed)
+		return FALSE;
+	fu_efivar_cache_monitor = fu_efivar_get_directory_monitor_impl(&error_local);
+	if (fu_efivar_cache_monitor == NULL) {
+		g_debug("not caching EFI variables: %s", error_local->message);
+		fu_efivar_cache_monitor_failed = TRUE;
+		return FALSE;
+	}
+	g_signal_connect(fu_efivar_cache_monitor,
+			 "changed",
+			 G_CALLBACK(fu_efivar_cache_monitor_changed_cb),
+			 NULL);
+	return TRUE;
+}
+
+static gboolean
+fu_efivar_cache_lookup(const gchar *key, guint8 **data, gsize *data_sz, guint32 *attr)
+{
+	FuEfivarCacheItem *item = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_efivar_cache_mutex);
+
+	if (fu_efivar_cache != NULL)
+		item = g_hash_table_lookup(fu_efivar_cache, key);
+	if (item == NULL) {
+		fu_efivar_cache_misses++;
+		return FALSE;
+	}
+	fu_efivar_cache_hits++;
+	if (data != NULL)
+		*data = g_memdup2(g_bytes_get_data(item->blob, NULL), g_bytes_get_size(item->blob));
+	if (data_sz != NULL)
+		*data_sz = g_bytes_get_size(item->blob);
+	if (attr != NULL)
+		*attr = item->attr;
+	return TRUE;
+}
+
+static void
+fu_efivar_cache_add(const gchar *key, GBytes *blob, guint32 attr)
+{
+	FuEfivarCacheItem *item = g_new0(FuEfivarCacheItem, 1);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_efivar_cache_mutex);
+
+	item->blob = g_bytes_ref(blob);
+	item->attr = attr;
+	if (fu_efivar_cache == NULL) {
+		fu_efivar_cache =
+		    g_hash_table_new_full(g_str_hash,
+					  g_str_equal,
+					  g_free,
+					  (GDestroyNotify)fu_efivar_cache_item_free);
+	}
+	g_hash_table_replace(fu_efivar_cache, g_strdup(key), item);
+}
+
+/**
+ * fu_efivar_invalidate_cache:
+ *
+ * Drops all the cached EFI variable data, which is useful if variables may have been changed
+ * without using the fu_efivar_set_data() or fu_efivar_delete() functions.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_efivar_invalidate_cache(void)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_efivar_cache_mutex);
+	if (fu_efivar_cache != NULL)
+		g_hash_table_remove_all(fu_efivar_cache);
+}
+
+/**
+ * fu_efivar_get_cache_hits:
+ *
+ * Gets the number of times that EFI variable data was returned from the cache rather than
+ * read from the firmware.
+ *
+ * Returns: integer
+ *
+ * Since: 2.0.0
+ **/
+guint
+fu_efivar_get_cache_hits(void)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_efivar_cache_mutex);
+	return fu_efivar_cache_hits;
+}
+
+/**
+ * fu_efivar_get_cache_misses:
+ *
+ * Gets the number of times that EFI variable data could not be returned from the cache.
+ *
+ * Returns: integer
+ *
+ * Since: 2.0.0
+ **/
+guint
+fu_efivar_get_cache_misses(void)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_efivar_cache_mutex);
+	return fu_efivar_cache_misses;
+}
+
 /**
  * fu_efivar_supported:
  * @error: #GError
@@ -42,9 +208,14 @@ fu_efivar_supported(GError **error)
 gboolean
 fu_efivar_delete(const gchar *guid, const gchar *name, GError **error)
 {
+	g_autofree gchar *key = NULL;
+
 	g_return_val_if_fail(guid != NULL, FALSE);
 	g_return_val_if_fail(name != NULL, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	key = fu_efivar_cache_get_key(guid, name);
+	fu_efivar_cache_remove(key);
 	return fu_efivar_delete_impl(guid, name, error);
 }
 
@@ -66,6 +237,7 @@ fu_efivar_delete_with_glob(const gchar *guid, const gchar *name_glob, GError **e
 	g_return_val_if_fail(guid != NULL, FALSE);
 	g_return_val_if_fail(name_glob != NULL, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	fu_efivar_invalidate_cache();
 	return fu_efivar_delete_with_glob_impl(guid, name_glob, error);
 }
 
@@ -96,7 +268,10 @@ fu_efivar_exists(const gchar *guid, const gchar *name)
  * @attr: Attributes
  * @error: (nullable): optional return location for an error
  *
- * Gets the data from a UEFI variable in NVRAM
+ * Gets the data from a UEFI variable in NVRAM.
+ *
+ * If the variable can be monitored for changes then the data is cached until the variable is
+ * changed or deleted.
  *
  * Returns: %TRUE on success
  *
@@ -110,10 +285,39 @@ fu_efivar_get_data(const gchar *guid,
 		   guint32 *attr,
 		   GError **error)
 {
+	gsize data_sz_tmp = 0;
+	guint32 attr_tmp = 0;
+	g_autofree gchar *key = NULL;
+	g_autofree guint8 *data_tmp = NULL;
+	g_autoptr(GBytes) blob = NULL;
+
 	g_return_val_if_fail(guid != NULL, FALSE);
 	g_return_val_if_fail(name != NULL, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
-	return fu_efivar_get_data_impl(guid, name, data, data_sz, attr, error);
+
+	/* already read */
+	key = fu_efivar_cache_get_key(guid, name);
+	if (fu_efivar_cache_lookup(key, data, data_sz, attr))
+		return TRUE;
+
+	/* not supported on this platform, so never cache the data */
+	if (!fu_efivar_cache_ensure_monitor())
+		return fu_efivar_get_data_impl(guid, name, data, data_sz, attr, error);
+
+	/* the monitor is created first so that changes made before the read are not lost */
+	if (!fu_efivar_get_data_impl(guid, name, &data_tmp, &data_sz_tmp, &attr_tmp, error))
+		return FALSE;
+	blob = g_bytes_new(data_tmp, data_sz_tmp);
+	fu_efivar_cache_add(key, blob, attr_tmp);
+
+	/* success */
+	if (data != NULL)
+		*data = g_steal_pointer(&data_tmp);
+	if (data_sz != NULL)
+		*data_sz = data_sz_tmp;
+	if (attr != NULL)
+		*attr = attr_tmp;
+	return TRUE;
 }
 
 /**
@@ -164,6 +368,75 @@ fu_efivar_get_names(const gchar *guid, GError **error)
 	return fu_efivar_get_names_impl(guid, error);
 }
 
+static gint
+fu_efivar_boot_entry_sort_cb(gconstpointer a, gconstpointer b)
+{
+	FuFirmware *firmware1 = *((FuFirmware **)a);
+	FuFirmware *firmware2 = *((FuFirmware **)b);
+	if (fu_firmware_get_idx(firmware1) < fu_firmware_get_idx(firmware2))
+		return -1;
+	if (fu_firmware_get_idx(firmware1) > fu_firmware_get_idx(firmware2))
+		return 1;
+	return 0;
+}
+
+/**
+ * fu_efivar_get_boot_entries:
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets all the `Boot####` load options that exist, using a single directory listing rather than
+ * trying to read every possible entry number. The boot entry number is set as the firmware
+ * index, and entries that cannot be read or parsed are ignored.
+ *
+ * Returns: (transfer container) (element-type FuEfiLoadOption): load options, sorted by index
+ *
+ * Since: 2.0.0
+ **/
+GPtrArray *
+fu_efivar_get_boot_entries(GError **error)
+{
+	g_autoptr(GPtrArray) names = NULL;
+	g_autoptr(GPtrArray) entries = g_ptr_array_new_with_free_func(g_object_unref);
+
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	names = fu_efivar_get_names(FU_EFIVAR_GUID_EFI_GLOBAL, error);
+	if (names == NULL)
+		return NULL;
+	for (guint i = 0; i < names->len; i++) {
+		const gchar *name = g_ptr_array_index(names, i);
+		guint64 value = 0;
+		g_autoptr(FuEfiLoadOption) loadopt = NULL;
+		g_autoptr(GBytes) blob = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		/* not BootXXXX */
+		if (!g_str_has_prefix(name, "Boot") || strlen(name) != 8)
+			continue;
+		if (!g_ascii_string_to_unsigned(name + 4, 16, 0, G_MAXUINT16, &value, NULL))
+			continue;
+
+		/* parse key */
+		blob = fu_efivar_get_data_bytes(FU_EFIVAR_GUID_EFI_GLOBAL, name, NULL, &error_local);
+		if (blob == NULL) {
+			g_debug("failed to get data for name %s: %s", name, error_local->message);
+			continue;
+		}
+		loadopt = fu_efi_load_option_new();
+		if (!fu_firmware_parse(FU_FIRMWARE(loadopt),
+				       blob,
+				       FWUPD_INSTALL_FLAG_NONE,
+				       &error_local)) {
+			g_debug("%s -> load option was invalid: %s", name, error_local->message);
+			continue;
+		}
+		fu_firmware_set_idx(FU_FIRMWARE(loadopt), value);
+		g_ptr_array_add(entries, g_steal_pointer(&loadopt));
+	}
+	g_ptr_array_sort(entries, fu_efivar_boot_entry_sort_cb);
+	return g_steal_pointer(&entries);
+}
+
 /**
  * fu_efivar_get_monitor:
  * @guid: Globally unique identifier
@@ -224,10 +497,15 @@ fu_efivar_set_data(const gchar *guid,
 		   guint32 attr,
 		   GError **error)
 {
+	g_autofree gchar *key = NULL;
+
 	g_return_val_if_fail(guid != NULL, FALSE);
 	g_return_val_if_fail(name != NULL, FALSE);
 	g_return_val_if_fail(data != NULL, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	key = fu_efivar_cache_get_key(guid, name);
+	fu_efivar_cache_remove(key);
 	return fu_efivar_set_data_impl(guid, name, data, sz, attr, error);
 }
 
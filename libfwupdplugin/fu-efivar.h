@@ -65,5 +65,13 @@ fu_efivar_delete_with_glob(const gchar *guid,
 			   GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
 GPtrArray *
 fu_efivar_get_names(const gchar *guid, GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+GPtrArray *
+fu_efivar_get_boot_entries(GError **error) G_GNUC_WARN_UNUSED_RESULT;
 gboolean
 fu_efivar_secure_boot_enabled(GError **error);
+void
+fu_efivar_invalidate_cache(void);
+guint
+fu_efivar_get_cache_hits(void);
+guint
+fu_efivar_get_cache_misses(void);
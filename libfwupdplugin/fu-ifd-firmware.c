@@ -44,6 +44,9 @@ typedef struct {
 	guint32 illegal_jedec;
 	guint32 illegal_jedec1;
 	guint32 *flash_descriptor_regs;
+	gboolean lazy_regions;
+	FwupdInstallFlags parse_flags; /* used when parsing lazy regions */
+	GHashTable *region_checksums;  /* (element-type guint utf8) */
 } FuIfdFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuIfdFirmware, fu_ifd_firmware, FU_TYPE_FIRMWARE)
@@ -111,6 +114,10 @@ fu_ifd_firmware_parse(FuFirmware *firmware,
 	g_autoptr(GByteArray) st_fcba = NULL;
 	g_autoptr(GByteArray) st_fdbar = NULL;
 
+	/* any lazy regions are parsed later using the same flags */
+	priv->parse_flags = flags | FWUPD_INSTALL_FLAG_NO_SEARCH;
+	g_hash_table_remove_all(priv->region_checksums);
+
 	/* check size */
 	if (!fu_input_stream_size(stream, &streamsz, error))
 		return FALSE;
@@ -200,12 +207,18 @@ fu_ifd_firmware_parse(FuFirmware *firmware,
 		} else {
 			img = fu_ifd_image_new();
 		}
-		if (!fu_firmware_parse_stream(img,
-					      partial_stream,
-					      0x0,
-					      flags | FWUPD_INSTALL_FLAG_NO_SEARCH,
-					      error))
-			return FALSE;
+		if (i == FU_IFD_REGION_BIOS && priv->lazy_regions) {
+			/* parsed by fu_ifd_firmware_get_region() */
+			if (!fu_firmware_set_stream(img, partial_stream, error))
+				return FALSE;
+		} else {
+			if (!fu_firmware_parse_stream(img,
+						      partial_stream,
+						      0x0,
+						      priv->parse_flags,
+						      error))
+				return FALSE;
+		}
 		fu_firmware_set_addr(img, freg_base);
 		fu_firmware_set_idx(img, i);
 		if (freg_str != NULL)
@@ -225,6 +238,113 @@ fu_ifd_firmware_parse(FuFirmware *firmware,
 	return TRUE;
 }
 
+/**
+ * fu_ifd_firmware_set_lazy_regions:
+ * @self: a #FuIfdFirmware
+ * @lazy_regions: boolean
+ *
+ * Sets if the contents of each region should only be parsed when first requested using
+ * fu_ifd_firmware_get_region(). This has to be set before the firmware is parsed, and means the
+ * BIOS region is not searched for EFI volumes when only the region layout is required.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_ifd_firmware_set_lazy_regions(FuIfdFirmware *self, gboolean lazy_regions)
+{
+	FuIfdFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_IFD_FIRMWARE(self));
+	priv->lazy_regions = lazy_regions;
+}
+
+/**
+ * fu_ifd_firmware_get_region:
+ * @self: a #FuIfdFirmware
+ * @region: a #FuIfdRegion, e.g. %FU_IFD_REGION_BIOS
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the image for a region, parsing the region contents first if required.
+ *
+ * Returns: (transfer full): a #FuFirmware, or %NULL on error
+ *
+ * Since: 2.0.0
+ **/
+FuFirmware *
+fu_ifd_firmware_get_region(FuIfdFirmware *self, FuIfdRegion region, GError **error)
+{
+	FuIfdFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(FuFirmware) img = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+
+	g_return_val_if_fail(FU_IS_IFD_FIRMWARE(self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	img = fu_firmware_get_image_by_idx(FU_FIRMWARE(self), region, error);
+	if (img == NULL)
+		return NULL;
+
+	/* already parsed */
+	if (fu_firmware_has_flag(img, FU_FIRMWARE_FLAG_DONE_PARSE))
+		return g_steal_pointer(&img);
+
+	/* parse the region in place, so the image order and any references stay valid */
+	stream = fu_firmware_get_stream(img, error);
+	if (stream == NULL)
+		return NULL;
+	if (!fu_firmware_parse_stream(img, stream, 0x0, priv->parse_flags, error))
+		return NULL;
+	return g_steal_pointer(&img);
+}
+
+/**
+ * fu_ifd_firmware_get_region_checksum:
+ * @self: a #FuIfdFirmware
+ * @region: a #FuIfdRegion, e.g. %FU_IFD_REGION_ME
+ * @csum_kind: a checksum type, e.g. %G_CHECKSUM_SHA256
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the checksum of the raw region contents, without parsing the region. The result is cached
+ * so that comparing the same region of several images only hashes each region once.
+ *
+ * Returns: (transfer full): a checksum, or %NULL on error
+ *
+ * Since: 2.0.0
+ **/
+gchar *
+fu_ifd_firmware_get_region_checksum(FuIfdFirmware *self,
+				    FuIfdRegion region,
+				    GChecksumType csum_kind,
+				    GError **error)
+{
+	FuIfdFirmwarePrivate *priv = GET_PRIVATE(self);
+	const gchar *csum;
+	guint key = ((guint)region << 8) | (guint)csum_kind;
+	g_autofree gchar *csum_new = NULL;
+	g_autoptr(FuFirmware) img = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+
+	g_return_val_if_fail(FU_IS_IFD_FIRMWARE(self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* cached */
+	csum = g_hash_table_lookup(priv->region_checksums, GUINT_TO_POINTER(key));
+	if (csum != NULL)
+		return g_strdup(csum);
+
+	/* hash the region stream rather than the parsed image */
+	img = fu_firmware_get_image_by_idx(FU_FIRMWARE(self), region, error);
+	if (img == NULL)
+		return NULL;
+	stream = fu_firmware_get_stream(img, error);
+	if (stream == NULL)
+		return NULL;
+	csum_new = fu_input_stream_compute_checksum(stream, csum_kind, error);
+	if (csum_new == NULL)
+		return NULL;
+	g_hash_table_insert(priv->region_checksums, GUINT_TO_POINTER(key), g_strdup(csum_new));
+	return g_steal_pointer(&csum_new);
+}
+
 /**
  * fu_ifd_firmware_check_jedec_cmd:
  * @self: a #FuIfdFirmware
@@ -427,6 +547,7 @@ fu_ifd_firmware_init(FuIfdFirmware *self)
 	priv->flash_master[3] = 0x00800900;
 	priv->flash_ich_strap_base_addr = 0x100;
 	priv->flash_mch_strap_base_addr = 0x300;
+	priv->region_checksums = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
 	g_type_ensure(FU_TYPE_IFD_BIOS);
 	g_type_ensure(FU_TYPE_IFD_IMAGE);
 	g_type_ensure(FU_TYPE_EFI_VOLUME);
@@ -438,6 +559,7 @@ fu_ifd_firmware_finalize(GObject *object)
 	FuIfdFirmware *self = FU_IFD_FIRMWARE(object);
 	FuIfdFirmwarePrivate *priv = GET_PRIVATE(self);
 	g_free(priv->flash_descriptor_regs);
+	g_hash_table_unref(priv->region_checksums);
 	G_OBJECT_CLASS(fu_ifd_firmware_parent_class)->finalize(object);
 }
 
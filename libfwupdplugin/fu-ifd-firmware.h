@@ -7,6 +7,7 @@
 #pragma once
 
 #include "fu-firmware.h"
+#include "fu-ifd-common.h"
 
 #define FU_TYPE_IFD_FIRMWARE (fu_ifd_firmware_get_type())
 G_DECLARE_DERIVABLE_TYPE(FuIfdFirmware, fu_ifd_firmware, FU, IFD_FIRMWARE, FuFirmware)
@@ -19,3 +20,13 @@ FuFirmware *
 fu_ifd_firmware_new(void);
 gboolean
 fu_ifd_firmware_check_jedec_cmd(FuIfdFirmware *self, guint8 cmd) G_GNUC_NON_NULL(1);
+void
+fu_ifd_firmware_set_lazy_regions(FuIfdFirmware *self, gboolean lazy_regions) G_GNUC_NON_NULL(1);
+FuFirmware *
+fu_ifd_firmware_get_region(FuIfdFirmware *self, FuIfdRegion region, GError **error)
+    G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+gchar *
+fu_ifd_firmware_get_region_checksum(FuIfdFirmware *self,
+				    FuIfdRegion region,
+				    GChecksumType csum_kind,
+				    GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
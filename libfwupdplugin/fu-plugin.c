@@ -22,6 +22,7 @@
 #include "fu-kernel.h"
 #include "fu-path.h"
 #include "fu-plugin-private.h"
+#include "fu-runner-stats-private.h"
 #include "fu-security-attr.h"
 #include "fu-string.h"
 
@@ -53,6 +54,8 @@ typedef struct {
 	GFileMonitor *config_monitor;
 	FuPluginData *data;
 	FuPluginVfuncs vfuncs;
+	FuRunnerStats *runner_stats;
+	GMutex mutex; /* protects cache, devices and report_metadata for parallel installs */
 } FuPluginPrivate;
 
 enum { PROP_0, PROP_CONTEXT, PROP_LAST };
@@ -63,6 +66,7 @@ enum {
 	SIGNAL_DEVICE_REGISTER,
 	SIGNAL_RULES_CHANGED,
 	SIGNAL_CHECK_SUPPORTED,
+	SIGNAL_SECURITY_CHANGED,
 	SIGNAL_LAST
 };
 
@@ -171,8 +175,10 @@ gpointer
 fu_plugin_cache_lookup(FuPlugin *self, const gchar *id)
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_return_val_if_fail(FU_IS_PLUGIN(self), NULL);
 	g_return_val_if_fail(id != NULL, NULL);
+	locker = g_mutex_locker_new(&priv->mutex);
 	if (priv->cache == NULL)
 		return NULL;
 	return g_hash_table_lookup(priv->cache, id);
@@ -192,9 +198,11 @@ void
 fu_plugin_cache_add(FuPlugin *self, const gchar *id, gpointer dev)
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_return_if_fail(FU_IS_PLUGIN(self));
 	g_return_if_fail(id != NULL);
 	g_return_if_fail(G_IS_OBJECT(dev));
+	locker = g_mutex_locker_new(&priv->mutex);
 	if (priv->cache == NULL) {
 		priv->cache = g_hash_table_new_full(g_str_hash,
 						    g_str_equal,
@@ -217,8 +225,10 @@ void
 fu_plugin_cache_remove(FuPlugin *self, const gchar *id)
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_return_if_fail(FU_IS_PLUGIN(self));
 	g_return_if_fail(id != NULL);
+	locker = g_mutex_locker_new(&priv->mutex);
 	if (priv->cache == NULL)
 		return;
 	g_hash_table_remove(priv->cache, id);
@@ -492,8 +502,10 @@ fu_plugin_device_add(FuPlugin *self, FuDevice *device)
 	}
 
 	/* add to array */
+	g_mutex_lock(&priv->mutex);
 	fu_plugin_ensure_devices(self);
 	g_ptr_array_add(priv->devices, g_object_ref(device));
+	g_mutex_unlock(&priv->mutex);
 
 	/* proxy to device where required */
 	if (fu_plugin_has_flag(self, FWUPD_PLUGIN_FLAG_CLEAR_UPDATABLE)) {
@@ -547,7 +559,9 @@ GPtrArray *
 fu_plugin_get_devices(FuPlugin *self)
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_return_val_if_fail(FU_IS_PLUGIN(self), NULL);
+	locker = g_mutex_locker_new(&priv->mutex);
 	fu_plugin_ensure_devices(self);
 	return priv->devices;
 }
@@ -604,13 +618,32 @@ fu_plugin_device_remove(FuPlugin *self, FuDevice *device)
 	g_return_if_fail(FU_IS_DEVICE(device));
 
 	/* remove from array */
+	g_mutex_lock(&priv->mutex);
 	if (priv->devices != NULL)
 		g_ptr_array_remove(priv->devices, device);
+	g_mutex_unlock(&priv->mutex);
 
 	g_debug("emit removed from %s: %s", fu_plugin_get_name(self), fu_device_get_id(device));
 	g_signal_emit(self, signals[SIGNAL_DEVICE_REMOVED], 0, device);
 }
 
+/**
+ * fu_plugin_security_changed:
+ * @self: a #FuPlugin
+ *
+ * Informs the daemon that the HSI attributes added by this plugin may have changed.
+ *
+ * Unlike fu_context_security_changed(), only the attributes from this plugin are added again.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_plugin_security_changed(FuPlugin *self)
+{
+	g_return_if_fail(FU_IS_PLUGIN(self));
+	g_signal_emit(self, signals[SIGNAL_SECURITY_CHANGED], 0);
+}
+
 /**
  * fu_plugin_check_supported:
  * @self: a #FuPlugin
@@ -824,6 +857,71 @@ fu_plugin_device_read_firmware(FuPlugin *self,
 	return fu_device_attach_full(device, progress, error);
 }
 
+/* the number of plugin runners in progress on the calling thread */
+static GPrivate fu_plugin_runner_depth = G_PRIVATE_INIT(NULL);
+
+/* must be followed by exactly one fu_plugin_runner_stats_add() on the same thread */
+static gint64
+fu_plugin_runner_stats_begin(void)
+{
+	guint depth = GPOINTER_TO_UINT(g_private_get(&fu_plugin_runner_depth));
+	g_private_set(&fu_plugin_runner_depth, GUINT_TO_POINTER(depth + 1));
+	return g_get_monotonic_time();
+}
+
+/* @vfunc has to be a static string */
+static void
+fu_plugin_runner_stats_add(FuPlugin *self, const gchar *vfunc, gint64 begin_us, gboolean success)
+{
+	FuPluginPrivate *priv = GET_PRIVATE(self);
+	guint depth = GPOINTER_TO_UINT(g_private_get(&fu_plugin_runner_depth));
+
+	/* a runner called from another runner, e.g. ->device_created() from the default
+	 * ->backend_device_added(), is already included in the total of the outer runner */
+	g_private_set(&fu_plugin_runner_depth, GUINT_TO_POINTER(depth - 1));
+	fu_runner_stats_add(priv->runner_stats, vfunc, begin_us, depth > 1, success);
+}
+
+/**
+ * fu_plugin_add_runner_stats:
+ * @self: a #FuPlugin
+ * @builder: a #GVariantBuilder of type `aa{sv}`
+ *
+ * Adds the call count and latency of every vfunc that has been run.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_plugin_add_runner_stats(FuPlugin *self, GVariantBuilder *builder)
+{
+	FuPluginPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_PLUGIN(self));
+	g_return_if_fail(builder != NULL);
+	fu_runner_stats_add_variant(priv->runner_stats,
+				    "Plugin",
+				    fu_plugin_get_name(self),
+				    builder);
+}
+
+/**
+ * fu_plugin_get_runner_total_us:
+ * @self: a #FuPlugin
+ *
+ * Gets the total time spent in every vfunc that has been run, not including any vfuncs that
+ * were run from another plugin vfunc.
+ *
+ * Returns: time in microseconds
+ *
+ * Since: 2.0.0
+ **/
+guint64
+fu_plugin_get_runner_total_us(FuPlugin *self)
+{
+	FuPluginPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_PLUGIN(self), 0);
+	return fu_runner_stats_get_total_us(priv->runner_stats);
+}
+
 /**
  * fu_plugin_runner_startup:
  * @self: a #FuPlugin
@@ -839,6 +937,8 @@ gboolean
 fu_plugin_runner_startup(FuPlugin *self, FuProgress *progress, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -856,7 +956,10 @@ fu_plugin_runner_startup(FuPlugin *self, FuProgress *progress, GError **error)
 	/* optional */
 	if (vfuncs->startup != NULL) {
 		g_debug("startup(%s)", fu_plugin_get_name(self));
-		if (!vfuncs->startup(self, progress, &error_local)) {
+		begin_us = fu_plugin_runner_stats_begin();
+		ret = vfuncs->startup(self, progress, &error_local);
+		fu_plugin_runner_stats_add(self, "startup", begin_us, ret);
+		if (!ret) {
 			if (error_local == NULL) {
 				g_critical("unset plugin error in startup(%s)",
 					   fu_plugin_get_name(self));
@@ -892,6 +995,8 @@ gboolean
 fu_plugin_runner_ready(FuPlugin *self, FuProgress *progress, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -906,7 +1011,10 @@ fu_plugin_runner_ready(FuPlugin *self, FuProgress *progress, GError **error)
 
 	/* optional */
 	g_debug("ready(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->ready(self, progress, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = vfuncs->ready(self, progress, &error_local);
+	fu_plugin_runner_stats_add(self, "ready", begin_us, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in ready(%s)", fu_plugin_get_name(self));
 			g_set_error_literal(&error_local,
@@ -964,6 +1072,8 @@ fu_plugin_runner_device_generic(FuPlugin *self,
 				FuPluginDeviceFunc device_func,
 				GError **error)
 {
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -974,7 +1084,10 @@ fu_plugin_runner_device_generic(FuPlugin *self,
 	if (device_func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!device_func(self, device, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = device_func(self, device, &error_local);
+	fu_plugin_runner_stats_add(self, symbol_name + 10, begin_us, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in %s(%s)",
 				   fu_plugin_get_name(self),
@@ -1002,6 +1115,8 @@ fu_plugin_runner_device_generic_progress(FuPlugin *self,
 					 FuPluginDeviceProgressFunc device_func,
 					 GError **error)
 {
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -1012,7 +1127,10 @@ fu_plugin_runner_device_generic_progress(FuPlugin *self,
 	if (device_func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!device_func(self, device, progress, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = device_func(self, device, progress, &error_local);
+	fu_plugin_runner_stats_add(self, symbol_name + 10, begin_us, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in %s(%s)",
 				   fu_plugin_get_name(self),
@@ -1041,6 +1159,8 @@ fu_plugin_runner_flagged_device_generic(FuPlugin *self,
 					FuPluginFlaggedDeviceFunc func,
 					GError **error)
 {
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -1051,7 +1171,10 @@ fu_plugin_runner_flagged_device_generic(FuPlugin *self,
 	if (func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!func(self, device, progress, flags, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = func(self, device, progress, flags, &error_local);
+	fu_plugin_runner_stats_add(self, symbol_name + 10, begin_us, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in %s(%s)",
 				   fu_plugin_get_name(self),
@@ -1078,6 +1201,8 @@ fu_plugin_runner_device_array_generic(FuPlugin *self,
 				      FuPluginDeviceArrayFunc func,
 				      GError **error)
 {
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -1088,7 +1213,10 @@ fu_plugin_runner_device_array_generic(FuPlugin *self,
 	if (func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!func(self, devices, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = func(self, devices, &error_local);
+	fu_plugin_runner_stats_add(self, symbol_name + 10, begin_us, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in for %s(%s)",
 				   fu_plugin_get_name(self),
@@ -1125,6 +1253,8 @@ fu_plugin_runner_coldplug(FuPlugin *self, FuProgress *progress, GError **error)
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -1144,7 +1274,10 @@ fu_plugin_runner_coldplug(FuPlugin *self, FuProgress *progress, GError **error)
 	if (vfuncs->coldplug == NULL)
 		return TRUE;
 	g_debug("coldplug(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->coldplug(self, progress, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = vfuncs->coldplug(self, progress, &error_local);
+	fu_plugin_runner_stats_add(self, "coldplug", begin_us, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in coldplug(%s)", fu_plugin_get_name(self));
 			g_set_error_literal(&error_local,
@@ -1375,6 +1508,8 @@ gboolean
 fu_plugin_runner_reboot_cleanup(FuPlugin *self, FuDevice *device, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 begin_us;
 
 	/* optional */
 	if (fu_plugin_has_flag(self, FWUPD_PLUGIN_FLAG_DISABLED))
@@ -1382,7 +1517,10 @@ fu_plugin_runner_reboot_cleanup(FuPlugin *self, FuDevice *device, GError **error
 	if (vfuncs->reboot_cleanup == NULL)
 		return TRUE;
 	g_debug("reboot_cleanup(%s)", fu_plugin_get_name(self));
-	return vfuncs->reboot_cleanup(self, device, error);
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = vfuncs->reboot_cleanup(self, device, error);
+	fu_plugin_runner_stats_add(self, "reboot_cleanup", begin_us, ret);
+	return ret;
 }
 
 /**
@@ -1398,12 +1536,15 @@ void
 fu_plugin_runner_add_security_attrs(FuPlugin *self, FuSecurityAttrs *attrs)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gint64 begin_us;
 
 	/* optional, but gets called even for disabled plugins */
 	if (vfuncs->add_security_attrs == NULL)
 		return;
 	g_debug("add_security_attrs(%s)", fu_plugin_get_name(self));
+	begin_us = fu_plugin_runner_stats_begin();
 	vfuncs->add_security_attrs(self, attrs);
+	fu_plugin_runner_stats_add(self, "add_security_attrs", begin_us, TRUE);
 }
 
 /**
@@ -1758,6 +1899,8 @@ fu_plugin_runner_backend_device_added(FuPlugin *self,
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -1773,7 +1916,10 @@ fu_plugin_runner_backend_device_added(FuPlugin *self,
 	if (vfuncs->backend_device_added == NULL) {
 		if (priv->device_gtypes != NULL ||
 		    fu_device_get_specialized_gtype(device) != G_TYPE_INVALID) {
-			return fu_plugin_backend_device_added(self, device, progress, error);
+			begin_us = fu_plugin_runner_stats_begin();
+			ret = fu_plugin_backend_device_added(self, device, progress, error);
+			fu_plugin_runner_stats_add(self, "backend_device_added", begin_us, ret);
+			return ret;
 		}
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
@@ -1782,7 +1928,10 @@ fu_plugin_runner_backend_device_added(FuPlugin *self,
 		return FALSE;
 	}
 	g_debug("backend_device_added(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->backend_device_added(self, device, progress, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = vfuncs->backend_device_added(self, device, progress, &error_local);
+	fu_plugin_runner_stats_add(self, "backend_device_added", begin_us, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in backend_device_added(%s)",
 				   fu_plugin_get_name(self));
@@ -1816,6 +1965,8 @@ gboolean
 fu_plugin_runner_backend_device_changed(FuPlugin *self, FuDevice *device, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -1830,7 +1981,10 @@ fu_plugin_runner_backend_device_changed(FuPlugin *self, FuDevice *device, GError
 	if (vfuncs->backend_device_changed == NULL)
 		return TRUE;
 	g_debug("udev_device_changed(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->backend_device_changed(self, device, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = vfuncs->backend_device_changed(self, device, &error_local);
+	fu_plugin_runner_stats_add(self, "backend_device_changed", begin_us, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in udev_device_changed(%s)",
 				   fu_plugin_get_name(self));
@@ -1861,6 +2015,7 @@ void
 fu_plugin_runner_device_added(FuPlugin *self, FuDevice *device)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gint64 begin_us;
 
 	/* not enabled */
 	if (fu_plugin_has_flag(self, FWUPD_PLUGIN_FLAG_DISABLED))
@@ -1870,7 +2025,9 @@ fu_plugin_runner_device_added(FuPlugin *self, FuDevice *device)
 	if (vfuncs->device_added == NULL)
 		return;
 	g_debug("fu_plugin_device_added(%s)", fu_plugin_get_name(self));
+	begin_us = fu_plugin_runner_stats_begin();
 	vfuncs->device_added(self, device);
+	fu_plugin_runner_stats_add(self, "device_added", begin_us, TRUE);
 }
 
 /**
@@ -1916,8 +2073,10 @@ fu_plugin_runner_device_register(FuPlugin *self, FuDevice *device)
 
 	/* optional */
 	if (vfuncs->device_registered != NULL) {
+		gint64 begin_us = fu_plugin_runner_stats_begin();
 		g_debug("fu_plugin_device_registered(%s)", fu_plugin_get_name(self));
 		vfuncs->device_registered(self, device);
+		fu_plugin_runner_stats_add(self, "device_registered", begin_us, TRUE);
 	}
 }
 
@@ -1937,6 +2096,8 @@ gboolean
 fu_plugin_runner_device_created(FuPlugin *self, FuDevice *device, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 begin_us;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
 	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
@@ -1950,7 +2111,10 @@ fu_plugin_runner_device_created(FuPlugin *self, FuDevice *device, GError **error
 	if (vfuncs->device_created == NULL)
 		return TRUE;
 	g_debug("fu_plugin_device_created(%s)", fu_plugin_get_name(self));
-	return vfuncs->device_created(self, device, error);
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = vfuncs->device_created(self, device, error);
+	fu_plugin_runner_stats_add(self, "device_created", begin_us, ret);
+	return ret;
 }
 
 /**
@@ -1976,6 +2140,8 @@ fu_plugin_runner_verify(FuPlugin *self,
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	GPtrArray *checksums;
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -2016,7 +2182,10 @@ fu_plugin_runner_verify(FuPlugin *self,
 
 	/* run vfunc */
 	g_debug("verify(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->verify(self, device, progress, flags, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = vfuncs->verify(self, device, progress, flags, &error_local);
+	fu_plugin_runner_stats_add(self, "verify", begin_us, ret);
+	if (!ret) {
 		g_autoptr(GError) error_attach = NULL;
 		if (error_local == NULL) {
 			g_critical("unset plugin error in verify(%s)", fu_plugin_get_name(self));
@@ -2179,6 +2348,8 @@ fu_plugin_runner_write_firmware(FuPlugin *self,
 				GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -2195,7 +2366,10 @@ fu_plugin_runner_write_firmware(FuPlugin *self,
 
 	/* optional */
 	if (vfuncs->write_firmware != NULL) {
-		if (!vfuncs->write_firmware(self, device, stream, progress, flags, &error_local)) {
+		begin_us = fu_plugin_runner_stats_begin();
+		ret = vfuncs->write_firmware(self, device, stream, progress, flags, &error_local);
+		fu_plugin_runner_stats_add(self, "write_firmware", begin_us, ret);
+		if (!ret) {
 			if (error_local == NULL) {
 				g_critical("unset plugin error in update(%s)",
 					   fu_plugin_get_name(self));
@@ -2211,12 +2385,10 @@ fu_plugin_runner_write_firmware(FuPlugin *self,
 		}
 	} else {
 		g_debug("superclassed write_firmware(%s)", fu_plugin_get_name(self));
-		return fu_plugin_device_write_firmware(self,
-						       device,
-						       stream,
-						       progress,
-						       flags,
-						       error);
+		begin_us = fu_plugin_runner_stats_begin();
+		ret = fu_plugin_device_write_firmware(self, device, stream, progress, flags, error);
+		fu_plugin_runner_stats_add(self, "write_firmware", begin_us, ret);
+		return ret;
 	}
 
 	/* no longer valid */
@@ -2246,6 +2418,8 @@ gboolean
 fu_plugin_runner_clear_results(FuPlugin *self, FuDevice *device, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -2260,7 +2434,10 @@ fu_plugin_runner_clear_results(FuPlugin *self, FuDevice *device, GError **error)
 	if (vfuncs->clear_results == NULL)
 		return TRUE;
 	g_debug("clear_result(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->clear_results(self, device, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = vfuncs->clear_results(self, device, &error_local);
+	fu_plugin_runner_stats_add(self, "clear_results", begin_us, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in clear_result(%s)",
 				   fu_plugin_get_name(self));
@@ -2294,6 +2471,8 @@ gboolean
 fu_plugin_runner_get_results(FuPlugin *self, FuDevice *device, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 begin_us;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -2310,7 +2489,10 @@ fu_plugin_runner_get_results(FuPlugin *self, FuDevice *device, GError **error)
 		return fu_plugin_device_get_results(self, device, error);
 	}
 	g_debug("get_results(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->get_results(self, device, &error_local)) {
+	begin_us = fu_plugin_runner_stats_begin();
+	ret = vfuncs->get_results(self, device, &error_local);
+	fu_plugin_runner_stats_add(self, "get_results", begin_us, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in get_results(%s)",
 				   fu_plugin_get_name(self));
@@ -2551,6 +2733,7 @@ void
 fu_plugin_add_report_metadata(FuPlugin *self, const gchar *key, const gchar *value)
 {
 	FuPluginPrivate *priv = fu_plugin_get_instance_private(self);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
 	if (priv->report_metadata == NULL) {
 		priv->report_metadata =
 		    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
@@ -2925,6 +3108,25 @@ fu_plugin_class_init(FuPluginClass *klass)
 						     g_cclosure_marshal_VOID__VOID,
 						     G_TYPE_NONE,
 						     0);
+	/**
+	 * FuPlugin::security-changed:
+	 * @self: the #FuPlugin instance that emitted the signal
+	 *
+	 * The ::security-changed signal is emitted when the HSI attributes added by the plugin
+	 * may have changed.
+	 *
+	 * Since: 2.0.0
+	 **/
+	signals[SIGNAL_SECURITY_CHANGED] =
+	    g_signal_new("security-changed",
+			 G_TYPE_FROM_CLASS(object_class),
+			 G_SIGNAL_RUN_LAST,
+			 G_STRUCT_OFFSET(FuPluginClass, _security_changed),
+			 NULL,
+			 NULL,
+			 g_cclosure_marshal_VOID__VOID,
+			 G_TYPE_NONE,
+			 0);
 
 	/**
 	 * FuPlugin:context:
@@ -2946,6 +3148,8 @@ fu_plugin_init(FuPlugin *self)
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	priv->device_gtype_default = G_TYPE_INVALID;
+	priv->runner_stats = fu_runner_stats_new();
+	g_mutex_init(&priv->mutex);
 }
 
 static void
@@ -2975,6 +3179,8 @@ fu_plugin_finalize(GObject *object)
 		g_hash_table_unref(priv->compile_versions);
 	if (priv->report_metadata != NULL)
 		g_hash_table_unref(priv->report_metadata);
+	fu_runner_stats_free(priv->runner_stats);
+	g_mutex_clear(&priv->mutex);
 	if (priv->cache != NULL)
 		g_hash_table_unref(priv->cache);
 	if (priv->device_gtypes != NULL)
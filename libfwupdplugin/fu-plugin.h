@@ -62,6 +62,7 @@ struct _FuPluginClass {
 	void (*_device_register)(FuPlugin *self, FuDevice *device);
 	gboolean (*_check_supported)(FuPlugin *self, const gchar *guid);
 	void (*_rules_changed)(FuPlugin *self);
+	void (*_security_changed)(FuPlugin *self);
 
 	/* vfuncs */
 	/**
@@ -521,6 +522,8 @@ void
 fu_plugin_add_report_metadata(FuPlugin *self, const gchar *key, const gchar *value)
     G_GNUC_NON_NULL(1, 2, 3);
 void
+fu_plugin_security_changed(FuPlugin *self) G_GNUC_NON_NULL(1);
+void
 fu_plugin_set_config_default(FuPlugin *self, const gchar *key, const gchar *value)
     G_GNUC_NON_NULL(1, 2);
 gchar *
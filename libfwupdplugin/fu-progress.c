@@ -67,6 +67,7 @@ struct _FuProgress {
 	GPtrArray *children; /* of FuProgress */
 	gboolean profile;
 	gdouble duration; /* seconds */
+	guint64 sleep_ms; /* included in duration */
 	guint step_weighting;
 	GTimer *timer;
 	GTimer *timer_child;
@@ -450,6 +451,7 @@ fu_progress_reset(FuProgress *self)
 	/* reset values */
 	self->step_now = 0;
 	self->percentage = G_MAXUINT;
+	self->sleep_ms = 0;
 
 	/* only use the timer if profiling; it's expensive */
 	if (self->profile) {
@@ -912,6 +914,24 @@ fu_progress_sleep(FuProgress *self, guint delay_ms)
 		g_usleep(delay_us_pc);
 		fu_progress_set_percentage(self, i + 1);
 	}
+	fu_progress_add_sleep(self, delay_ms);
+}
+
+/**
+ * fu_progress_add_sleep:
+ * @self: a #FuProgress
+ * @delay_ms: the delay in milliseconds
+ *
+ * Records that the caller has already slept for @delay_ms, so that fixed delays can be found
+ * in the profile traceback. This does not sleep.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_progress_add_sleep(FuProgress *self, guint delay_ms)
+{
+	g_return_if_fail(FU_IS_PROGRESS(self));
+	self->sleep_ms += delay_ms;
 }
 
 static void
@@ -934,7 +954,13 @@ fu_progress_traceback_cb(FuProgress *self,
 			g_string_append_printf(str, ":%s", self->name);
 		if (self->id == NULL && self->name == NULL && child_idx != G_MAXUINT)
 			g_string_append_printf(str, "@%u", child_idx);
-		g_string_append_printf(str, " [%.2fms]", fu_progress_get_duration(self) * 1000.f);
+		g_string_append_printf(str, " [%.2fms", fu_progress_get_duration(self) * 1000.f);
+		if (self->sleep_ms > 0) {
+			g_string_append_printf(str,
+					       ", %" G_GUINT64_FORMAT "ms sleeping",
+					       self->sleep_ms);
+		}
+		g_string_append(str, "]");
 		g_string_append(str, self->children->len > 0 ? ":\n" : "\n");
 	}
 	for (guint i = 0; i < self->children->len; i++) {
@@ -990,6 +1016,7 @@ fu_progress_add_string(FwupdCodec *converter, guint idt, GString *str)
 		fwupd_codec_string_append(str, idt, "Status", fwupd_status_to_string(self->status));
 	if (self->duration > 0.0001)
 		fwupd_codec_string_append_int(str, idt, "DurationMs", self->duration * 1000.f);
+	fwupd_codec_string_append_int(str, idt, "SleepMs", self->sleep_ms);
 	fwupd_codec_string_append_int(str, idt, "StepWeighting", self->step_weighting);
 	fwupd_codec_string_append_int(str, idt, "StepNow", self->step_now);
 	for (guint i = 0; i < self->children->len; i++) {
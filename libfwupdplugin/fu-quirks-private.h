@@ -0,0 +1,12 @@
+/*
+ * Copyright 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include "fu-quirks.h"
+
+void
+fu_quirks_invalidate(FuQuirks *self) G_GNUC_NON_NULL(1);
@@ -18,7 +18,7 @@
 #include "fu-bytes.h"
 #include "fu-common.h"
 #include "fu-path.h"
-#include "fu-quirks.h"
+#include "fu-quirks-private.h"
 #include "fu-string.h"
 
 /**
@@ -71,12 +71,43 @@ struct _FuQuirks {
 	FuQuirksLoadFlags load_flags;
 	GHashTable *possible_keys;
 	GPtrArray *invalid_keys;
+	GMutex silo_mutex; /* for silo, query_kv, query_vs and tables_old */
 	XbSilo *silo;
 	XbQuery *query_kv;
 	XbQuery *query_vs;
+	GBytes *table;	       /* (nullable) (atomic) */
+	GPtrArray *tables_old; /* (element-type GBytes) */
 	gboolean verbose;
 };
 
+/*
+ * The compiled lookup table is a header, then the records sorted by the GUID hash, then a string
+ * table that every offset points into. Nothing in the table is ever modified once it is loaded,
+ * and replaced tables are kept until the FuQuirks is destroyed, so lookups from any thread only
+ * need to read the current pointer atomically. Checking and rebuilding the silo, which also
+ * replaces the table, is done with silo_mutex held.
+ */
+#define FU_QUIRKS_TABLE_MAGIC	   0x49515746 /* FWQI */
+#define FU_QUIRKS_TABLE_VERSION	   2
+#define FU_QUIRKS_TABLE_HASH_FNV1A 1
+
+typedef struct {
+	guint32 magic;
+	guint32 version;
+	guint32 hash_kind; /* the saved table is only valid for the same hash function */
+	gchar silo_guid[40];
+	guint32 n_records;
+	guint32 strtab_sz;
+} FuQuirksTableHeader;
+
+typedef struct {
+	guint32 id_hash;
+	guint32 idx; /* document order, to make the sort stable */
+	guint32 id_offset;
+	guint32 key_offset;
+	guint32 value_offset;
+} FuQuirksTableRecord;
+
 G_DEFINE_TYPE(FuQuirks, fu_quirks, G_TYPE_OBJECT)
 
 static gchar *
@@ -347,6 +378,282 @@ fu_quirks_add_quirks_for_path(FuQuirks *self, XbBuilder *builder, const gchar *p
 	return TRUE;
 }
 
+/* this is saved to disk and so has to be stable, unlike g_str_hash() */
+static guint32
+fu_quirks_table_hash(const gchar *str)
+{
+	guint32 hash = 0x811c9dc5;
+	for (const guchar *p = (const guchar *)str; *p != '\0'; p++) {
+		hash ^= *p;
+		hash *= 0x01000193;
+	}
+	return hash;
+}
+
+static guint32
+fu_quirks_table_add_string(GByteArray *strtab, GHashTable *offsets, const gchar *str)
+{
+	gpointer offset = NULL;
+
+	/* already added */
+	if (g_hash_table_lookup_extended(offsets, str, NULL, &offset))
+		return GPOINTER_TO_UINT(offset);
+	offset = GUINT_TO_POINTER(strtab->len);
+	g_byte_array_append(strtab, (const guint8 *)str, strlen(str) + 1);
+	g_hash_table_insert(offsets, (gpointer)str, offset);
+	return GPOINTER_TO_UINT(offset);
+}
+
+static gint
+fu_quirks_table_record_sort_cb(gconstpointer a, gconstpointer b)
+{
+	const FuQuirksTableRecord *rec1 = (const FuQuirksTableRecord *)a;
+	const FuQuirksTableRecord *rec2 = (const FuQuirksTableRecord *)b;
+	if (rec1->id_hash != rec2->id_hash)
+		return rec1->id_hash < rec2->id_hash ? -1 : 1;
+	if (rec1->idx != rec2->idx)
+		return rec1->idx < rec2->idx ? -1 : 1;
+	return 0;
+}
+
+static GBytes *
+fu_quirks_table_build(FuQuirks *self, GError **error)
+{
+	FuQuirksTableHeader hdr = {
+	    .magic = FU_QUIRKS_TABLE_MAGIC,
+	    .version = FU_QUIRKS_TABLE_VERSION,
+	    .hash_kind = FU_QUIRKS_TABLE_HASH_FNV1A,
+	};
+	g_autoptr(GArray) records = g_array_new(FALSE, FALSE, sizeof(FuQuirksTableRecord));
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GByteArray) strtab = g_byte_array_new();
+	g_autoptr(GHashTable) offsets = g_hash_table_new(g_str_hash, g_str_equal);
+	g_autoptr(GPtrArray) values = NULL;
+
+	values = xb_silo_query(self->silo, "quirk/device/value", 0, error);
+	if (values == NULL) {
+		g_prefix_error(error, "failed to query quirk values: ");
+		return NULL;
+	}
+	for (guint i = 0; i < values->len; i++) {
+		XbNode *n = g_ptr_array_index(values, i);
+		FuQuirksTableRecord rec = {.idx = i};
+		const gchar *id;
+		const gchar *key = xb_node_get_attr(n, "key");
+		const gchar *value = xb_node_get_text(n);
+		g_autoptr(XbNode) parent = xb_node_get_parent(n);
+
+		id = parent != NULL ? xb_node_get_attr(parent, "id") : NULL;
+		if (id == NULL || key == NULL)
+			continue;
+		if (value == NULL)
+			value = "";
+		rec.id_hash = fu_quirks_table_hash(id);
+		rec.id_offset = fu_quirks_table_add_string(strtab, offsets, id);
+		rec.key_offset = fu_quirks_table_add_string(strtab, offsets, key);
+		rec.value_offset = fu_quirks_table_add_string(strtab, offsets, value);
+		g_array_append_val(records, rec);
+	}
+	g_array_sort(records, fu_quirks_table_record_sort_cb);
+
+	/* header, records, strings */
+	hdr.n_records = records->len;
+	hdr.strtab_sz = strtab->len;
+	g_strlcpy(hdr.silo_guid, xb_silo_get_guid(self->silo), sizeof(hdr.silo_guid));
+	g_byte_array_append(buf, (const guint8 *)&hdr, sizeof(hdr));
+	g_byte_array_append(buf,
+			    (const guint8 *)records->data,
+			    records->len * sizeof(FuQuirksTableRecord));
+	g_byte_array_append(buf, strtab->data, strtab->len);
+	return g_byte_array_free_to_bytes(g_steal_pointer(&buf)); /* nocheck */
+}
+
+static gboolean
+fu_quirks_table_validate(FuQuirks *self, GBytes *table, GError **error)
+{
+	const FuQuirksTableHeader *hdr;
+	const FuQuirksTableRecord *records;
+	const gchar *strtab;
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(table, &bufsz);
+
+	if (bufsz < sizeof(FuQuirksTableHeader)) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "table too small");
+		return FALSE;
+	}
+	hdr = (const FuQuirksTableHeader *)buf;
+	if (hdr->magic != FU_QUIRKS_TABLE_MAGIC || hdr->version != FU_QUIRKS_TABLE_VERSION) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "table signature or version invalid");
+		return FALSE;
+	}
+	if (hdr->hash_kind != FU_QUIRKS_TABLE_HASH_FNV1A) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "table hash kind 0x%x not supported",
+			    hdr->hash_kind);
+		return FALSE;
+	}
+	if (strncmp(hdr->silo_guid, xb_silo_get_guid(self->silo), sizeof(hdr->silo_guid)) != 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "table does not match silo");
+		return FALSE;
+	}
+	if (hdr->n_records > (bufsz - sizeof(FuQuirksTableHeader)) / sizeof(FuQuirksTableRecord) ||
+	    bufsz != sizeof(FuQuirksTableHeader) +
+			 (gsize)hdr->n_records * sizeof(FuQuirksTableRecord) + hdr->strtab_sz) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "table size 0x%x invalid",
+			    (guint)bufsz);
+		return FALSE;
+	}
+
+	/* every string has to be NUL terminated inside the string table */
+	records = (const FuQuirksTableRecord *)(buf + sizeof(FuQuirksTableHeader));
+	strtab = (const gchar *)(records + hdr->n_records);
+	if (hdr->n_records > 0 && (hdr->strtab_sz == 0 || strtab[hdr->strtab_sz - 1] != '\0')) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "string table not terminated");
+		return FALSE;
+	}
+	for (guint32 i = 0; i < hdr->n_records; i++) {
+		if (records[i].id_offset >= hdr->strtab_sz ||
+		    records[i].key_offset >= hdr->strtab_sz ||
+		    records[i].value_offset >= hdr->strtab_sz) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "record 0x%x has invalid offset",
+				    i);
+			return FALSE;
+		}
+		if (i > 0 && records[i].id_hash < records[i - 1].id_hash) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "record 0x%x is not sorted",
+				    i);
+			return FALSE;
+		}
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static void
+fu_quirks_table_set(FuQuirks *self, GBytes *table)
+{
+	GBytes *table_old = g_atomic_pointer_get(&self->table);
+
+	/* only ever called when the silo is rebuilt with silo_mutex held */
+	g_atomic_pointer_set(&self->table, table != NULL ? g_bytes_ref(table) : NULL);
+
+	/* another thread may still be using the old strings */
+	if (table_old != NULL)
+		g_ptr_array_add(self->tables_old, table_old);
+}
+
+static gboolean
+fu_quirks_check_table(FuQuirks *self, GFile *file, GError **error)
+{
+	g_autofree gchar *fn = NULL;
+	g_autoptr(GBytes) table = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GMappedFile) mmap = NULL;
+
+	/* nowhere persistent to save the table to */
+	if ((self->load_flags & FU_QUIRKS_LOAD_FLAG_NO_CACHE) > 0 ||
+	    (self->load_flags & FU_QUIRKS_LOAD_FLAG_READONLY_FS) > 0) {
+		table = fu_quirks_table_build(self, error);
+		if (table == NULL)
+			return FALSE;
+		fu_quirks_table_set(self, table);
+		return TRUE;
+	}
+
+	/* use the existing table if it was generated from this silo */
+	fn = g_strdup_printf("%s.idx", g_file_peek_path(file));
+	mmap = g_mapped_file_new(fn, FALSE, &error_local);
+	if (mmap != NULL) {
+		table = g_mapped_file_get_bytes(mmap);
+		if (fu_quirks_table_validate(self, table, &error_local)) {
+			fu_quirks_table_set(self, table);
+			return TRUE;
+		}
+		g_debug("ignoring %s: %s", fn, error_local->message);
+		g_clear_pointer(&table, g_bytes_unref);
+		g_clear_pointer(&mmap, g_mapped_file_unref);
+	}
+
+	/* regenerate, and use the mapped version so the pages can be shared and reclaimed */
+	table = fu_quirks_table_build(self, error);
+	if (table == NULL)
+		return FALSE;
+	g_clear_error(&error_local);
+	if (!fu_bytes_set_contents(fn, table, &error_local)) {
+		g_debug("failed to save quirk table, using in-memory copy: %s",
+			error_local->message);
+		fu_quirks_table_set(self, table);
+		return TRUE;
+	}
+	mmap = g_mapped_file_new(fn, FALSE, &error_local);
+	if (mmap == NULL) {
+		g_debug("failed to map quirk table, using in-memory copy: %s",
+			error_local->message);
+		fu_quirks_table_set(self, table);
+		return TRUE;
+	}
+	g_bytes_unref(table);
+	table = g_mapped_file_get_bytes(mmap);
+	if (!fu_quirks_table_validate(self, table, error)) {
+		g_prefix_error(error, "failed to validate %s: ", fn);
+		return FALSE;
+	}
+	fu_quirks_table_set(self, table);
+	return TRUE;
+}
+
+/* returns the first record for @guid, and the records and strings that follow it */
+static const FuQuirksTableRecord *
+fu_quirks_table_lookup(GBytes *table,
+		       const gchar *guid,
+		       guint32 *n_records,
+		       const gchar **strtab)
+{
+	const guint8 *buf = g_bytes_get_data(table, NULL);
+	const FuQuirksTableHeader *hdr = (const FuQuirksTableHeader *)buf;
+	const FuQuirksTableRecord *records =
+	    (const FuQuirksTableRecord *)(buf + sizeof(FuQuirksTableHeader));
+	guint32 id_hash = fu_quirks_table_hash(guid);
+	guint32 lo = 0;
+	guint32 hi = hdr->n_records;
+
+	/* lower bound of the hash */
+	while (lo < hi) {
+		guint32 mid = lo + (hi - lo) / 2;
+		if (records[mid].id_hash < id_hash)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	*strtab = (const gchar *)(records + hdr->n_records);
+	*n_records = hdr->n_records - lo;
+	return records + lo;
+}
+
 static gint
 fu_quirks_strcasecmp_cb(gconstpointer a, gconstpointer b)
 {
@@ -355,6 +662,7 @@ fu_quirks_strcasecmp_cb(gconstpointer a, gconstpointer b)
 	return g_ascii_strcasecmp(entry1, entry2);
 }
 
+/* silo_mutex has to be held */
 static gboolean
 fu_quirks_check_silo(FuQuirks *self, GError **error)
 {
@@ -362,6 +670,7 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 	g_autofree gchar *datadir = NULL;
 	g_autofree gchar *localstatedir = NULL;
 	g_autoptr(GFile) file = NULL;
+	g_autoptr(GError) error_local = NULL;
 	g_autoptr(XbBuilder) builder = NULL;
 	g_autoptr(XbNode) n_any = NULL;
 
@@ -440,6 +749,12 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 	if (!xb_silo_query_build_index(self->silo, "quirk/device/value", "key", error))
 		return FALSE;
 
+	/* used for all lookups when available */
+	if (!fu_quirks_check_table(self, file, &error_local)) {
+		g_warning("failed to build quirk table, using XPath: %s", error_local->message);
+		fu_quirks_table_set(self, NULL);
+	}
+
 	/* success */
 	return TRUE;
 }
@@ -459,7 +774,9 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 const gchar *
 fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 {
+	GBytes *table;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_autoptr(XbNode) n = NULL;
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 
@@ -468,6 +785,7 @@ fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 	g_return_val_if_fail(key != NULL, NULL);
 
 	/* ensure up to date */
+	locker = g_mutex_locker_new(&self->silo_mutex);
 	if (!fu_quirks_check_silo(self, &error)) {
 		g_warning("failed to build silo: %s", error->message);
 		return NULL;
@@ -477,6 +795,31 @@ fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 	if (self->query_kv == NULL)
 		return NULL;
 
+	/* use the compiled table, which does not need the lock */
+	table = g_atomic_pointer_get(&self->table);
+	if (table != NULL) {
+		const gchar *strtab = NULL;
+		guint32 n_records = 0;
+		guint32 id_hash = fu_quirks_table_hash(guid);
+		const FuQuirksTableRecord *records =
+		    fu_quirks_table_lookup(table, guid, &n_records, &strtab);
+		g_clear_pointer(&locker, g_mutex_locker_free);
+		for (guint32 i = 0; i < n_records && records[i].id_hash == id_hash; i++) {
+			if (g_strcmp0(strtab + records[i].id_offset, guid) != 0)
+				continue;
+			if (g_strcmp0(strtab + records[i].key_offset, key) != 0)
+				continue;
+			if (self->verbose) {
+				g_debug("%s:%s → %s",
+					guid,
+					key,
+					strtab + records[i].value_offset);
+			}
+			return strtab + records[i].value_offset;
+		}
+		return NULL;
+	}
+
 	/* query */
 	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
@@ -516,7 +859,9 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 			    FuQuirksIter iter_cb,
 			    gpointer user_data)
 {
+	GBytes *table;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_autoptr(GPtrArray) results = NULL;
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 
@@ -525,6 +870,7 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 	g_return_val_if_fail(iter_cb != NULL, FALSE);
 
 	/* ensure up to date */
+	locker = g_mutex_locker_new(&self->silo_mutex);
 	if (!fu_quirks_check_silo(self, &error)) {
 		g_warning("failed to build silo: %s", error->message);
 		return FALSE;
@@ -534,6 +880,31 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 	if (self->query_vs == NULL)
 		return FALSE;
 
+	/* use the compiled table, which does not need the lock */
+	table = g_atomic_pointer_get(&self->table);
+	if (table != NULL) {
+		const gchar *strtab = NULL;
+		gboolean found = FALSE;
+		guint32 n_records = 0;
+		guint32 id_hash = fu_quirks_table_hash(guid);
+		const FuQuirksTableRecord *records =
+		    fu_quirks_table_lookup(table, guid, &n_records, &strtab);
+		g_clear_pointer(&locker, g_mutex_locker_free);
+		for (guint32 i = 0; i < n_records && records[i].id_hash == id_hash; i++) {
+			const gchar *key_tmp = strtab + records[i].key_offset;
+			const gchar *value = strtab + records[i].value_offset;
+			if (g_strcmp0(strtab + records[i].id_offset, guid) != 0)
+				continue;
+			if (key != NULL && g_strcmp0(key_tmp, key) != 0)
+				continue;
+			if (self->verbose)
+				g_debug("%s → %s", guid, value);
+			iter_cb(self, key_tmp, value, user_data);
+			found = TRUE;
+		}
+		return found;
+	}
+
 	/* query */
 	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
@@ -551,6 +922,7 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 		g_warning("failed to query: %s", error->message);
 		return FALSE;
 	}
+	g_clear_pointer(&locker, g_mutex_locker_free);
 	for (guint i = 0; i < results->len; i++) {
 		XbNode *n = g_ptr_array_index(results, i);
 		if (self->verbose)
@@ -575,13 +947,38 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 gboolean
 fu_quirks_load(FuQuirks *self, FuQuirksLoadFlags load_flags, GError **error)
 {
+	g_autoptr(GMutexLocker) locker = NULL;
+
 	g_return_val_if_fail(FU_IS_QUIRKS(self), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	locker = g_mutex_locker_new(&self->silo_mutex);
 	self->load_flags = load_flags;
 	self->verbose = g_getenv("FWUPD_XMLB_VERBOSE") != NULL;
 	return fu_quirks_check_silo(self, error);
 }
 
+/**
+ * fu_quirks_invalidate: (skip)
+ * @self: a #FuQuirks
+ *
+ * Marks the silo as out of date, as happens when a quirk file is changed, so that it is rebuilt
+ * by the next lookup.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_quirks_invalidate(FuQuirks *self)
+{
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_QUIRKS(self));
+
+	locker = g_mutex_locker_new(&self->silo_mutex);
+	if (self->silo != NULL)
+		xb_silo_invalidate(self->silo);
+}
+
 /**
  * fu_quirks_add_possible_key:
  * @self: a #FuQuirks
@@ -610,8 +1007,10 @@ fu_quirks_class_init(FuQuirksClass *klass)
 static void
 fu_quirks_init(FuQuirks *self)
 {
+	g_mutex_init(&self->silo_mutex);
 	self->possible_keys = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	self->invalid_keys = g_ptr_array_new_with_free_func(g_free);
+	self->tables_old = g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
 
 	/* built in */
 	fu_quirks_add_possible_key(self, FU_QUIRKS_BRANCH);
@@ -668,8 +1067,12 @@ fu_quirks_finalize(GObject *obj)
 		g_object_unref(self->query_vs);
 	if (self->silo != NULL)
 		g_object_unref(self->silo);
+	if (self->table != NULL)
+		g_bytes_unref(self->table);
+	g_ptr_array_unref(self->tables_old);
 	g_hash_table_unref(self->possible_keys);
 	g_ptr_array_unref(self->invalid_keys);
+	g_mutex_clear(&self->silo_mutex);
 	G_OBJECT_CLASS(fu_quirks_parent_class)->finalize(obj);
 }
 
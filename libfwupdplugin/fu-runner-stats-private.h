@@ -0,0 +1,31 @@
+/*
+ * Copyright 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include <glib.h>
+
+typedef struct FuRunnerStats FuRunnerStats;
+
+FuRunnerStats *
+fu_runner_stats_new(void);
+void
+fu_runner_stats_free(FuRunnerStats *self);
+void
+fu_runner_stats_add(FuRunnerStats *self,
+		    const gchar *vfunc,
+		    gint64 begin_us,
+		    gboolean nested,
+		    gboolean success) G_GNUC_NON_NULL(1, 2);
+guint64
+fu_runner_stats_get_total_us(FuRunnerStats *self) G_GNUC_NON_NULL(1);
+void
+fu_runner_stats_add_variant(FuRunnerStats *self,
+			    const gchar *kind,
+			    const gchar *name,
+			    GVariantBuilder *builder) G_GNUC_NON_NULL(1, 2, 4);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuRunnerStats, fu_runner_stats_free)
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "config.h"
+
+#include "fu-runner-stats-private.h"
+
+/*
+ * Always-on counters for the vfuncs of a plugin or backend. This is cheap enough to be used for
+ * every call, as only the monotonic clock is read and a few integers are updated.
+ */
+
+typedef struct {
+	guint64 cnt;
+	guint64 cnt_error;
+	guint64 total_us;
+	guint64 max_us;
+} FuRunnerStatsItem;
+
+struct FuRunnerStats {
+	GMutex mutex;
+	guint64 total_us; /* not including the nested vfuncs */
+	GHashTable *items; /* (element-type utf8 FuRunnerStatsItem) keys are static strings */
+};
+
+FuRunnerStats *
+fu_runner_stats_new(void)
+{
+	FuRunnerStats *self = g_new0(FuRunnerStats, 1);
+	g_mutex_init(&self->mutex);
+	self->items = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+	return self;
+}
+
+void
+fu_runner_stats_free(FuRunnerStats *self)
+{
+	g_hash_table_unref(self->items);
+	g_mutex_clear(&self->mutex);
+	g_free(self);
+}
+
+/* @vfunc must be a static string, @begin_us is from g_get_monotonic_time(), and @nested is set
+ * when called from another vfunc that is also being counted */
+void
+fu_runner_stats_add(FuRunnerStats *self,
+		    const gchar *vfunc,
+		    gint64 begin_us,
+		    gboolean nested,
+		    gboolean success)
+{
+	FuRunnerStatsItem *item;
+	guint64 elapsed_us = MAX(g_get_monotonic_time() - begin_us, 0);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->mutex);
+
+	item = g_hash_table_lookup(self->items, vfunc);
+	if (item == NULL) {
+		item = g_new0(FuRunnerStatsItem, 1);
+		g_hash_table_insert(self->items, (gpointer)vfunc, item);
+	}
+	item->cnt++;
+	if (!success)
+		item->cnt_error++;
+	item->total_us += elapsed_us;
+	item->max_us = MAX(item->max_us, elapsed_us);
+	if (!nested)
+		self->total_us += elapsed_us;
+}
+
+/* the time spent in all the vfuncs that have been called, counting nested vfuncs only once */
+guint64
+fu_runner_stats_get_total_us(FuRunnerStats *self)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->mutex);
+	return self->total_us;
+}
+
+/* adds one a{sv} for each vfunc that has been called */
+void
+fu_runner_stats_add_variant(FuRunnerStats *self,
+			    const gchar *kind,
+			    const gchar *name,
+			    GVariantBuilder *builder)
+{
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->mutex);
+
+	g_hash_table_iter_init(&iter, self->items);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		FuRunnerStatsItem *item = (FuRunnerStatsItem *)value;
+		GVariantBuilder dict;
+
+		g_variant_builder_init(&dict, G_VARIANT_TYPE_VARDICT);
+		g_variant_builder_add(&dict, "{sv}", "Kind", g_variant_new_string(kind));
+		if (name != NULL)
+			g_variant_builder_add(&dict, "{sv}", "Name", g_variant_new_string(name));
+		g_variant_builder_add(&dict, "{sv}", "Vfunc", g_variant_new_string(key));
+		g_variant_builder_add(&dict, "{sv}", "Count", g_variant_new_uint64(item->cnt));
+		g_variant_builder_add(&dict,
+				      "{sv}",
+				      "ErrorCount",
+				      g_variant_new_uint64(item->cnt_error));
+		g_variant_builder_add(&dict,
+				      "{sv}",
+				      "TotalUs",
+				      g_variant_new_uint64(item->total_us));
+		g_variant_builder_add(&dict, "{sv}", "MaxUs", g_variant_new_uint64(item->max_us));
+		g_variant_builder_add_value(builder, g_variant_builder_end(&dict));
+	}
+}
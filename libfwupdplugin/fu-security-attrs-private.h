@@ -33,6 +33,8 @@ GVariant *
 fu_security_attrs_to_variant(FuSecurityAttrs *self) G_GNUC_NON_NULL(1);
 GPtrArray *
 fu_security_attrs_get_all(FuSecurityAttrs *self) G_GNUC_NON_NULL(1);
+guint
+fu_security_attrs_get_lookup_count(FuSecurityAttrs *self) G_GNUC_NON_NULL(1);
 void
 fu_security_attrs_append_internal(FuSecurityAttrs *self, FwupdSecurityAttr *attr)
     G_GNUC_NON_NULL(1, 2);
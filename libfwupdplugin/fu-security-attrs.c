@@ -25,6 +25,7 @@
 struct _FuSecurityAttrs {
 	GObject parent_instance;
 	GPtrArray *attrs;
+	guint lookup_cnt;
 };
 
 /* probably sane to *not* make this part of the ABI */
@@ -132,6 +133,7 @@ fu_security_attrs_get_by_appstream_id(FuSecurityAttrs *self,
 				      GError **error)
 {
 	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(self), NULL);
+	self->lookup_cnt++;
 	if (self->attrs->len == 0) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
@@ -192,6 +194,7 @@ fu_security_attrs_get_all(FuSecurityAttrs *self)
 {
 	g_autoptr(GPtrArray) all = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(self), NULL);
+	self->lookup_cnt++;
 	for (guint i = 0; i < self->attrs->len; i++) {
 		FwupdSecurityAttr *attr = g_ptr_array_index(self->attrs, i);
 		if (fwupd_security_attr_has_flag(attr, FWUPD_SECURITY_ATTR_FLAG_OBSOLETED))
@@ -201,6 +204,24 @@ fu_security_attrs_get_all(FuSecurityAttrs *self)
 	return g_steal_pointer(&all);
 }
 
+/**
+ * fu_security_attrs_get_lookup_count:
+ * @self: a #FuSecurityAttrs
+ *
+ * Gets the number of times the existing attributes have been looked up, which the daemon uses
+ * to find out if a plugin or device depends on attributes added by others.
+ *
+ * Returns: integer
+ *
+ * Since: 2.0.0
+ **/
+guint
+fu_security_attrs_get_lookup_count(FuSecurityAttrs *self)
+{
+	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(self), 0);
+	return self->lookup_cnt;
+}
+
 /**
  * fu_security_attrs_remove_all:
  * @self: a #FuSecurityAttrs
@@ -16,6 +16,7 @@
 #include "fwupd-security-attr-private.h"
 
 #include "fu-bios-settings-private.h"
+#include "fu-cab-firmware-private.h"
 #include "fu-common-private.h"
 #include "fu-config-private.h"
 #include "fu-context-private.h"
@@ -25,6 +26,7 @@
 #include "fu-efi-lz77-decompressor.h"
 #include "fu-lzma-common.h"
 #include "fu-plugin-private.h"
+#include "fu-quirks-private.h"
 #include "fu-security-attrs-private.h"
 #include "fu-self-test-struct.h"
 #include "fu-smbios-private.h"
@@ -135,6 +137,71 @@ fu_archive_cab_func(void)
 	g_assert_null(data_tmp3);
 }
 
+static gboolean
+fu_archive_lazy_iterate_cb(FuArchive *self,
+			   const gchar *filename,
+			   GBytes *bytes,
+			   gpointer user_data,
+			   GError **error)
+{
+	guint *cnt = (guint *)user_data;
+	(*cnt)++;
+	return TRUE;
+}
+
+static void
+fu_archive_lazy_func(void)
+{
+	gboolean ret;
+	guint cnt = 0;
+	g_autoptr(FuArchive) archive = fu_archive_new(NULL, FU_ARCHIVE_FLAG_NONE, NULL);
+	g_autoptr(FuArchive) archive_lazy = NULL;
+	g_autoptr(GByteArray) buf = NULL;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob1 = g_bytes_new_static("hello", 5);
+	g_autoptr(GBytes) blob2 = g_bytes_new_static("world", 5);
+	g_autoptr(GBytes) blob_tmp1 = NULL;
+	g_autoptr(GBytes) blob_tmp2 = NULL;
+	g_autoptr(GBytes) blob_tmp3 = NULL;
+	g_autoptr(GError) error = NULL;
+
+#ifndef HAVE_LIBARCHIVE
+	g_test_skip("no libarchive support");
+	return;
+#endif
+
+	fu_archive_add_entry(archive, "dir/hello.txt", blob1);
+	fu_archive_add_entry(archive, "dir/world.txt", blob2);
+	buf = fu_archive_write(archive, FU_ARCHIVE_FORMAT_TAR, FU_ARCHIVE_COMPRESSION_GZIP, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(buf);
+	blob = g_bytes_new(buf->data, buf->len);
+
+	/* only the entry that is asked for is decompressed */
+	archive_lazy =
+	    fu_archive_new(blob, FU_ARCHIVE_FLAG_LAZY | FU_ARCHIVE_FLAG_IGNORE_PATH, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(archive_lazy);
+	blob_tmp1 = fu_archive_lookup_by_fn(archive_lazy, "world.txt", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_tmp1);
+	g_assert_true(g_bytes_equal(blob_tmp1, blob2));
+	blob_tmp2 = fu_archive_lookup_by_fn(archive_lazy, "dir/world.txt", &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(blob_tmp2);
+	g_clear_error(&error);
+
+	/* everything else is decompressed when iterating */
+	ret = fu_archive_iterate(archive_lazy, fu_archive_lazy_iterate_cb, &cnt, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(cnt, ==, 2);
+	blob_tmp3 = fu_archive_lookup_by_fn(archive_lazy, "hello.txt", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_tmp3);
+	g_assert_true(g_bytes_equal(blob_tmp3, blob1));
+}
+
 static void
 fu_volume_gpt_type_func(void)
 {
@@ -562,6 +629,67 @@ fu_context_firmware_gtypes_func(void)
 	g_assert_cmpint(fu_context_get_firmware_gtype_by_id(ctx, "n/a"), ==, G_TYPE_INVALID);
 }
 
+static void
+fu_context_udev_devices_func(void)
+{
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(GObject) obj1 = g_object_new(G_TYPE_OBJECT, NULL);
+	g_autoptr(GObject) obj2 = g_object_new(G_TYPE_OBJECT, NULL);
+	g_autoptr(GObject) obj3 = g_object_new(G_TYPE_OBJECT, NULL);
+	g_autoptr(GObject) obj_tmp = NULL;
+
+	/* siblings share the parent that was resolved first */
+	fu_context_set_udev_cache_enabled(ctx, TRUE);
+	obj_tmp = fu_context_add_udev_parent(ctx,
+					     "/sys/devices/pci0000:00/0000:00:14.0/usb1",
+					     "/sys/devices/pci0000:00/0000:00:14.0",
+					     obj1);
+	g_assert_true(obj_tmp == obj1);
+	g_clear_object(&obj_tmp);
+	obj_tmp = fu_context_add_udev_parent(ctx,
+					     "/sys/devices/pci0000:00/0000:00:14.0/usb2",
+					     "/sys/devices/pci0000:00/0000:00:14.0",
+					     obj2);
+	g_assert_true(obj_tmp == obj1);
+	g_clear_object(&obj_tmp);
+	obj_tmp = fu_context_add_udev_parent(ctx,
+					     "/sys/devices/pci0000:00/0000:00:14.1/usb3",
+					     "/sys/devices/pci0000:00/0000:00:14.1",
+					     obj3);
+	g_assert_true(obj_tmp == obj3);
+	g_clear_object(&obj_tmp);
+	obj_tmp = fu_context_lookup_udev_parent(ctx, "/sys/devices/pci0000:00/0000:00:14.0/usb2");
+	g_assert_true(obj_tmp == obj1);
+	g_clear_object(&obj_tmp);
+
+	/* parents and children are invalidated, but not siblings or similar prefixes */
+	fu_context_invalidate_udev_device(ctx, "/sys/devices/pci0000:00/0000:00:14.0/usb1/1-1");
+	obj_tmp = fu_context_lookup_udev_parent(ctx, "/sys/devices/pci0000:00/0000:00:14.0/usb1");
+	g_assert_null(obj_tmp);
+	obj_tmp = fu_context_lookup_udev_parent(ctx, "/sys/devices/pci0000:00/0000:00:14.0/usb2");
+	g_assert_null(obj_tmp);
+	obj_tmp = fu_context_lookup_udev_parent(ctx, "/sys/devices/pci0000:00/0000:00:14.1/usb3");
+	g_assert_true(obj_tmp == obj3);
+	g_clear_object(&obj_tmp);
+	fu_context_invalidate_udev_device(ctx, "/sys/devices/pci0000:00/0000:00:14");
+	obj_tmp = fu_context_lookup_udev_parent(ctx, "/sys/devices/pci0000:00/0000:00:14.1/usb3");
+	g_assert_true(obj_tmp == obj3);
+	g_clear_object(&obj_tmp);
+
+	/* nothing is shared once the coldplug is complete */
+	fu_context_set_udev_cache_enabled(ctx, FALSE);
+	obj_tmp = fu_context_lookup_udev_parent(ctx, "/sys/devices/pci0000:00/0000:00:14.1/usb3");
+	g_assert_null(obj_tmp);
+	obj_tmp = fu_context_add_udev_parent(ctx,
+					     "/sys/devices/pci0000:00/0000:00:14.0/usb1",
+					     "/sys/devices/pci0000:00/0000:00:14.0",
+					     obj2);
+	g_assert_true(obj_tmp == obj2);
+	g_clear_object(&obj_tmp);
+	obj_tmp = fu_context_lookup_udev_parent(ctx, "/sys/devices/pci0000:00/0000:00:14.0/usb1");
+	g_assert_null(obj_tmp);
+}
+
 static void
 fu_context_hwids_dmi_func(void)
 {
@@ -1180,6 +1308,104 @@ fu_plugin_quirks_performance_func(void)
 	g_print("lookup=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
 }
 
+static gpointer
+fu_plugin_quirks_threads_cb(gpointer user_data)
+{
+	FuQuirks *quirks = FU_QUIRKS(user_data);
+	for (guint i = 0; i < 1000; i++) {
+		const gchar *tmp = fu_quirks_lookup_by_id(quirks,
+							  "bb9ec3e2-77b3-53bc-a1f1-b05916715627",
+							  "Flags");
+		g_assert_cmpstr(tmp, ==, "clever");
+	}
+	return NULL;
+}
+
+static void
+fu_plugin_quirks_threads_func(void)
+{
+	gboolean ret;
+	GThread *threads[4] = {NULL};
+	g_autoptr(FuQuirks) quirks = fu_quirks_new();
+	g_autoptr(GError) error = NULL;
+
+	ret = fu_quirks_load(quirks, FU_QUIRKS_LOAD_FLAG_NO_CACHE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* lookup from several threads at the same time, all racing to rebuild the silo */
+	fu_quirks_invalidate(quirks);
+	for (guint i = 0; i < G_N_ELEMENTS(threads); i++)
+		threads[i] = g_thread_new("fu-quirks", fu_plugin_quirks_threads_cb, quirks);
+	for (guint i = 0; i < 5; i++) {
+		fu_quirks_invalidate(quirks);
+		g_usleep(1000);
+	}
+	for (guint i = 0; i < G_N_ELEMENTS(threads); i++)
+		g_thread_join(threads[i]);
+}
+
+static void
+fu_plugin_quirks_cache_reload(void)
+{
+	gboolean ret;
+	const gchar *tmp;
+	g_autoptr(FuQuirks) quirks = fu_quirks_new();
+	g_autoptr(GError) error = NULL;
+
+	ret = fu_quirks_load(quirks, FU_QUIRKS_LOAD_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	tmp = fu_quirks_lookup_by_id(quirks, "bb9ec3e2-77b3-53bc-a1f1-b05916715627", "Flags");
+	g_assert_cmpstr(tmp, ==, "clever");
+}
+
+static void
+fu_plugin_quirks_cache_func(void)
+{
+	gboolean ret;
+	gsize bufsz = 0;
+	gsize bufsz_new = 0;
+	g_autofree gchar *buf = NULL;
+	g_autofree gchar *buf_bad = NULL;
+	g_autofree gchar *buf_new = NULL;
+	g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *fn = g_build_filename(cachedirpkg, "quirks.xmlb.idx", NULL);
+	g_autoptr(GError) error = NULL;
+
+	/* create the on-disk index */
+	fu_plugin_quirks_cache_reload();
+	ret = g_file_get_contents(fn, &buf, &bufsz, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(bufsz, >, 64);
+
+	/* truncated, so it has to be rebuilt */
+	ret = g_file_set_contents(fn, buf, bufsz / 2, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_plugin_quirks_cache_reload();
+	ret = g_file_get_contents(fn, &buf_new, &bufsz_new, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(bufsz_new, ==, bufsz);
+	g_assert_cmpint(memcmp(buf_new, buf, bufsz), ==, 0);
+	g_clear_pointer(&buf_new, g_free);
+
+	/* same size but everything after the header is garbage */
+	buf_bad = g_memdup2(buf, bufsz);
+	memset(buf_bad + 64, 0xFF, bufsz - 64);
+	ret = g_file_set_contents(fn, buf_bad, bufsz, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_plugin_quirks_cache_reload();
+	ret = g_file_get_contents(fn, &buf_new, &bufsz_new, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(bufsz_new, ==, bufsz);
+	g_assert_cmpint(memcmp(buf_new, buf, bufsz), ==, 0);
+}
+
 typedef struct {
 	gboolean seen_one;
 	gboolean seen_two;
@@ -1330,6 +1556,130 @@ fu_plugin_backend_device_func(void)
 	g_assert_true(ret);
 }
 
+/* a plugin where the default ->backend_device_added() runs the nested ->device_created() */
+G_DECLARE_FINAL_TYPE(FuNestedPlugin, fu_nested_plugin, FU, NESTED_PLUGIN, FuPlugin)
+
+struct _FuNestedPlugin {
+	FuPlugin parent_instance;
+};
+
+G_DEFINE_TYPE(FuNestedPlugin, fu_nested_plugin, FU_TYPE_PLUGIN)
+
+static gboolean
+fu_nested_plugin_device_created(FuPlugin *plugin, FuDevice *device, GError **error)
+{
+	g_usleep(1000);
+	return TRUE;
+}
+
+static void
+fu_nested_plugin_init(FuNestedPlugin *self)
+{
+}
+
+static void
+fu_nested_plugin_class_init(FuNestedPluginClass *klass)
+{
+	FuPluginClass *plugin_class = FU_PLUGIN_CLASS(klass);
+	plugin_class->device_created = fu_nested_plugin_device_created;
+}
+
+static void
+fu_plugin_runner_stats_nested_func(void)
+{
+	gboolean ret;
+	gint64 begin_us;
+	guint64 elapsed_us;
+	guint64 outer_us = 0;
+	guint64 nested_us = 0;
+	GVariantBuilder builder;
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuDevice) device = fu_device_new(ctx);
+	g_autoptr(FuPlugin) plugin = fu_plugin_new_from_gtype(fu_nested_plugin_get_type(), ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRFUNC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) stats = NULL;
+
+	fu_device_set_specialized_gtype(device, FU_TYPE_DEVICE);
+	fu_device_add_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_ONLY_SUPPORTED);
+	begin_us = g_get_monotonic_time();
+	ret = fu_plugin_runner_backend_device_added(plugin, device, progress, &error);
+	elapsed_us = g_get_monotonic_time() - begin_us;
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* both vfuncs are shown */
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	fu_plugin_add_runner_stats(plugin, &builder);
+	stats = g_variant_ref_sink(g_variant_builder_end(&builder));
+	g_assert_cmpint(g_variant_n_children(stats), ==, 2);
+	for (guint i = 0; i < g_variant_n_children(stats); i++) {
+		const gchar *vfunc = NULL;
+		g_autoptr(GVariant) stat = g_variant_get_child_value(stats, i);
+		g_assert_true(g_variant_lookup(stat, "Vfunc", "&s", &vfunc));
+		if (g_strcmp0(vfunc, "backend_device_added") == 0)
+			g_assert_true(g_variant_lookup(stat, "TotalUs", "t", &outer_us));
+		else if (g_strcmp0(vfunc, "device_created") == 0)
+			g_assert_true(g_variant_lookup(stat, "TotalUs", "t", &nested_us));
+	}
+	g_assert_cmpint(nested_us, >=, 1000);
+	g_assert_cmpint(outer_us, >=, nested_us);
+
+	/* but the nested vfunc is only counted once, so the total fits in the elapsed time */
+	g_assert_cmpint(fu_plugin_get_runner_total_us(plugin), ==, outer_us);
+	g_assert_cmpint(fu_plugin_get_runner_total_us(plugin), <=, elapsed_us);
+}
+
+static void
+fu_plugin_runner_stats_func(void)
+{
+	gboolean ret;
+	const gchar *kind = NULL;
+	const gchar *vfunc = NULL;
+	guint64 cnt = 0;
+	guint64 cnt_error = 0;
+	GVariantBuilder builder;
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuDevice) device = fu_device_new(ctx);
+	g_autoptr(FuPlugin) plugin = fu_plugin_new(ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRFUNC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) stats = NULL;
+	g_autoptr(GVariant) stat = NULL;
+
+	/* nothing run yet */
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	fu_plugin_add_runner_stats(plugin, &builder);
+	stats = g_variant_ref_sink(g_variant_builder_end(&builder));
+	g_assert_cmpint(g_variant_n_children(stats), ==, 0);
+	g_clear_pointer(&stats, g_variant_unref);
+
+	/* run the superclassed ->backend_device_added() twice */
+	fu_device_set_specialized_gtype(device, FU_TYPE_DEVICE);
+	fu_device_add_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_ONLY_SUPPORTED);
+	for (guint i = 0; i < 2; i++) {
+		ret = fu_plugin_runner_backend_device_added(plugin, device, progress, &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+
+	/* the plugin has no name, so that is not included */
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	fu_plugin_add_runner_stats(plugin, &builder);
+	stats = g_variant_ref_sink(g_variant_builder_end(&builder));
+	g_assert_cmpint(g_variant_n_children(stats), ==, 1);
+	stat = g_variant_get_child_value(stats, 0);
+	g_assert_true(g_variant_lookup(stat, "Kind", "&s", &kind));
+	g_assert_cmpstr(kind, ==, "Plugin");
+	g_assert_false(g_variant_lookup(stat, "Name", "&s", NULL));
+	g_assert_true(g_variant_lookup(stat, "Vfunc", "&s", &vfunc));
+	g_assert_cmpstr(vfunc, ==, "backend_device_added");
+	g_assert_true(g_variant_lookup(stat, "Count", "t", &cnt));
+	g_assert_cmpint(cnt, ==, 2);
+	g_assert_true(g_variant_lookup(stat, "ErrorCount", "t", &cnt_error));
+	g_assert_cmpint(cnt_error, ==, 0);
+}
+
 static void
 _plugin_backend_proxy_device_added_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data)
 {
@@ -2158,6 +2508,43 @@ fu_chunk_array_func(void)
 	g_assert_null(chk4);
 }
 
+static void
+fu_chunk_array_stream_func(void)
+{
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(FuChunkArray) chunks = NULL;
+
+	/* larger than the read-ahead window */
+	for (guint i = 0; i < 0x30001; i++)
+		fu_byte_array_append_uint8(buf, i % 0xFB);
+	stream = g_memory_input_stream_new_from_data(buf->data, buf->len, NULL);
+	chunks = fu_chunk_array_new_from_stream(stream, 0x0, 0x40, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(chunks);
+	g_assert_cmpint(fu_chunk_array_length(chunks), ==, 0xC01);
+
+	/* forwards, then backwards */
+	for (guint j = 0; j < 2; j++) {
+		for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
+			guint idx = j == 0 ? i : fu_chunk_array_length(chunks) - (i + 1);
+			g_autoptr(FuChunk) chk = fu_chunk_array_index(chunks, idx, &error);
+			g_assert_no_error(error);
+			g_assert_nonnull(chk);
+			g_assert_cmpint(fu_chunk_get_address(chk), ==, idx * 0x40);
+			g_assert_cmpint(fu_chunk_get_data_sz(chk),
+					==,
+					MIN(0x40, buf->len - idx * 0x40));
+			g_assert_cmpint(memcmp(fu_chunk_get_data(chk),
+					       buf->data + fu_chunk_get_address(chk),
+					       fu_chunk_get_data_sz(chk)),
+					==,
+					0);
+		}
+	}
+}
+
 static void
 fu_chunk_func(void)
 {
@@ -2567,6 +2954,46 @@ fu_common_vercmp_func(void)
 	g_assert_cmpint(fu_version_compare(NULL, NULL, FWUPD_VERSION_FORMAT_UNKNOWN), ==, G_MAXINT);
 }
 
+static void
+fu_version_key_func(void)
+{
+	struct {
+		const gchar *version_a;
+		const gchar *version_b;
+		FwupdVersionFormat fmt;
+	} values[] = {{"1.2.3", "1.2.3", FWUPD_VERSION_FORMAT_UNKNOWN},
+		      {"001.002.003", "1.2.3", FWUPD_VERSION_FORMAT_UNKNOWN},
+		      {"0x00000002", "0x2", FWUPD_VERSION_FORMAT_HEX},
+		      {"1.2.3", "1.2.4", FWUPD_VERSION_FORMAT_UNKNOWN},
+		      {"1.2.3", "1.2.3.1", FWUPD_VERSION_FORMAT_UNKNOWN},
+		      {"1.2.3.1", "1.2.4", FWUPD_VERSION_FORMAT_UNKNOWN},
+		      {"1.2.3", "1.2.3a", FWUPD_VERSION_FORMAT_UNKNOWN},
+		      {"1.2a.3", "1.2b.3", FWUPD_VERSION_FORMAT_UNKNOWN},
+		      {"alpha", "beta", FWUPD_VERSION_FORMAT_UNKNOWN},
+		      {"1.2.3~rc1", "1.2.3", FWUPD_VERSION_FORMAT_UNKNOWN},
+		      {"1.2.3~rc2", "1.2.3~rc1", FWUPD_VERSION_FORMAT_UNKNOWN},
+		      {"ABC", "abc", FWUPD_VERSION_FORMAT_PLAIN},
+		      {NULL, NULL, FWUPD_VERSION_FORMAT_UNKNOWN}};
+
+	for (guint i = 0; values[i].version_a != NULL; i++) {
+		gint rc1 = fu_version_compare(values[i].version_a, values[i].version_b, values[i].fmt);
+		gint rc2 = fu_version_compare(values[i].version_b, values[i].version_a, values[i].fmt);
+		g_autoptr(FuVersionKey) key_a = fu_version_key_new(values[i].version_a, values[i].fmt);
+		g_autoptr(FuVersionKey) key_b = fu_version_key_new(values[i].version_b, values[i].fmt);
+
+		g_assert_cmpint(fu_version_key_compare(key_a, key_b), ==, rc1);
+		g_assert_cmpint(fu_version_key_compare(key_b, key_a), ==, rc2);
+		g_assert_cmpint(fu_version_key_compare_string(key_a, values[i].version_b), ==, rc1);
+		g_assert_cmpint(fu_version_key_compare_string(key_b, values[i].version_a), ==, rc2);
+		g_assert_true(fu_version_key_matches(key_a, values[i].version_a, values[i].fmt));
+		g_assert_false(fu_version_key_matches(key_a, "9.9.9", values[i].fmt));
+	}
+
+	/* invalid */
+	g_assert_null(fu_version_key_new(NULL, FWUPD_VERSION_FORMAT_UNKNOWN));
+	g_assert_cmpint(fu_version_key_compare(NULL, NULL), ==, G_MAXINT);
+}
+
 static void
 fu_firmware_raw_aligned_func(void)
 {
@@ -3606,6 +4033,8 @@ fu_efivar_func(void)
 {
 	gboolean ret;
 	gsize sz = 0;
+	guint hits;
+	guint misses;
 	guint32 attr = 0;
 	guint64 total;
 	g_autofree gchar *sysfsfwdir = NULL;
@@ -3658,6 +4087,33 @@ fu_efivar_func(void)
 	g_assert_cmpint(attr, ==, FU_EFIVAR_ATTR_NON_VOLATILE | FU_EFIVAR_ATTR_RUNTIME_ACCESS);
 	g_assert_cmpint(data[0], ==, '1');
 
+	/* read again from the cache */
+	hits = fu_efivar_get_cache_hits();
+	g_clear_pointer(&data, g_free);
+	ret = fu_efivar_get_data(FU_EFIVAR_GUID_EFI_GLOBAL, "Test", &data, &sz, &attr, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_efivar_get_cache_hits(), ==, hits + 1);
+	g_assert_cmpint(sz, ==, 1);
+	g_assert_cmpint(data[0], ==, '1');
+
+	/* writing invalidates the cache */
+	ret = fu_efivar_set_data(FU_EFIVAR_GUID_EFI_GLOBAL,
+				 "Test",
+				 (guint8 *)"2",
+				 1,
+				 FU_EFIVAR_ATTR_NON_VOLATILE | FU_EFIVAR_ATTR_RUNTIME_ACCESS,
+				 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	misses = fu_efivar_get_cache_misses();
+	g_clear_pointer(&data, g_free);
+	ret = fu_efivar_get_data(FU_EFIVAR_GUID_EFI_GLOBAL, "Test", &data, &sz, &attr, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_efivar_get_cache_misses(), ==, misses + 1);
+	g_assert_cmpint(data[0], ==, '2');
+
 	/* delete single key */
 	ret = fu_efivar_delete(FU_EFIVAR_GUID_EFI_GLOBAL, "Test", &error);
 	g_assert_no_error(error);
@@ -3782,6 +4238,73 @@ fu_device_retry_hardware_func(void)
 	g_assert_cmpint(helper.cnt_failed, ==, 2);
 }
 
+static void
+fu_device_sleep_emulated_func(void)
+{
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuDevice) device = fu_device_new(ctx);
+
+	/* no delay is performed, but it is recorded */
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_EMULATED);
+	fu_device_sleep(device, 5000);
+	g_assert_cmpint(fu_context_get_sleep_skipped(ctx), ==, 5000);
+}
+
+static void
+fu_device_retry_backoff_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuDevice) device = fu_device_new(NULL);
+	g_autoptr(FuDevice) device_new = fu_device_new(NULL);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) metadata = NULL;
+	FuDeviceRetryHelper helper = {
+	    .cnt_success = 0,
+	    .cnt_failed = 0,
+	};
+
+	/* ready on the 3rd try, after 1ms then 2ms */
+	ret = fu_device_retry_backoff(device,
+				      fu_device_retry_success_3rd_try,
+				      1,
+				      10,
+				      &helper,
+				      &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(helper.cnt_success, ==, 1);
+	g_assert_cmpint(helper.cnt_failed, ==, 2);
+
+	/* never ready, so give up once the delays add up to the timeout */
+	helper.cnt_failed = 0;
+	ret = fu_device_retry_backoff(device, fu_device_retry_failed, 1, 10, &helper, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL);
+	g_assert_false(ret);
+	g_assert_cmpint(helper.cnt_failed, ==, 5);
+
+	/* time spent waiting is reported */
+	metadata = fu_device_report_metadata_post(device);
+	g_assert_nonnull(metadata);
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "DeviceSleepMs"), ==, "13");
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "DeviceRetryCount"), ==, "6");
+	g_clear_pointer(&metadata, g_hash_table_unref);
+
+	/* kept when the device is replugged */
+	fu_device_replace(device_new, device);
+	metadata = fu_device_report_metadata_post(device_new);
+	g_assert_nonnull(metadata);
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "DeviceSleepMs"), ==, "13");
+	g_clear_pointer(&metadata, g_hash_table_unref);
+
+	/* only counted for the next update */
+	ret = fu_device_prepare(device, progress, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	metadata = fu_device_report_metadata_post(device);
+	g_assert_null(metadata);
+}
+
 static void
 fu_bios_settings_load_func(void)
 {
@@ -4208,8 +4731,12 @@ fu_security_attrs_compare_func(void)
 	fwupd_security_attr_set_result(attr4, FWUPD_SECURITY_ATTR_RESULT_NOT_ENABLED);
 	fu_security_attrs_append(attrs2, attr4);
 
+	/* appending does not look at the existing attrs */
+	g_assert_cmpint(fu_security_attrs_get_lookup_count(attrs1), ==, 0);
+
 	results = fu_security_attrs_compare(attrs1, attrs2);
 	g_assert_cmpint(results->len, ==, 3);
+	g_assert_cmpint(fu_security_attrs_get_lookup_count(attrs1), ==, 1);
 	attr_tmp = g_ptr_array_index(results, 0);
 	g_assert_cmpstr(fwupd_security_attr_get_appstream_id(attr_tmp), ==, "org.fwupd.hsi.bar");
 	g_assert_cmpint(fwupd_security_attr_get_result_fallback(attr_tmp),
@@ -4372,6 +4899,136 @@ fu_firmware_builder_round_trip_func(void)
 	}
 }
 
+static void
+fu_cab_firmware_compressed_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuCabFirmware) cab1 = fu_cab_firmware_new();
+	g_autoptr(FuCabFirmware) cab2 = fu_cab_firmware_new();
+	g_autoptr(FuCabImage) img = fu_cab_image_new();
+	g_autoptr(FuFirmware) img_tmp = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob1 = NULL;
+	g_autoptr(GBytes) blob2 = NULL;
+	g_autoptr(GBytes) blob3 = NULL;
+	g_autoptr(GBytes) blob_img = NULL;
+	g_autoptr(GBytes) blob_tmp = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* enough data for several CFDATA blocks */
+	for (guint i = 0; i < 0x28000; i++)
+		fu_byte_array_append_uint8(buf, (guint8)((i * 7) ^ (i >> 9)));
+	blob_img = g_bytes_new(buf->data, buf->len);
+	fu_firmware_set_id(FU_FIRMWARE(img), "firmware.bin");
+	fu_firmware_set_bytes(FU_FIRMWARE(img), blob_img);
+	fu_cab_firmware_set_compressed(cab1, TRUE);
+	ret = fu_firmware_add_image_full(FU_FIRMWARE(cab1), FU_FIRMWARE(img), &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* compress every block in this thread */
+	fu_cab_firmware_set_max_threads(cab1, 1);
+	blob1 = fu_firmware_write(FU_FIRMWARE(cab1), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob1);
+
+	/* the blocks are compressed in parallel, but the output is the same as serially */
+	fu_cab_firmware_set_max_threads(cab1, 4);
+	blob2 = fu_firmware_write(FU_FIRMWARE(cab1), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob2);
+	ret = fu_bytes_compare(blob2, blob1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* and also when using the default of one thread per CPU */
+	fu_cab_firmware_set_max_threads(cab1, 0);
+	blob3 = fu_firmware_write(FU_FIRMWARE(cab1), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob3);
+	ret = fu_bytes_compare(blob3, blob1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* decompress */
+	ret = fu_firmware_parse(FU_FIRMWARE(cab2), blob1, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	img_tmp = fu_firmware_get_image_by_id(FU_FIRMWARE(cab2), "firmware.bin", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(img_tmp);
+	blob_tmp = fu_firmware_get_bytes(img_tmp, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_tmp);
+	ret = fu_bytes_compare(blob_tmp, blob_img, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
+static void
+fu_ifd_firmware_lazy_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *csum1 = NULL;
+	g_autofree gchar *csum2 = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autofree gchar *xml = NULL;
+	g_autoptr(FuFirmware) firmware1 = fu_ifd_firmware_new();
+	g_autoptr(FuFirmware) firmware2 = fu_ifd_firmware_new();
+	g_autoptr(FuFirmware) img_bios = NULL;
+	g_autoptr(FuFirmware) img_raw = NULL;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) imgs = NULL;
+
+	filename = g_test_build_filename(G_TEST_DIST, "tests", "ifd.builder.xml", NULL);
+	ret = g_file_get_contents(filename, &xml, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_firmware_build_from_xml(firmware1, xml, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob = fu_firmware_write(firmware1, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob);
+
+	/* only the region layout is parsed */
+	fu_ifd_firmware_set_lazy_regions(FU_IFD_FIRMWARE(firmware2), TRUE);
+	ret = fu_firmware_parse(firmware2, blob, FWUPD_INSTALL_FLAG_NO_SEARCH, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	img_raw = fu_firmware_get_image_by_idx(firmware2, FU_IFD_REGION_BIOS, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(img_raw);
+	g_assert_false(fu_firmware_has_flag(img_raw, FU_FIRMWARE_FLAG_DONE_PARSE));
+	imgs = fu_firmware_get_images(img_raw);
+	g_assert_cmpint(imgs->len, ==, 0);
+	g_clear_pointer(&imgs, g_ptr_array_unref);
+
+	/* checksum is of the raw region, and is the same when parsed */
+	csum1 = fu_ifd_firmware_get_region_checksum(FU_IFD_FIRMWARE(firmware2),
+						    FU_IFD_REGION_BIOS,
+						    G_CHECKSUM_SHA256,
+						    &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(csum1);
+	img_bios =
+	    fu_ifd_firmware_get_region(FU_IFD_FIRMWARE(firmware2), FU_IFD_REGION_BIOS, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(img_bios);
+	g_assert_true(FU_IS_IFD_BIOS(img_bios));
+	g_assert_true(img_bios == img_raw);
+	g_assert_cmpint(fu_firmware_get_addr(img_bios), ==, 0x1000);
+	imgs = fu_firmware_get_images(img_bios);
+	g_assert_cmpint(imgs->len, ==, 2);
+	csum2 = fu_ifd_firmware_get_region_checksum(FU_IFD_FIRMWARE(firmware2),
+						    FU_IFD_REGION_BIOS,
+						    G_CHECKSUM_SHA256,
+						    &error);
+	g_assert_no_error(error);
+	g_assert_cmpstr(csum1, ==, csum2);
+}
+
 typedef struct {
 	guint last_percentage;
 	guint updates;
@@ -5330,6 +5987,27 @@ fu_efi_load_option_func(void)
 	}
 }
 
+static void
+fu_efivar_boot_entries_func(void)
+{
+	guint64 idx_last = 0;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) entries = NULL;
+
+	/* only the BootXXXX names, and not BootNext */
+	entries = fu_efivar_get_boot_entries(&error);
+	g_assert_no_error(error);
+	g_assert_nonnull(entries);
+	for (guint i = 0; i < entries->len; i++) {
+		FuFirmware *loadopt = g_ptr_array_index(entries, i);
+		g_assert_true(FU_IS_EFI_LOAD_OPTION(loadopt));
+		g_assert_cmpint(fu_firmware_get_idx(loadopt), <, 3);
+		if (i > 0)
+			g_assert_cmpint(fu_firmware_get_idx(loadopt), >, idx_last);
+		idx_last = fu_firmware_get_idx(loadopt);
+	}
+}
+
 int
 main(int argc, char **argv)
 {
@@ -5384,6 +6062,8 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/plugin{vfuncs}", fu_plugin_vfuncs_func);
 	g_test_add_func("/fwupd/plugin{device-gtype}", fu_plugin_device_gtype_func);
 	g_test_add_func("/fwupd/plugin{backend-device}", fu_plugin_backend_device_func);
+	g_test_add_func("/fwupd/plugin{runner-stats}", fu_plugin_runner_stats_func);
+	g_test_add_func("/fwupd/plugin{runner-stats-nested}", fu_plugin_runner_stats_nested_func);
 	g_test_add_func("/fwupd/plugin{backend-proxy-device}", fu_plugin_backend_proxy_device_func);
 	g_test_add_func("/fwupd/plugin{config}", fu_plugin_config_func);
 	g_test_add_func("/fwupd/plugin{devices}", fu_plugin_devices_func);
@@ -5393,10 +6073,13 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/plugin{quirks}", fu_plugin_quirks_func);
 	g_test_add_func("/fwupd/plugin{fdt}", fu_plugin_fdt_func);
 	g_test_add_func("/fwupd/plugin{quirks-performance}", fu_plugin_quirks_performance_func);
+	g_test_add_func("/fwupd/plugin{quirks-threads}", fu_plugin_quirks_threads_func);
+	g_test_add_func("/fwupd/plugin{quirks-cache}", fu_plugin_quirks_cache_func);
 	g_test_add_func("/fwupd/plugin{quirks-device}", fu_plugin_quirks_device_func);
 	g_test_add_func("/fwupd/backend", fu_backend_func);
 	g_test_add_func("/fwupd/chunk", fu_chunk_func);
 	g_test_add_func("/fwupd/chunks", fu_chunk_array_func);
+	g_test_add_func("/fwupd/chunks{stream}", fu_chunk_array_stream_func);
 	g_test_add_func("/fwupd/common{align-up}", fu_common_align_up_func);
 	g_test_add_func("/fwupd/volume{gpt-type}", fu_volume_gpt_type_func);
 	g_test_add_func("/fwupd/common{byte-array}", fu_common_byte_array_func);
@@ -5408,18 +6091,21 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/common{version}", fu_common_version_func);
 	g_test_add_func("/fwupd/common{version-semver}", fu_version_semver_func);
 	g_test_add_func("/fwupd/common{vercmp}", fu_common_vercmp_func);
+	g_test_add_func("/fwupd/common{version-key}", fu_version_key_func);
 	g_test_add_func("/fwupd/common{strstrip}", fu_strstrip_func);
 	g_test_add_func("/fwupd/common{endian}", fu_common_endian_func);
 	g_test_add_func("/fwupd/common{bytes-get-data}", fu_common_bytes_get_data_func);
 	g_test_add_func("/fwupd/common{kernel-lockdown}", fu_common_kernel_lockdown_func);
 	g_test_add_func("/fwupd/common{strsafe}", fu_strsafe_func);
 	g_test_add_func("/fwupd/efi-load-option", fu_efi_load_option_func);
+	g_test_add_func("/fwupd/efivar{boot-entries}", fu_efivar_boot_entries_func);
 	g_test_add_func("/fwupd/efivar", fu_efivar_func);
 	g_test_add_func("/fwupd/hwids", fu_hwids_func);
 	g_test_add_func("/fwupd/context{flags}", fu_context_flags_func);
 	g_test_add_func("/fwupd/context{hwids-dmi}", fu_context_hwids_dmi_func);
 	g_test_add_func("/fwupd/context{firmware-gtypes}", fu_context_firmware_gtypes_func);
 	g_test_add_func("/fwupd/context{state}", fu_context_state_func);
+	g_test_add_func("/fwupd/context{udev-devices}", fu_context_udev_devices_func);
 	g_test_add_func("/fwupd/string{utf16}", fu_string_utf16_func);
 	g_test_add_func("/fwupd/smbios", fu_smbios_func);
 	g_test_add_func("/fwupd/smbios3", fu_smbios3_func);
@@ -5449,10 +6135,13 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/firmware{dfu-patch}", fu_firmware_dfu_patch_func);
 	g_test_add_func("/fwupd/firmware{dfuse}", fu_firmware_dfuse_func);
 	g_test_add_func("/fwupd/firmware{builder-round-trip}", fu_firmware_builder_round_trip_func);
+	g_test_add_func("/fwupd/firmware{ifd-lazy}", fu_ifd_firmware_lazy_func);
+	g_test_add_func("/fwupd/firmware{cab-compressed}", fu_cab_firmware_compressed_func);
 	g_test_add_func("/fwupd/firmware{fmap}", fu_firmware_fmap_func);
 	g_test_add_func("/fwupd/firmware{gtypes}", fu_firmware_new_from_gtypes_func);
 	g_test_add_func("/fwupd/archive{invalid}", fu_archive_invalid_func);
 	g_test_add_func("/fwupd/archive{cab}", fu_archive_cab_func);
+	g_test_add_func("/fwupd/archive{lazy}", fu_archive_lazy_func);
 	g_test_add_func("/fwupd/device", fu_device_func);
 	g_test_add_func("/fwupd/device{vfuncs}", fu_device_vfuncs_func);
 	g_test_add_func("/fwupd/device{instance-ids}", fu_device_instance_ids_func);
@@ -5476,6 +6165,8 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/device{retry-success}", fu_device_retry_success_func);
 	g_test_add_func("/fwupd/device{retry-failed}", fu_device_retry_failed_func);
 	g_test_add_func("/fwupd/device{retry-hardware}", fu_device_retry_hardware_func);
+	g_test_add_func("/fwupd/device{retry-backoff}", fu_device_retry_backoff_func);
+	g_test_add_func("/fwupd/device{sleep-emulated}", fu_device_sleep_emulated_func);
 	g_test_add_func("/fwupd/device{cfi-device}", fu_device_cfi_device_func);
 	g_test_add_func("/fwupd/device{progress}", fu_plugin_device_progress_func);
 	return g_test_run();
@@ -21,6 +21,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "fu-context-private.h"
 #include "fu-device-private.h"
 #include "fu-i2c-device.h"
 #include "fu-string.h"
@@ -89,14 +90,100 @@ fu_udev_device_emit_changed(FuUdevDevice *self)
 }
 
 #ifdef HAVE_GUDEV
+/* during coldplug the parent nodes are shared between devices so that each parent is only
+ * resolved once and each sysfs attribute is only read once; the nodes are dropped when the
+ * coldplug is complete and so are never used from the install threads */
+static GUdevDevice *
+fu_udev_device_get_parent_cached(FuUdevDevice *self, GUdevDevice *udev_device)
+{
+	FuContext *ctx = fu_device_get_context(FU_DEVICE(self));
+	const gchar *sysfs_path = g_udev_device_get_sysfs_path(udev_device);
+	const gchar *parent_sysfs_path;
+	GObject *udev_parent_cached;
+	g_autoptr(GUdevDevice) udev_parent = NULL;
+
+	if (ctx == NULL || sysfs_path == NULL || !fu_context_get_udev_cache_enabled(ctx))
+		return g_udev_device_get_parent(udev_device);
+	udev_parent_cached = fu_context_lookup_udev_parent(ctx, sysfs_path);
+	if (udev_parent_cached != NULL)
+		return G_UDEV_DEVICE(udev_parent_cached);
+	udev_parent = g_udev_device_get_parent(udev_device);
+	if (udev_parent == NULL)
+		return NULL;
+	parent_sysfs_path = g_udev_device_get_sysfs_path(udev_parent);
+	if (parent_sysfs_path == NULL)
+		return g_steal_pointer(&udev_parent);
+	return G_UDEV_DEVICE(
+	    fu_context_add_udev_parent(ctx, sysfs_path, parent_sysfs_path, G_OBJECT(udev_parent)));
+}
+
+/* the gudev attribute cache is only valid while the nodes are shared during coldplug */
+static const gchar *
+fu_udev_device_read_sysfs_attr(FuUdevDevice *self, GUdevDevice *udev_device, const gchar *attr)
+{
+#ifdef HAVE_GUDEV_234
+	FuContext *ctx = fu_device_get_context(FU_DEVICE(self));
+	if (ctx == NULL || !fu_context_get_udev_cache_enabled(ctx))
+		return g_udev_device_get_sysfs_attr_uncached(udev_device, attr);
+#endif
+	return g_udev_device_get_sysfs_attr(udev_device, attr);
+}
+
+static gboolean
+fu_udev_device_match_subsystem_devtype(GUdevDevice *udev_device,
+				       const gchar *subsystem,
+				       const gchar *devtype)
+{
+	if (subsystem != NULL) {
+		if (g_strcmp0(g_udev_device_get_subsystem(udev_device), subsystem) != 0)
+			return FALSE;
+	}
+	if (devtype != NULL) {
+		if (g_strcmp0(g_udev_device_get_devtype(udev_device), devtype) != 0)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static GUdevDevice *
+fu_udev_device_get_parent_with_subsystem_devtype(FuUdevDevice *self,
+						 GUdevDevice *udev_device,
+						 const gchar *subsystem,
+						 const gchar *devtype)
+{
+	g_autoptr(GUdevDevice) udev_device_tmp = g_object_ref(udev_device);
+	while (udev_device_tmp != NULL) {
+		g_autoptr(GUdevDevice) parent = NULL;
+		if (fu_udev_device_match_subsystem_devtype(udev_device_tmp, subsystem, devtype))
+			return g_object_ref(udev_device_tmp);
+		parent = fu_udev_device_get_parent_cached(self, udev_device_tmp);
+		g_set_object(&udev_device_tmp, parent);
+	}
+	return NULL;
+}
+
+/* like g_udev_device_get_parent_with_subsystem() but using the shared parent nodes */
+static GUdevDevice *
+fu_udev_device_get_parent_with_subsystem_cached(FuUdevDevice *self,
+						GUdevDevice *udev_device,
+						const gchar *subsystem)
+{
+	g_autoptr(GUdevDevice) udev_parent = fu_udev_device_get_parent_cached(self, udev_device);
+	if (udev_parent == NULL)
+		return NULL;
+	return fu_udev_device_get_parent_with_subsystem_devtype(self, udev_parent, subsystem, NULL);
+}
+
 static guint32
-fu_udev_device_get_sysfs_attr_as_uint32(GUdevDevice *udev_device, const gchar *name)
+fu_udev_device_get_sysfs_attr_as_uint32(FuUdevDevice *self,
+					GUdevDevice *udev_device,
+					const gchar *name)
 {
 	const gchar *tmp;
 	guint64 tmp64 = 0;
 	g_autoptr(GError) error_local = NULL;
 
-	tmp = g_udev_device_get_sysfs_attr(udev_device, name);
+	tmp = fu_udev_device_read_sysfs_attr(self, udev_device, name);
 	if (tmp == NULL)
 		return 0x0;
 	if (!fu_strtoull(tmp, &tmp64, 0, G_MAXUINT32, &error_local)) {
@@ -107,13 +194,15 @@ fu_udev_device_get_sysfs_attr_as_uint32(GUdevDevice *udev_device, const gchar *n
 }
 
 static guint16
-fu_udev_device_get_sysfs_attr_as_uint16(GUdevDevice *udev_device, const gchar *name)
+fu_udev_device_get_sysfs_attr_as_uint16(FuUdevDevice *self,
+					GUdevDevice *udev_device,
+					const gchar *name)
 {
 	const gchar *tmp;
 	guint64 tmp64 = 0;
 	g_autoptr(GError) error_local = NULL;
 
-	tmp = g_udev_device_get_sysfs_attr(udev_device, name);
+	tmp = fu_udev_device_read_sysfs_attr(self, udev_device, name);
 	if (tmp == NULL)
 		return 0x0;
 	if (!fu_strtoull(tmp, &tmp64, 0, G_MAXUINT16, &error_local)) {
@@ -124,13 +213,15 @@ fu_udev_device_get_sysfs_attr_as_uint16(GUdevDevice *udev_device, const gchar *n
 }
 
 static guint8
-fu_udev_device_get_sysfs_attr_as_uint8(GUdevDevice *udev_device, const gchar *name)
+fu_udev_device_get_sysfs_attr_as_uint8(FuUdevDevice *self,
+					GUdevDevice *udev_device,
+					const gchar *name)
 {
 	const gchar *tmp;
 	guint64 tmp64 = 0;
 	g_autoptr(GError) error_local = NULL;
 
-	tmp = g_udev_device_get_sysfs_attr(udev_device, name);
+	tmp = fu_udev_device_read_sysfs_attr(self, udev_device, name);
 	if (tmp == NULL)
 		return 0x0;
 	if (!fu_strtoull(tmp, &tmp64, 0, G_MAXUINT8, &error_local)) {
@@ -341,14 +432,14 @@ static void
 fu_udev_device_set_vendor_from_udev_device(FuUdevDevice *self, GUdevDevice *udev_device)
 {
 	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
-	priv->vendor = fu_udev_device_get_sysfs_attr_as_uint16(udev_device, "vendor");
-	priv->model = fu_udev_device_get_sysfs_attr_as_uint16(udev_device, "device");
-	priv->revision = fu_udev_device_get_sysfs_attr_as_uint8(udev_device, "revision");
-	priv->class = fu_udev_device_get_sysfs_attr_as_uint32(udev_device, "class");
+	priv->vendor = fu_udev_device_get_sysfs_attr_as_uint16(self, udev_device, "vendor");
+	priv->model = fu_udev_device_get_sysfs_attr_as_uint16(self, udev_device, "device");
+	priv->revision = fu_udev_device_get_sysfs_attr_as_uint8(self, udev_device, "revision");
+	priv->class = fu_udev_device_get_sysfs_attr_as_uint32(self, udev_device, "class");
 	priv->subsystem_vendor =
-	    fu_udev_device_get_sysfs_attr_as_uint16(udev_device, "subsystem_vendor");
+	    fu_udev_device_get_sysfs_attr_as_uint16(self, udev_device, "subsystem_vendor");
 	priv->subsystem_model =
-	    fu_udev_device_get_sysfs_attr_as_uint16(udev_device, "subsystem_device");
+	    fu_udev_device_get_sysfs_attr_as_uint16(self, udev_device, "subsystem_device");
 
 	/* fallback to properties as udev might be using a subsystem-specific prober */
 	if (priv->vendor == 0x0)
@@ -365,7 +456,7 @@ fu_udev_device_set_vendor_from_parent(FuUdevDevice *self)
 	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
 	g_autoptr(GUdevDevice) udev_device = g_object_ref(priv->udev_device);
 	while (TRUE) {
-		g_autoptr(GUdevDevice) parent = g_udev_device_get_parent(udev_device);
+		g_autoptr(GUdevDevice) parent = fu_udev_device_get_parent_cached(self, udev_device);
 		if (parent == NULL)
 			break;
 		fu_udev_device_set_vendor_from_udev_device(self, parent);
@@ -395,7 +486,7 @@ fu_udev_device_probe(FuDevice *device, GError **error)
 #ifdef HAVE_GUDEV
 	/* get IDs, but fallback to the parent, grandparent, great-grandparent, etc */
 	fu_udev_device_set_vendor_from_udev_device(self, priv->udev_device);
-	udev_parent = g_udev_device_get_parent(priv->udev_device);
+	udev_parent = fu_udev_device_get_parent_cached(self, priv->udev_device);
 	if (udev_parent != NULL && priv->flags & FU_UDEV_DEVICE_FLAG_VENDOR_FROM_PARENT)
 		fu_udev_device_set_vendor_from_parent(self);
 
@@ -437,7 +528,7 @@ fu_udev_device_probe(FuDevice *device, GError **error)
 	    fu_device_get_version(device) == NULL) {
 		const gchar *version;
 
-		version = g_udev_device_get_sysfs_attr(priv->udev_device, "vbios_version");
+		version = fu_udev_device_read_sysfs_attr(self, priv->udev_device, "vbios_version");
 		if (version != NULL) {
 			fu_device_set_version(device, version);
 			fu_device_set_version_format(device, FWUPD_VERSION_FORMAT_PLAIN);
@@ -485,7 +576,7 @@ fu_udev_device_probe(FuDevice *device, GError **error)
 				fu_device_set_vendor(device, tmp);
 				break;
 			}
-			parent = g_udev_device_get_parent(device_tmp);
+			parent = fu_udev_device_get_parent_cached(self, device_tmp);
 			if (parent == NULL)
 				break;
 			g_set_object(&device_tmp, parent);
@@ -590,7 +681,7 @@ fu_udev_device_probe(FuDevice *device, GError **error)
 
 	/* add device class */
 	if (subsystem != NULL) {
-		tmp = g_udev_device_get_sysfs_attr(priv->udev_device, "class");
+		tmp = fu_udev_device_read_sysfs_attr(self, priv->udev_device, "class");
 		if (tmp != NULL && g_str_has_prefix(tmp, "0x"))
 			tmp += 2;
 		fu_device_add_instance_strup(device, "CLASS", tmp);
@@ -646,7 +737,8 @@ fu_udev_device_probe(FuDevice *device, GError **error)
 	}
 
 	/* determine if we're wired internally */
-	parent_i2c = g_udev_device_get_parent_with_subsystem(priv->udev_device, "i2c", NULL);
+	parent_i2c =
+	    fu_udev_device_get_parent_with_subsystem_cached(self, priv->udev_device, "i2c");
 	if (parent_i2c != NULL)
 		fu_device_add_flag(device, FWUPD_DEVICE_FLAG_INTERNAL);
 #endif
@@ -741,12 +833,12 @@ fu_udev_device_set_dev(FuUdevDevice *self, GUdevDevice *udev_device)
 	}
 
 	/* try to get one line summary */
-	summary = g_udev_device_get_sysfs_attr(priv->udev_device, "description");
+	summary = fu_udev_device_read_sysfs_attr(self, priv->udev_device, "description");
 	if (summary == NULL) {
 		g_autoptr(GUdevDevice) parent = NULL;
-		parent = g_udev_device_get_parent(priv->udev_device);
+		parent = fu_udev_device_get_parent_cached(self, priv->udev_device);
 		if (parent != NULL)
-			summary = g_udev_device_get_sysfs_attr(parent, "description");
+			summary = fu_udev_device_read_sysfs_attr(self, parent, "description");
 	}
 	if (summary != NULL)
 		fu_device_set_summary(FU_DEVICE(self), summary);
@@ -771,11 +863,11 @@ fu_udev_device_get_slot_depth(FuUdevDevice *self, const gchar *subsystem)
 	GUdevDevice *udev_device = fu_udev_device_get_dev(FU_UDEV_DEVICE(self));
 	g_autoptr(GUdevDevice) device_tmp = NULL;
 
-	device_tmp = g_udev_device_get_parent_with_subsystem(udev_device, subsystem, NULL);
+	device_tmp = fu_udev_device_get_parent_with_subsystem_cached(self, udev_device, subsystem);
 	if (device_tmp == NULL)
 		return 0;
 	for (guint i = 0; i < 0xff; i++) {
-		g_autoptr(GUdevDevice) parent = g_udev_device_get_parent(device_tmp);
+		g_autoptr(GUdevDevice) parent = fu_udev_device_get_parent_cached(self, device_tmp);
 		if (parent == NULL)
 			return i;
 		g_set_object(&device_tmp, parent);
@@ -1233,7 +1325,7 @@ fu_udev_device_get_parent_subsystems(FuUdevDevice *self)
 	if (priv->subsystem != NULL)
 		g_string_append_printf(str, "%s,", priv->subsystem);
 	while (TRUE) {
-		g_autoptr(GUdevDevice) parent = g_udev_device_get_parent(udev_device);
+		g_autoptr(GUdevDevice) parent = fu_udev_device_get_parent_cached(self, udev_device);
 		if (parent == NULL)
 			break;
 		if (g_udev_device_get_subsystem(parent) != NULL) {
@@ -1245,38 +1337,6 @@ fu_udev_device_get_parent_subsystems(FuUdevDevice *self)
 		g_string_truncate(str, str->len - 1);
 	return g_string_free(str, FALSE);
 }
-
-static gboolean
-fu_udev_device_match_subsystem_devtype(GUdevDevice *udev_device,
-				       const gchar *subsystem,
-				       const gchar *devtype)
-{
-	if (subsystem != NULL) {
-		if (g_strcmp0(g_udev_device_get_subsystem(udev_device), subsystem) != 0)
-			return FALSE;
-	}
-	if (devtype != NULL) {
-		if (g_strcmp0(g_udev_device_get_devtype(udev_device), devtype) != 0)
-			return FALSE;
-	}
-	return TRUE;
-}
-
-static GUdevDevice *
-fu_udev_device_get_parent_with_subsystem_devtype(GUdevDevice *udev_device,
-						 const gchar *subsystem,
-						 const gchar *devtype)
-{
-	g_autoptr(GUdevDevice) udev_device_tmp = g_object_ref(udev_device);
-	while (udev_device_tmp != NULL) {
-		g_autoptr(GUdevDevice) parent = NULL;
-		if (fu_udev_device_match_subsystem_devtype(udev_device_tmp, subsystem, devtype))
-			return g_object_ref(udev_device_tmp);
-		parent = g_udev_device_get_parent(udev_device_tmp);
-		g_set_object(&udev_device_tmp, parent);
-	}
-	return NULL;
-}
 #endif
 
 /**
@@ -1322,7 +1382,8 @@ fu_udev_device_set_physical_id(FuUdevDevice *self, const gchar *subsystems, GErr
 		g_auto(GStrv) subsys_devtype = g_strsplit(split[i], ":", 2);
 
 		/* matching on devtype is optional */
-		udev_device = fu_udev_device_get_parent_with_subsystem_devtype(priv->udev_device,
+		udev_device = fu_udev_device_get_parent_with_subsystem_devtype(self,
+									       priv->udev_device,
 									       subsys_devtype[0],
 									       subsys_devtype[1]);
 		if (udev_device != NULL) {
@@ -1442,8 +1503,9 @@ fu_udev_device_set_logical_id(FuUdevDevice *self, const gchar *subsystem, GError
 	if (g_strcmp0(priv->subsystem, subsystem) == 0) {
 		udev_device = g_object_ref(priv->udev_device);
 	} else {
-		udev_device =
-		    g_udev_device_get_parent_with_subsystem(priv->udev_device, subsystem, NULL);
+		udev_device = fu_udev_device_get_parent_with_subsystem_cached(self,
+									      priv->udev_device,
+									      subsystem);
 	}
 	if (udev_device == NULL) {
 		g_set_error(error,
@@ -1974,7 +2036,7 @@ fu_udev_device_get_parent_name(FuUdevDevice *self)
 
 	if (priv->udev_device == NULL)
 		return NULL;
-	parent = g_udev_device_get_parent(priv->udev_device);
+	parent = fu_udev_device_get_parent_cached(self, priv->udev_device);
 	return parent == NULL ? NULL : g_strdup(g_udev_device_get_name(parent));
 #else
 	return NULL;
@@ -2009,7 +2071,7 @@ fu_udev_device_get_sysfs_attr(FuUdevDevice *self, const gchar *attr, GError **er
 		g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND, "not initialized");
 		return NULL;
 	}
-	result = g_udev_device_get_sysfs_attr(priv->udev_device, attr);
+	result = fu_udev_device_read_sysfs_attr(self, priv->udev_device, attr);
 	if (result == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
@@ -2197,7 +2259,7 @@ fu_udev_device_get_siblings_with_subsystem(FuUdevDevice *self,
 		g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND, "not initialized");
 		return NULL;
 	}
-	udev_parent = g_udev_device_get_parent(priv->udev_device);
+	udev_parent = fu_udev_device_get_parent_cached(self, priv->udev_device);
 	if (udev_parent == NULL)
 		return g_steal_pointer(&out);
 	udev_parent_path = g_udev_device_get_sysfs_path(udev_parent);
@@ -2208,7 +2270,7 @@ fu_udev_device_get_siblings_with_subsystem(FuUdevDevice *self,
 		const gchar *enumerated_parent_path;
 
 		/* get parent, if it exists */
-		enumerated_parent = g_udev_device_get_parent(enumerated_device);
+		enumerated_parent = fu_udev_device_get_parent_cached(self, enumerated_device);
 		if (enumerated_parent == NULL)
 			break;
 		enumerated_parent_path = g_udev_device_get_sysfs_path(enumerated_parent);
@@ -2253,8 +2315,9 @@ fu_udev_device_get_parent_with_subsystem(FuUdevDevice *self, const gchar *subsys
 	if (subsystem == NULL) {
 		device_tmp = g_udev_device_get_parent(priv->udev_device);
 	} else {
-		device_tmp =
-		    g_udev_device_get_parent_with_subsystem(priv->udev_device, subsystem, NULL);
+		device_tmp = g_udev_device_get_parent_with_subsystem(priv->udev_device,
+								     subsystem,
+								     NULL);
 	}
 	if (device_tmp == NULL) {
 		g_set_error(error,
@@ -2302,7 +2365,7 @@ fu_udev_device_get_children_with_subsystem(FuUdevDevice *self, const gchar *cons
 		const gchar *enumerated_parent_path;
 
 		/* get parent, if it exists */
-		enumerated_parent = g_udev_device_get_parent(enumerated_device);
+		enumerated_parent = fu_udev_device_get_parent_cached(self, enumerated_device);
 		if (enumerated_parent == NULL)
 			break;
 		enumerated_parent_path = g_udev_device_get_sysfs_path(enumerated_parent);
@@ -2360,11 +2423,11 @@ fu_udev_device_find_usb_device(FuUdevDevice *self, GError **error)
 	udev_device = g_object_ref(priv->udev_device);
 	while (udev_device != NULL) {
 		g_autoptr(GUdevDevice) udev_device_parent = NULL;
-		bus = g_udev_device_get_sysfs_attr_as_int(udev_device, "busnum");
-		address = g_udev_device_get_sysfs_attr_as_int(udev_device, "devnum");
+		bus = fu_udev_device_get_sysfs_attr_as_uint8(self, udev_device, "busnum");
+		address = fu_udev_device_get_sysfs_attr_as_uint8(self, udev_device, "devnum");
 		if (bus != 0 || address != 0)
 			break;
-		udev_device_parent = g_udev_device_get_parent(udev_device);
+		udev_device_parent = fu_udev_device_get_parent_cached(self, udev_device);
 		g_set_object(&udev_device, udev_device_parent);
 	}
 
@@ -252,25 +252,17 @@ fu_version_compare_char(gchar chr1, gchar chr2)
 }
 
 static gint
-fu_version_compare_chunk(const gchar *str1, const gchar *str2)
+fu_version_compare_chunk(const gchar *str1, gsize len1, const gchar *str2, gsize len2)
 {
-	guint i;
-
-	/* trivial */
-	if (g_strcmp0(str1, str2) == 0)
-		return 0;
-	if (str1 == NULL)
-		return 1;
-	if (str2 == NULL)
-		return -1;
+	gsize i;
 
 	/* check each char of the chunk */
-	for (i = 0; str1[i] != '\0' && str2[i] != '\0'; i++) {
+	for (i = 0; i < len1 && i < len2; i++) {
 		gint rc = fu_version_compare_char(str1[i], str2[i]);
 		if (rc != 0)
 			return rc;
 	}
-	return fu_version_compare_char(str1[i], str2[i]);
+	return fu_version_compare_char(i < len1 ? str1[i] : '\0', i < len2 ? str2[i] : '\0');
 }
 
 static gboolean
@@ -576,12 +568,63 @@ fu_version_verify_format(const gchar *version, FwupdVersionFormat fmt, GError **
 	return TRUE;
 }
 
+typedef struct {
+	gint64 value;
+	const gchar *suffix; /* not NUL terminated */
+	gsize suffix_len;
+} FuVersionSection;
+
+struct FuVersionKey {
+	gchar *version;
+	gchar *str; /* as compared, e.g. with the hex expanded */
+	FwupdVersionFormat fmt;
+	guint sections_len;
+	FuVersionSection sections[];
+};
+
+/* parses the section at @str, returning the start of the next section or %NULL */
+static const gchar *
+fu_version_parse_section(const gchar *str, FuVersionSection *section)
+{
+	const gchar *end = strchr(str, '.');
+	gchar *endptr = NULL;
+
+	section->value = g_ascii_strtoll(str, &endptr, 10);
+	section->suffix = endptr;
+	section->suffix_len = (end != NULL ? end : endptr + strlen(endptr)) - endptr;
+	return end != NULL ? end + 1 : NULL;
+}
+
+static gint
+fu_version_compare_section(const FuVersionSection *section_a, const FuVersionSection *section_b)
+{
+	gint rc;
+
+	/* compare integers */
+	if (section_a->value < section_b->value)
+		return -1;
+	if (section_a->value > section_b->value)
+		return 1;
+
+	/* compare strings */
+	if (section_a->suffix_len == 0 && section_b->suffix_len == 0)
+		return 0;
+	rc = fu_version_compare_chunk(section_a->suffix,
+				      section_a->suffix_len,
+				      section_b->suffix,
+				      section_b->suffix_len);
+	if (rc < 0)
+		return -1;
+	if (rc > 0)
+		return 1;
+	return 0;
+}
+
 static gint
 fu_version_compare_safe(const gchar *version_a, const gchar *version_b)
 {
-	guint longest_split;
-	g_auto(GStrv) split_a = NULL;
-	g_auto(GStrv) split_b = NULL;
+	const gchar *str_a;
+	const gchar *str_b;
 
 	/* sanity check */
 	if (version_a == NULL || version_b == NULL)
@@ -591,39 +634,25 @@ fu_version_compare_safe(const gchar *version_a, const gchar *version_b)
 	if (g_strcmp0(version_a, version_b) == 0)
 		return 0;
 
-	/* split into sections, and try to parse */
-	split_a = g_strsplit(version_a, ".", -1);
-	split_b = g_strsplit(version_b, ".", -1);
-	longest_split = MAX(g_strv_length(split_a), g_strv_length(split_b));
-	for (guint i = 0; i < longest_split; i++) {
-		gchar *endptr_a = NULL;
-		gchar *endptr_b = NULL;
-		gint64 ver_a;
-		gint64 ver_b;
+	/* walk each section without splitting, as this is used when sorting */
+	str_a = version_a[0] != '\0' ? version_a : NULL;
+	str_b = version_b[0] != '\0' ? version_b : NULL;
+	while (str_a != NULL || str_b != NULL) {
+		FuVersionSection section_a = {0};
+		FuVersionSection section_b = {0};
+		gint rc;
 
 		/* we lost or gained a dot */
-		if (split_a[i] == NULL)
+		if (str_a == NULL)
 			return -1;
-		if (split_b[i] == NULL)
+		if (str_b == NULL)
 			return 1;
 
-		/* compare integers */
-		ver_a = g_ascii_strtoll(split_a[i], &endptr_a, 10);
-		ver_b = g_ascii_strtoll(split_b[i], &endptr_b, 10);
-		if (ver_a < ver_b)
-			return -1;
-		if (ver_a > ver_b)
-			return 1;
-
-		/* compare strings */
-		if ((endptr_a != NULL && endptr_a[0] != '\0') ||
-		    (endptr_b != NULL && endptr_b[0] != '\0')) {
-			gint rc = fu_version_compare_chunk(endptr_a, endptr_b);
-			if (rc < 0)
-				return -1;
-			if (rc > 0)
-				return 1;
-		}
+		str_a = fu_version_parse_section(str_a, &section_a);
+		str_b = fu_version_parse_section(str_b, &section_b);
+		rc = fu_version_compare_section(&section_a, &section_b);
+		if (rc != 0)
+			return rc;
 	}
 
 	/* we really shouldn't get here */
@@ -657,3 +686,229 @@ fu_version_compare(const gchar *version_a, const gchar *version_b, FwupdVersionF
 	}
 	return fu_version_compare_safe(version_a, version_b);
 }
+
+/**
+ * fu_version_key_new:
+ * @version: (nullable): the version, e.g. `1.2.3`
+ * @fmt: a version format, e.g. %FWUPD_VERSION_FORMAT_TRIPLET
+ *
+ * Parses the version into sections so that it can be compared many times, for instance when
+ * sorting releases, without splitting or formatting strings each time.
+ *
+ * Returns: (transfer full): a #FuVersionKey, or %NULL if @version was %NULL
+ *
+ * Since: 2.0.0
+ **/
+FuVersionKey *
+fu_version_key_new(const gchar *version, FwupdVersionFormat fmt)
+{
+	FuVersionKey *self;
+	const gchar *tmp;
+	guint sections_len = 0;
+	g_autofree gchar *str = NULL;
+
+	/* nothing to do */
+	if (version == NULL)
+		return NULL;
+
+	/* the hex format is compared as if it was zero-padded */
+	if (fmt == FWUPD_VERSION_FORMAT_HEX)
+		str = fu_version_parse_from_format(version, fmt);
+	else
+		str = g_strdup(version);
+
+	/* count sections */
+	if (fmt != FWUPD_VERSION_FORMAT_PLAIN && str[0] != '\0') {
+		sections_len = 1;
+		for (guint i = 0; str[i] != '\0'; i++) {
+			if (str[i] == '.')
+				sections_len++;
+		}
+	}
+
+	self = g_malloc0(sizeof(FuVersionKey) + sections_len * sizeof(FuVersionSection));
+	self->version = g_strdup(version);
+	self->str = g_steal_pointer(&str);
+	self->fmt = fmt;
+	self->sections_len = sections_len;
+	tmp = self->str;
+	for (guint i = 0; i < sections_len; i++)
+		tmp = fu_version_parse_section(tmp, &self->sections[i]);
+	return self;
+}
+
+/**
+ * fu_version_key_free:
+ * @self: a #FuVersionKey
+ *
+ * Frees a version key.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_version_key_free(FuVersionKey *self)
+{
+	g_return_if_fail(self != NULL);
+	g_free(self->version);
+	g_free(self->str);
+	g_free(self);
+}
+
+/**
+ * fu_version_key_get_version:
+ * @self: a #FuVersionKey
+ *
+ * Gets the version the key was created from.
+ *
+ * Returns: a string, e.g. `1.2.3`
+ *
+ * Since: 2.0.0
+ **/
+const gchar *
+fu_version_key_get_version(const FuVersionKey *self)
+{
+	g_return_val_if_fail(self != NULL, NULL);
+	return self->version;
+}
+
+/**
+ * fu_version_key_get_format:
+ * @self: a #FuVersionKey
+ *
+ * Gets the version format the key was created with.
+ *
+ * Returns: a version format, e.g. %FWUPD_VERSION_FORMAT_TRIPLET
+ *
+ * Since: 2.0.0
+ **/
+FwupdVersionFormat
+fu_version_key_get_format(const FuVersionKey *self)
+{
+	g_return_val_if_fail(self != NULL, FWUPD_VERSION_FORMAT_UNKNOWN);
+	return self->fmt;
+}
+
+/**
+ * fu_version_key_matches:
+ * @self: (nullable): a #FuVersionKey
+ * @version: (nullable): the version, e.g. `1.2.3`
+ * @fmt: a version format, e.g. %FWUPD_VERSION_FORMAT_TRIPLET
+ *
+ * Checks if the key was created from @version and @fmt, which is useful when the key is being
+ * cached.
+ *
+ * Returns: %TRUE if the key is still valid
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_version_key_matches(const FuVersionKey *self, const gchar *version, FwupdVersionFormat fmt)
+{
+	if (self == NULL)
+		return version == NULL;
+	return self->fmt == fmt && g_strcmp0(self->version, version) == 0;
+}
+
+/**
+ * fu_version_key_compare:
+ * @key_a: (nullable): a #FuVersionKey
+ * @key_b: (nullable): a #FuVersionKey
+ *
+ * Compares two version keys for sorting, in the same way as fu_version_compare() but without
+ * allocating memory.
+ *
+ * Returns: -1 if a < b, +1 if a > b, 0 if they are equal, and %G_MAXINT on error
+ *
+ * Since: 2.0.0
+ **/
+gint
+fu_version_key_compare(const FuVersionKey *key_a, const FuVersionKey *key_b)
+{
+	guint sections_len;
+
+	/* sanity check */
+	if (key_a == NULL || key_b == NULL)
+		return G_MAXINT;
+
+	/* not comparable, so do this the slow way */
+	if (key_a->fmt != key_b->fmt)
+		return fu_version_compare(key_a->version, key_b->version, key_a->fmt);
+	if (key_a->fmt == FWUPD_VERSION_FORMAT_PLAIN)
+		return g_strcmp0(key_a->version, key_b->version);
+
+	/* optimization */
+	if (g_strcmp0(key_a->str, key_b->str) == 0)
+		return 0;
+
+	sections_len = MAX(key_a->sections_len, key_b->sections_len);
+	for (guint i = 0; i < sections_len; i++) {
+		gint rc;
+
+		/* we lost or gained a dot */
+		if (i >= key_a->sections_len)
+			return -1;
+		if (i >= key_b->sections_len)
+			return 1;
+
+		rc = fu_version_compare_section(&key_a->sections[i], &key_b->sections[i]);
+		if (rc != 0)
+			return rc;
+	}
+
+	/* we really shouldn't get here */
+	return 0;
+}
+
+/**
+ * fu_version_key_compare_string:
+ * @self: (nullable): a #FuVersionKey
+ * @version: (nullable): the version, e.g. `1.2.3`
+ *
+ * Compares a version key with a version string using the version format of the key, in the
+ * same way as fu_version_compare().
+ *
+ * Returns: -1 if a < b, +1 if a > b, 0 if they are equal, and %G_MAXINT on error
+ *
+ * Since: 2.0.0
+ **/
+gint
+fu_version_key_compare_string(const FuVersionKey *self, const gchar *version)
+{
+	const gchar *str;
+	g_autofree gchar *hex = NULL;
+
+	/* sanity check */
+	if (self == NULL || version == NULL)
+		return G_MAXINT;
+
+	if (self->fmt == FWUPD_VERSION_FORMAT_PLAIN)
+		return g_strcmp0(self->version, version);
+	if (self->fmt == FWUPD_VERSION_FORMAT_HEX) {
+		hex = fu_version_parse_from_format(version, self->fmt);
+		version = hex;
+	}
+
+	/* optimization */
+	if (g_strcmp0(self->str, version) == 0)
+		return 0;
+
+	str = version[0] != '\0' ? version : NULL;
+	for (guint i = 0; i < self->sections_len || str != NULL; i++) {
+		FuVersionSection section = {0};
+		gint rc;
+
+		/* we lost or gained a dot */
+		if (i >= self->sections_len)
+			return -1;
+		if (str == NULL)
+			return 1;
+
+		str = fu_version_parse_section(str, &section);
+		rc = fu_version_compare_section(&self->sections[i], &section);
+		if (rc != 0)
+			return rc;
+	}
+
+	/* we really shouldn't get here */
+	return 0;
+}
@@ -9,6 +9,13 @@
 #include <fwupd.h>
 #include <gio/gio.h>
 
+/**
+ * FuVersionKey:
+ *
+ * A version number parsed into sections for fast comparison.
+ **/
+typedef struct FuVersionKey FuVersionKey;
+
 gint
 fu_version_compare(const gchar *version_a, const gchar *version_b, FwupdVersionFormat fmt);
 gchar *
@@ -29,3 +36,20 @@ gboolean
 fu_version_verify_format(const gchar *version,
 			 FwupdVersionFormat fmt,
 			 GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+
+FuVersionKey *
+fu_version_key_new(const gchar *version, FwupdVersionFormat fmt);
+void
+fu_version_key_free(FuVersionKey *self);
+const gchar *
+fu_version_key_get_version(const FuVersionKey *self);
+FwupdVersionFormat
+fu_version_key_get_format(const FuVersionKey *self);
+gboolean
+fu_version_key_matches(const FuVersionKey *self, const gchar *version, FwupdVersionFormat fmt);
+gint
+fu_version_key_compare(const FuVersionKey *key_a, const FuVersionKey *key_b);
+gint
+fu_version_key_compare_string(const FuVersionKey *self, const gchar *version);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuVersionKey, fu_version_key_free)
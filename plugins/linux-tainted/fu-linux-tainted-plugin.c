@@ -44,8 +44,7 @@ fu_linux_tainted_plugin_changed_cb(GFileMonitor *monitor,
 				   gpointer user_data)
 {
 	FuPlugin *plugin = FU_PLUGIN(user_data);
-	FuContext *ctx = fu_plugin_get_context(plugin);
-	fu_context_security_changed(ctx);
+	fu_plugin_security_changed(plugin);
 }
 
 static gboolean
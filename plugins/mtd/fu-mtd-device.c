@@ -34,9 +34,8 @@ fu_mtd_device_to_string(FuDevice *device, guint idt, GString *str)
 }
 
 static FuFirmware *
-fu_mtd_device_read_firmware(FuDevice *device, FuProgress *progress, GError **error)
+fu_mtd_device_read_firmware_full(FuMtdDevice *self, gboolean lazy_regions, GError **error)
 {
-	FuMtdDevice *self = FU_MTD_DEVICE(device);
 	const gchar *fn;
 	g_autoptr(FuFirmware) firmware = NULL;
 	g_autoptr(GInputStream) stream = NULL;
@@ -67,6 +66,9 @@ fu_mtd_device_read_firmware(FuDevice *device, FuProgress *progress, GError **err
 		stream_partial = g_object_ref(stream);
 	}
 	firmware = g_object_new(fu_device_get_firmware_gtype(FU_DEVICE(self)), NULL);
+
+	if (lazy_regions && FU_IS_IFD_FIRMWARE(firmware))
+		fu_ifd_firmware_set_lazy_regions(FU_IFD_FIRMWARE(firmware), TRUE);
 	if (!fu_firmware_parse_stream(firmware,
 				      stream_partial,
 				      0x0,
@@ -80,6 +82,13 @@ fu_mtd_device_read_firmware(FuDevice *device, FuProgress *progress, GError **err
 	return g_steal_pointer(&firmware);
 }
 
+static FuFirmware *
+fu_mtd_device_read_firmware(FuDevice *device, FuProgress *progress, GError **error)
+{
+	FuMtdDevice *self = FU_MTD_DEVICE(device);
+	return fu_mtd_device_read_firmware_full(self, FALSE, error);
+}
+
 static gboolean
 fu_mtd_device_metadata_load(FuMtdDevice *self, GError **error)
 {
@@ -89,8 +98,8 @@ fu_mtd_device_metadata_load(FuMtdDevice *self, GError **error)
 	g_autoptr(GPtrArray) imgs = NULL;
 	g_autoptr(FuFirmware) firmware = NULL;
 
-	/* read firmware from stream */
-	firmware = fu_mtd_device_read_firmware(FU_DEVICE(self), NULL, error);
+	/* the region layout is all that is needed to add the children */
+	firmware = fu_mtd_device_read_firmware_full(self, TRUE, error);
 	if (firmware == NULL)
 		return FALSE;
 
@@ -30,6 +30,7 @@ struct _FuRedfishBackend {
 	gboolean use_https;
 	gboolean cacheck;
 	gboolean wildcard_targets;
+	gboolean expand_query;
 	gint64 max_image_size; /* bytes */
 	GType device_gtype;
 	GHashTable *request_cache; /* str:GByteArray */
@@ -38,6 +39,8 @@ struct _FuRedfishBackend {
 
 G_DEFINE_TYPE(FuRedfishBackend, fu_redfish_backend, FU_TYPE_BACKEND)
 
+#define FU_REDFISH_BACKEND_MAX_PARALLEL 8 /* requests */
+
 const gchar *
 fu_redfish_backend_get_vendor(FuRedfishBackend *self)
 {
@@ -88,6 +91,7 @@ fu_redfish_backend_request_new(FuRedfishBackend *self)
 	user_agent = g_strdup_printf("%s/%s", PACKAGE_NAME, PACKAGE_VERSION);
 	(void)curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent);
 	(void)curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 60L);
+	(void)curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
 	if (!self->cacheck) {
 		(void)curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
 		(void)curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
@@ -134,19 +138,29 @@ fu_redfish_backend_coldplug_member(FuRedfishBackend *self, JsonObject *member, G
 	return TRUE;
 }
 
+/* the Id property is required, so a reference will only have @odata.id */
+static gboolean
+fu_redfish_backend_member_is_expanded(JsonObject *member)
+{
+	return json_object_has_member(member, "Id");
+}
+
 static gboolean
 fu_redfish_backend_coldplug_collection(FuRedfishBackend *self,
 				       JsonObject *collection,
 				       GError **error)
 {
 	JsonArray *members = json_object_get_array_member(collection, "Members");
+	g_autoptr(GPtrArray) requests = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_autoptr(GPtrArray) paths = g_ptr_array_new();
+
+	/* get any members that were not already expanded, all at the same time */
 	for (guint i = 0; i < json_array_get_length(members); i++) {
-		JsonObject *json_obj;
-		JsonObject *member_id;
+		JsonObject *member_id = json_array_get_object_element(members, i);
 		const gchar *member_uri;
-		g_autoptr(FuRedfishRequest) request = fu_redfish_backend_request_new(self);
 
-		member_id = json_array_get_object_element(members, i);
+		if (fu_redfish_backend_member_is_expanded(member_id))
+			continue;
 		member_uri = json_object_get_string_member(member_id, "@odata.id");
 		if (member_uri == NULL) {
 			g_set_error_literal(error,
@@ -155,14 +169,23 @@ fu_redfish_backend_coldplug_collection(FuRedfishBackend *self,
 					    "no @odata.id string");
 			return FALSE;
 		}
+		g_ptr_array_add(requests, fu_redfish_backend_request_new(self));
+		g_ptr_array_add(paths, (gpointer)member_uri);
+	}
+	if (!fu_redfish_request_perform_multi(requests,
+					      paths,
+					      FU_REDFISH_BACKEND_MAX_PARALLEL,
+					      FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
+					      error))
+		return FALSE;
 
-		/* create the device for the member */
-		if (!fu_redfish_request_perform(request,
-						member_uri,
-						FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
-						error))
-			return FALSE;
-		json_obj = fu_redfish_request_get_json_object(request);
+	/* create the device for each member, in the original order */
+	for (guint i = 0, j = 0; i < json_array_get_length(members); i++) {
+		JsonObject *json_obj = json_array_get_object_element(members, i);
+		if (!fu_redfish_backend_member_is_expanded(json_obj)) {
+			FuRedfishRequest *request = g_ptr_array_index(requests, j++);
+			json_obj = fu_redfish_request_get_json_object(request);
+		}
 		if (!fu_redfish_backend_coldplug_member(self, json_obj, error))
 			return FALSE;
 	}
@@ -174,6 +197,7 @@ fu_redfish_backend_coldplug_inventory(FuRedfishBackend *self, JsonObject *invent
 {
 	JsonObject *json_obj;
 	const gchar *collection_uri;
+	g_autofree gchar *collection_uri_full = NULL;
 	g_autoptr(FuRedfishRequest) request = fu_redfish_backend_request_new(self);
 
 	if (inventory == NULL) {
@@ -193,8 +217,13 @@ fu_redfish_backend_coldplug_inventory(FuRedfishBackend *self, JsonObject *invent
 		return FALSE;
 	}
 
+	/* get all the members in the same response if supported */
+	if (self->expand_query)
+		collection_uri_full = g_strdup_printf("%s?$expand=.", collection_uri);
+	else
+		collection_uri_full = g_strdup(collection_uri);
 	if (!fu_redfish_request_perform(request,
-					collection_uri,
+					collection_uri_full,
 					FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
 					error))
 		return FALSE;
@@ -379,6 +408,17 @@ fu_redfish_backend_setup(FuBackend *backend, FuProgress *progress, GError **erro
 		g_free(self->vendor);
 		self->vendor = g_strdup(json_object_get_string_member(json_obj, "Vendor"));
 	}
+	if (json_object_has_member(json_obj, "ProtocolFeaturesSupported")) {
+		JsonObject *json_features =
+		    json_object_get_object_member(json_obj, "ProtocolFeaturesSupported");
+		if (json_features != NULL && json_object_has_member(json_features, "ExpandQuery")) {
+			JsonObject *json_expand =
+			    json_object_get_object_member(json_features, "ExpandQuery");
+			if (json_expand != NULL && json_object_has_member(json_expand, "NoLinks"))
+				self->expand_query =
+				    json_object_get_boolean_member(json_expand, "NoLinks");
+		}
+	}
 
 	if (json_object_has_member(json_obj, "UpdateService"))
 		json_update_service = json_object_get_object_member(json_obj, "UpdateService");
@@ -478,6 +518,7 @@ fu_redfish_backend_to_string(FuBackend *backend, guint idt, GString *str)
 	fwupd_codec_string_append_bool(str, idt, "UseHttps", self->use_https);
 	fwupd_codec_string_append_bool(str, idt, "Cacheck", self->cacheck);
 	fwupd_codec_string_append_bool(str, idt, "WildcardTargets", self->wildcard_targets);
+	fwupd_codec_string_append_bool(str, idt, "ExpandQuery", self->expand_query);
 	fwupd_codec_string_append_hex(str, idt, "MaxImageSize", self->max_image_size);
 	fwupd_codec_string_append(str, idt, "DeviceGType", g_type_name(self->device_gtype));
 }
@@ -543,8 +543,15 @@ typedef struct {
 	gboolean completed;
 	GHashTable *messages_seen;
 	FuProgress *progress;
+	guint delay;	   /* ms */
+	guint retry_after; /* s */
+	gint64 percentage;
+	gchar *state;
 } FuRedfishDevicePollCtx;
 
+#define FU_REDFISH_DEVICE_POLL_DELAY_MIN 100  /* ms */
+#define FU_REDFISH_DEVICE_POLL_DELAY_MAX 1000 /* ms */
+
 static void
 fu_redfish_device_poll_set_message_id(FuRedfishDevice *self,
 				      FuRedfishDevicePollCtx *ctx,
@@ -649,12 +656,18 @@ fu_redfish_device_poll_task_once(FuRedfishDevice *self, FuRedfishDevicePollCtx *
 					error))
 		return FALSE;
 
+	ctx->retry_after = fu_redfish_request_get_retry_after(request);
+
 	/* percentage is optional */
 	json_obj = fu_redfish_request_get_json_object(request);
 	if (json_object_has_member(json_obj, "PercentComplete")) {
 		gint64 pc = json_object_get_int_member(json_obj, "PercentComplete");
 		if (pc >= 0 && pc <= 100)
 			fu_progress_set_percentage(ctx->progress, (guint)pc);
+		if (pc != ctx->percentage) {
+			ctx->percentage = pc;
+			ctx->delay = FU_REDFISH_DEVICE_POLL_DELAY_MIN;
+		}
 	}
 
 	/* print all messages we've not seen yet */
@@ -697,7 +710,12 @@ fu_redfish_device_poll_task_once(FuRedfishDevice *self, FuRedfishDevicePollCtx *
 		return FALSE;
 	}
 	state_tmp = json_object_get_string_member(json_obj, "TaskState");
-	g_debug("TaskState now %s", state_tmp);
+	if (g_strcmp0(state_tmp, ctx->state) != 0) {
+		g_debug("TaskState now %s", state_tmp);
+		g_free(ctx->state);
+		ctx->state = g_strdup(state_tmp);
+		ctx->delay = FU_REDFISH_DEVICE_POLL_DELAY_MIN;
+	}
 	if (g_strcmp0(state_tmp, "Completed") == 0) {
 		ctx->completed = TRUE;
 		return TRUE;
@@ -724,6 +742,8 @@ fu_redfish_device_poll_ctx_new(FuProgress *progress, const gchar *location)
 	ctx->location = g_strdup(location);
 	ctx->error_code = FWUPD_ERROR_INTERNAL;
 	ctx->progress = g_object_ref(progress);
+	ctx->delay = FU_REDFISH_DEVICE_POLL_DELAY_MIN;
+	ctx->percentage = -1;
 	return ctx;
 }
 
@@ -733,6 +753,7 @@ fu_redfish_device_poll_ctx_free(FuRedfishDevicePollCtx *ctx)
 	g_hash_table_unref(ctx->messages_seen);
 	g_object_unref(ctx->progress);
 	g_free(ctx->location);
+	g_free(ctx->state);
 	g_free(ctx);
 }
 
@@ -751,9 +772,13 @@ fu_redfish_device_poll_task(FuRedfishDevice *self,
 	g_autoptr(GTimer) timer = g_timer_new();
 	g_autoptr(FuRedfishDevicePollCtx) ctx = fu_redfish_device_poll_ctx_new(progress, location);
 
-	/* sleep and then reprobe hardware */
+	/* sleep and then reprobe hardware, backing off while nothing changes */
 	do {
-		fu_device_sleep(FU_DEVICE(self), 1000); /* ms */
+		guint delay = ctx->delay;
+		if (ctx->retry_after > 0)
+			delay = ctx->retry_after * 1000;
+		fu_device_sleep(FU_DEVICE(self), delay); /* ms */
+		ctx->delay = MIN(ctx->delay * 2, FU_REDFISH_DEVICE_POLL_DELAY_MAX);
 		if (!fu_redfish_device_poll_task_once(self, ctx, error))
 			return FALSE;
 		if (ctx->completed)
@@ -81,23 +81,20 @@ fu_redfish_legacy_device_write_firmware(FuDevice *device,
 {
 	FuRedfishLegacyDevice *self = FU_REDFISH_LEGACY_DEVICE(device);
 	FuRedfishBackend *backend = fu_redfish_device_get_backend(FU_REDFISH_DEVICE(self));
-	CURL *curl;
 	JsonObject *json_obj;
 	const gchar *location;
 	g_autoptr(FuRedfishRequest) request = NULL;
-	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GInputStream) stream = NULL;
 
 	/* get default image */
-	fw = fu_firmware_get_bytes(firmware, error);
-	if (fw == NULL)
+	stream = fu_firmware_get_stream(firmware, error);
+	if (stream == NULL)
 		return FALSE;
 
 	/* POST data */
 	request = fu_redfish_backend_request_new(backend);
-	curl = fu_redfish_request_get_curl(request);
-	(void)curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "POST");
-	(void)curl_easy_setopt(curl, CURLOPT_POSTFIELDS, g_bytes_get_data(fw, NULL));
-	(void)curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)g_bytes_get_size(fw));
+	if (!fu_redfish_request_set_upload_stream(request, stream, error))
+		return FALSE;
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_WRITE);
 	if (!fu_redfish_request_perform(request,
 					fu_redfish_backend_get_push_uri_path(backend),
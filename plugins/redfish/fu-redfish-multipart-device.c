@@ -63,12 +63,12 @@ fu_redfish_multipart_device_write_firmware(FuDevice *device,
 	const gchar *location;
 	g_autoptr(curl_mime) mime = NULL;
 	g_autoptr(FuRedfishRequest) request = NULL;
-	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GInputStream) stream = NULL;
 	g_autoptr(GString) params = NULL;
 
 	/* get default image */
-	fw = fu_firmware_get_bytes(firmware, error);
-	if (fw == NULL)
+	stream = fu_firmware_get_stream(firmware, error);
+	if (stream == NULL)
 		return FALSE;
 
 	/* create the multipart request */
@@ -88,7 +88,8 @@ fu_redfish_multipart_device_write_firmware(FuDevice *device,
 	curl_mime_name(part, "UpdateFile");
 	(void)curl_mime_type(part, "application/octet-stream");
 	(void)curl_mime_filedata(part, "firmware.bin");
-	(void)curl_mime_data(part, g_bytes_get_data(fw, NULL), g_bytes_get_size(fw));
+	if (!fu_redfish_request_mimepart_set_stream(part, stream, error))
+		return FALSE;
 
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_WRITE);
 	if (!fu_redfish_request_perform(request,
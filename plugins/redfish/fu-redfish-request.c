@@ -6,6 +6,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "fu-redfish-request.h"
 
 struct _FuRedfishRequest {
@@ -17,6 +19,7 @@ struct _FuRedfishRequest {
 	JsonParser *json_parser;
 	JsonObject *json_obj;
 	GHashTable *cache; /* nullable */
+	guint retry_after; /* s */
 };
 
 G_DEFINE_TYPE(FuRedfishRequest, fu_redfish_request, G_TYPE_OBJECT)
@@ -52,6 +55,14 @@ fu_redfish_request_get_status_code(FuRedfishRequest *self)
 	return self->status_code;
 }
 
+/* only the delay-seconds form is supported, and 0 means unset */
+guint
+fu_redfish_request_get_retry_after(FuRedfishRequest *self)
+{
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), 0);
+	return self->retry_after;
+}
+
 static gboolean
 fu_redfish_request_load_json(FuRedfishRequest *self, GByteArray *buf, GError **error)
 {
@@ -138,37 +149,48 @@ fu_redfish_request_load_json(FuRedfishRequest *self, GByteArray *buf, GError **e
 	return TRUE;
 }
 
-gboolean
-fu_redfish_request_perform(FuRedfishRequest *self,
-			   const gchar *path,
-			   FuRedfishRequestPerformFlags flags,
-			   GError **error)
+static gboolean
+fu_redfish_request_load_cache(FuRedfishRequest *self,
+			      const gchar *path,
+			      FuRedfishRequestPerformFlags flags,
+			      gboolean *hit,
+			      GError **error)
 {
-	CURLcode res;
-	g_autofree gchar *str = NULL;
-	g_autoptr(curlptr) uri_str = NULL;
+	GByteArray *buf;
 
-	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
-	g_return_val_if_fail(path != NULL, FALSE);
-	g_return_val_if_fail(self->status_code == 0, FALSE);
-	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	if ((flags & FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE) == 0 || self->cache == NULL)
+		return TRUE;
+	buf = g_hash_table_lookup(self->cache, path);
+	if (buf == NULL)
+		return TRUE;
+	*hit = TRUE;
+	if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON)
+		return fu_redfish_request_load_json(self, buf, error);
+	g_byte_array_unref(self->buf);
+	self->buf = g_byte_array_ref(buf);
+	return TRUE;
+}
 
-	/* already in cache? */
-	if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE && self->cache != NULL) {
-		GByteArray *buf = g_hash_table_lookup(self->cache, path);
-		if (buf != NULL) {
-			if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON)
-				return fu_redfish_request_load_json(self, buf, error);
-			g_byte_array_unref(self->buf);
-			self->buf = g_byte_array_ref(buf);
-			return TRUE;
-		}
-	}
+/* the path may also include a query, e.g. `?$expand=.` */
+static void
+fu_redfish_request_set_path(FuRedfishRequest *self, const gchar *path)
+{
+	g_auto(GStrv) split = g_strsplit(path, "?", 2);
+	(void)curl_url_set(self->uri, CURLUPART_PATH, split[0], 0);
+	(void)curl_url_set(self->uri, CURLUPART_QUERY, split[1], 0);
+}
+
+static gboolean
+fu_redfish_request_perform_finish(FuRedfishRequest *self,
+				  const gchar *path,
+				  CURLcode res,
+				  FuRedfishRequestPerformFlags flags,
+				  GError **error)
+{
+	g_autofree gchar *str = NULL;
+	g_autoptr(curlptr) uri_str = NULL;
 
-	/* do request */
-	(void)curl_url_set(self->uri, CURLUPART_PATH, path, 0);
 	(void)curl_url_get(self->uri, CURLUPART_URL, &uri_str, 0);
-	res = curl_easy_perform(self->curl);
 	curl_easy_getinfo(self->curl, CURLINFO_RESPONSE_CODE, &self->status_code);
 	str = g_strndup((const gchar *)self->buf->data, self->buf->len);
 	g_debug("%s: %s [%li]", uri_str, str, self->status_code);
@@ -209,6 +231,131 @@ fu_redfish_request_perform(FuRedfishRequest *self,
 	return TRUE;
 }
 
+gboolean
+fu_redfish_request_perform(FuRedfishRequest *self,
+			   const gchar *path,
+			   FuRedfishRequestPerformFlags flags,
+			   GError **error)
+{
+	gboolean hit = FALSE;
+
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
+	g_return_val_if_fail(path != NULL, FALSE);
+	g_return_val_if_fail(self->status_code == 0, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* already in cache? */
+	if (!fu_redfish_request_load_cache(self, path, flags, &hit, error))
+		return FALSE;
+	if (hit)
+		return TRUE;
+
+	/* do request */
+	fu_redfish_request_set_path(self, path);
+	return fu_redfish_request_perform_finish(self,
+						 path,
+						 curl_easy_perform(self->curl),
+						 flags,
+						 error);
+}
+
+/* perform GETs at the same time, which is much faster when the BMC has a high latency */
+gboolean
+fu_redfish_request_perform_multi(GPtrArray *requests,
+				 GPtrArray *paths,
+				 guint max_parallel,
+				 FuRedfishRequestPerformFlags flags,
+				 GError **error)
+{
+	CURLM *multi;
+	guint idx_next = 0;
+	guint running = 0;
+	gboolean ret = TRUE;
+
+	g_return_val_if_fail(requests != NULL, FALSE);
+	g_return_val_if_fail(paths != NULL, FALSE);
+	g_return_val_if_fail(requests->len == paths->len, FALSE);
+	g_return_val_if_fail(max_parallel > 0, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	multi = curl_multi_init();
+	(void)curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, (glong)max_parallel);
+	while (ret) {
+		int still_running = 0;
+		int msgs_in_queue = 0;
+		CURLMcode mres;
+		CURLMsg *msg;
+
+		/* keep the window full */
+		while (running < max_parallel && idx_next < requests->len) {
+			FuRedfishRequest *self = g_ptr_array_index(requests, idx_next);
+			const gchar *path = g_ptr_array_index(paths, idx_next);
+			gboolean hit = FALSE;
+
+			idx_next++;
+			if (!fu_redfish_request_load_cache(self, path, flags, &hit, error)) {
+				ret = FALSE;
+				break;
+			}
+			if (hit)
+				continue;
+			fu_redfish_request_set_path(self, path);
+			(void)curl_easy_setopt(self->curl,
+					       CURLOPT_PRIVATE,
+					       GUINT_TO_POINTER(idx_next - 1));
+			(void)curl_multi_add_handle(multi, self->curl);
+			running++;
+		}
+		if (!ret || running == 0)
+			break;
+
+		/* wait for something to happen */
+		mres = curl_multi_perform(multi, &still_running);
+		if (mres == CURLM_OK && still_running > 0)
+			mres = curl_multi_wait(multi, NULL, 0, 1000, NULL);
+		if (mres != CURLM_OK) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "failed to perform requests: %s",
+				    curl_multi_strerror(mres));
+			ret = FALSE;
+			break;
+		}
+
+		/* process anything that completed */
+		while ((msg = curl_multi_info_read(multi, &msgs_in_queue)) != NULL) {
+			FuRedfishRequest *self;
+			gchar *priv = NULL;
+			guint idx;
+
+			if (msg->msg != CURLMSG_DONE)
+				continue;
+			(void)curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &priv);
+			(void)curl_multi_remove_handle(multi, msg->easy_handle);
+			running--;
+			idx = GPOINTER_TO_UINT(priv);
+			self = g_ptr_array_index(requests, idx);
+			if (!fu_redfish_request_perform_finish(self,
+							       g_ptr_array_index(paths, idx),
+							       msg->data.result,
+							       flags,
+							       error)) {
+				ret = FALSE;
+				break;
+			}
+		}
+	}
+
+	/* abort anything still in flight */
+	for (guint i = 0; i < requests->len; i++) {
+		FuRedfishRequest *self = g_ptr_array_index(requests, i);
+		(void)curl_multi_remove_handle(multi, self->curl);
+	}
+	curl_multi_cleanup(multi);
+	return ret;
+}
+
 typedef struct curl_slist _curl_slist;
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(_curl_slist, curl_slist_free_all)
 
@@ -216,6 +363,7 @@ static void
 fu_redfish_request_reset(FuRedfishRequest *self)
 {
 	self->status_code = 0;
+	self->retry_after = 0;
 	self->json_obj = NULL;
 }
 
@@ -286,6 +434,98 @@ fu_redfish_request_write_cb(char *ptr, size_t size, size_t nmemb, void *userdata
 	return realsize;
 }
 
+static size_t
+fu_redfish_request_header_cb(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+	FuRedfishRequest *self = FU_REDFISH_REQUEST(userdata);
+	gsize realsize = size * nmemb;
+	const gchar *key = "Retry-After:";
+	gsize keysz = strlen(key);
+
+	if (realsize > keysz && g_ascii_strncasecmp(ptr, key, keysz) == 0) {
+		guint64 tmp = 0;
+		g_autofree gchar *value = g_strndup(ptr + keysz, realsize - keysz);
+		if (fu_strtoull(g_strstrip(value), &tmp, 1, 3600, NULL))
+			self->retry_after = tmp;
+	}
+	return realsize;
+}
+
+static size_t
+fu_redfish_request_stream_read_cb(char *buf, size_t size, size_t nitems, void *userdata)
+{
+	GInputStream *stream = G_INPUT_STREAM(userdata);
+	gssize rc;
+	g_autoptr(GError) error_local = NULL;
+
+	rc = g_input_stream_read(stream, buf, size * nitems, NULL, &error_local);
+	if (rc < 0) {
+		g_warning("failed to read upload stream: %s", error_local->message);
+		return CURL_READFUNC_ABORT;
+	}
+	return (size_t)rc;
+}
+
+static int
+fu_redfish_request_stream_seek_cb(void *userdata, curl_off_t offset, int origin)
+{
+	GInputStream *stream = G_INPUT_STREAM(userdata);
+	GSeekType seek_type = G_SEEK_SET;
+
+	if (!G_IS_SEEKABLE(stream) || !g_seekable_can_seek(G_SEEKABLE(stream)))
+		return CURL_SEEKFUNC_CANTSEEK;
+	if (origin == SEEK_CUR)
+		seek_type = G_SEEK_CUR;
+	else if (origin == SEEK_END)
+		seek_type = G_SEEK_END;
+	if (!g_seekable_seek(G_SEEKABLE(stream), offset, seek_type, NULL, NULL))
+		return CURL_SEEKFUNC_FAIL;
+	return CURL_SEEKFUNC_OK;
+}
+
+/* the stream is read as the request is sent, so it must outlive the perform */
+gboolean
+fu_redfish_request_set_upload_stream(FuRedfishRequest *self, GInputStream *stream, GError **error)
+{
+	gsize streamsz = 0;
+
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
+	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), FALSE);
+
+	if (!fu_input_stream_size(stream, &streamsz, error))
+		return FALSE;
+	if (!g_seekable_seek(G_SEEKABLE(stream), 0, G_SEEK_SET, NULL, error))
+		return FALSE;
+	(void)curl_easy_setopt(self->curl, CURLOPT_POST, 1L);
+	(void)curl_easy_setopt(self->curl, CURLOPT_READFUNCTION, fu_redfish_request_stream_read_cb);
+	(void)curl_easy_setopt(self->curl, CURLOPT_READDATA, stream);
+	(void)curl_easy_setopt(self->curl, CURLOPT_SEEKFUNCTION, fu_redfish_request_stream_seek_cb);
+	(void)curl_easy_setopt(self->curl, CURLOPT_SEEKDATA, stream);
+	(void)curl_easy_setopt(self->curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)streamsz);
+	return TRUE;
+}
+
+gboolean
+fu_redfish_request_mimepart_set_stream(curl_mimepart *part, GInputStream *stream, GError **error)
+{
+	gsize streamsz = 0;
+
+	g_return_val_if_fail(part != NULL, FALSE);
+	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), FALSE);
+
+	if (!fu_input_stream_size(stream, &streamsz, error))
+		return FALSE;
+	if (!g_seekable_seek(G_SEEKABLE(stream), 0, G_SEEK_SET, NULL, error))
+		return FALSE;
+	(void)curl_mime_data_cb(part,
+				(curl_off_t)streamsz,
+				fu_redfish_request_stream_read_cb,
+				fu_redfish_request_stream_seek_cb,
+				NULL,
+				stream);
+	return TRUE;
+}
+
 void
 fu_redfish_request_set_cache(FuRedfishRequest *self, GHashTable *cache)
 {
@@ -312,6 +552,8 @@ fu_redfish_request_init(FuRedfishRequest *self)
 	self->json_parser = json_parser_new();
 	(void)curl_easy_setopt(self->curl, CURLOPT_WRITEFUNCTION, fu_redfish_request_write_cb);
 	(void)curl_easy_setopt(self->curl, CURLOPT_WRITEDATA, self->buf);
+	(void)curl_easy_setopt(self->curl, CURLOPT_HEADERFUNCTION, fu_redfish_request_header_cb);
+	(void)curl_easy_setopt(self->curl, CURLOPT_HEADERDATA, self);
 }
 
 static void
@@ -144,7 +144,7 @@ fu_redfish_smc_device_write_firmware(FuDevice *device,
 	gboolean ret;
 	g_autoptr(curl_mime) mime = NULL;
 	g_autoptr(FuRedfishRequest) request = NULL;
-	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GInputStream) stream = NULL;
 	g_autoptr(GString) params = NULL;
 
 	fu_progress_set_id(progress, G_STRLOC);
@@ -152,8 +152,8 @@ fu_redfish_smc_device_write_firmware(FuDevice *device,
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_RESTART, 50, "apply");
 
 	/* get default image */
-	fw = fu_firmware_get_bytes(firmware, error);
-	if (fw == NULL)
+	stream = fu_firmware_get_stream(firmware, error);
+	if (stream == NULL)
 		return FALSE;
 
 	/* create the multipart for uploading the image request */
@@ -173,7 +173,8 @@ fu_redfish_smc_device_write_firmware(FuDevice *device,
 	curl_mime_name(part, "UpdateFile");
 	(void)curl_mime_type(part, "application/octet-stream");
 	(void)curl_mime_filedata(part, "firmware.bin");
-	(void)curl_mime_data(part, g_bytes_get_data(fw, NULL), g_bytes_get_size(fw));
+	if (!fu_redfish_request_mimepart_set_stream(part, stream, error))
+		return FALSE;
 
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_WRITE);
 	if (!fu_redfish_request_perform(request,
@@ -50,6 +50,10 @@ def index():
         "UUID": "92384634-2938-2342-8820-489239905423",
         "UpdateService": {"@odata.id": "/redfish/v1/UpdateService"},
     }
+    if request.authorization["username"] == HARDCODED_SMC_USERNAME:
+        res["ProtocolFeaturesSupported"] = {
+            "ExpandQuery": {"ExpandAll": False, "Levels": False, "NoLinks": True}
+        }
     return Response(json.dumps(res), status=200, mimetype="application/json")
 
 
@@ -104,6 +108,11 @@ def firmware_inventory():
         ],
         "Members@odata.count": 2,
     }
+    if request.args.get("$expand") == ".":
+        res["Members"] = [
+            json.loads(firmware_inventory_bmc().get_data()),
+            json.loads(firmware_inventory_bios().get_data()),
+        ]
     return Response(json.dumps(res), status=200, mimetype="application/json")
 
 
@@ -10,6 +10,7 @@
 
 struct _FuTestPlugin {
 	FuPlugin parent_instance;
+	gint writes_in_progress; /* atomic */
 };
 
 G_DEFINE_TYPE(FuTestPlugin, fu_test_plugin, FU_TYPE_PLUGIN)
@@ -100,6 +101,7 @@ fu_test_plugin_modify_config(FuPlugin *plugin, const gchar *key, const gchar *va
 			       "RequestDelay",
 			       "RequestSupported",
 			       "VerifyDelay",
+			       "WriteBlockFilename",
 			       "WriteDelay",
 			       "WriteSupported",
 			       NULL};
@@ -184,7 +186,10 @@ fu_test_plugin_write_firmware(FuPlugin *plugin,
 			      FwupdInstallFlags flags,
 			      GError **error)
 {
+	FuTestPlugin *self = FU_TEST_PLUGIN(plugin);
+	gint writes_in_progress;
 	g_autofree gchar *decompress_delay_str = NULL;
+	g_autofree gchar *write_block_fn = NULL;
 	g_autofree gchar *write_delay_str = NULL;
 	g_autofree gchar *verify_delay_str = NULL;
 	guint64 delay_decompress_ms = 0;
@@ -244,9 +249,35 @@ fu_test_plugin_write_firmware(FuPlugin *plugin,
 			return FALSE;
 		}
 	}
+	writes_in_progress = g_atomic_int_add(&self->writes_in_progress, 1) + 1;
 	for (guint i = 0; i <= delay_write_ms; i++) {
 		fu_device_sleep(device, 1);
 		fu_progress_set_percentage_full(progress, i, delay_write_ms);
+		writes_in_progress =
+		    MAX(writes_in_progress, g_atomic_int_get(&self->writes_in_progress));
+	}
+	g_atomic_int_add(&self->writes_in_progress, -1);
+
+	/* so the self tests can check that devices are written in parallel */
+	if (writes_in_progress > 1)
+		fu_device_set_metadata_boolean(device, "WriteOverlapped", TRUE);
+
+	/* create the file, and then wait for the self test to delete it */
+	write_block_fn = fu_plugin_get_config_value(plugin, "WriteBlockFilename");
+	if (write_block_fn != NULL) {
+		if (!g_file_set_contents(write_block_fn, "", 0, error))
+			return FALSE;
+		for (guint i = 0; g_file_test(write_block_fn, G_FILE_TEST_EXISTS); i++) {
+			if (i > 60000) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_TIMED_OUT,
+					    "%s was never deleted",
+					    write_block_fn);
+				return FALSE;
+			}
+			fu_device_sleep(device, 1);
+		}
 	}
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_VERIFY);
 	verify_delay_str = fu_plugin_get_config_value(plugin, "VerifyDelay");
@@ -193,6 +193,60 @@ fu_tpm_eventlog_parse_v2_func(void)
 			"6d9fed68092cfb91c9552bcb7879e75e1df36efd407af67690dc3389a5722fab");
 }
 
+static gboolean
+fu_tpm_eventlog_replay_item_cb(FuTpmEventlogItem *item, gpointer user_data, GError **error)
+{
+	FuTpmEventlogReplay *replay = (FuTpmEventlogReplay *)user_data;
+	fu_tpm_eventlog_replay_add_item(replay, item);
+	fu_tpm_eventlog_parser_item_free(item);
+	return TRUE;
+}
+
+static void
+fu_tpm_eventlog_replay_func(void)
+{
+	const gchar *ci = g_getenv("CI_NETWORK");
+	const gchar *tmp;
+	gboolean ret;
+	gsize bufsz = 0;
+	g_autofree gchar *fn = NULL;
+	g_autofree guint8 *buf = NULL;
+	g_autoptr(FuTpmEventlogReplay) replay = fu_tpm_eventlog_replay_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) pcr0s = NULL;
+
+	fn = g_test_build_filename(G_TEST_DIST, "tests", "binary_bios_measurements-v2", NULL);
+	if (!g_file_test(fn, G_FILE_TEST_EXISTS) && ci == NULL) {
+		g_test_skip("Missing binary_bios_measurements-v2");
+		return;
+	}
+	ret = g_file_get_contents(fn, (gchar **)&buf, &bufsz, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* replay all the PCRs without keeping any items */
+	ret = fu_tpm_eventlog_parser_foreach(buf,
+					     bufsz,
+					     FU_TPM_EVENTLOG_PARSER_FLAG_ALL_PCRS,
+					     fu_tpm_eventlog_replay_item_cb,
+					     replay,
+					     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* same as only parsing PCR0 */
+	pcr0s = fu_tpm_eventlog_replay_get_checksums(replay, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(pcr0s);
+	g_assert_cmpint(pcr0s->len, ==, 2);
+	tmp = g_ptr_array_index(pcr0s, 0);
+	g_assert_cmpstr(tmp, ==, "ebead4b31c7c49e193c440cd6ee90bc1b61a3ca6");
+	tmp = g_ptr_array_index(pcr0s, 1);
+	g_assert_cmpstr(tmp,
+			==,
+			"6d9fed68092cfb91c9552bcb7879e75e1df36efd407af67690dc3389a5722fab");
+}
+
 static void
 fu_tpm_empty_pcr_func(void)
 {
@@ -263,5 +317,6 @@ main(int argc, char **argv)
 	g_test_add_func("/tpm/empty-pcr", fu_tpm_empty_pcr_func);
 	g_test_add_func("/tpm/eventlog-parse{v1}", fu_tpm_eventlog_parse_v1_func);
 	g_test_add_func("/tpm/eventlog-parse{v2}", fu_tpm_eventlog_parse_v2_func);
+	g_test_add_func("/tpm/eventlog-replay", fu_tpm_eventlog_replay_func);
 	return g_test_run();
 }
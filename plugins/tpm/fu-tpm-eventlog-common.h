@@ -21,6 +21,8 @@ typedef struct {
 	GBytes *blob;
 } FuTpmEventlogItem;
 
+typedef struct FuTpmEventlogReplay FuTpmEventlogReplay;
+
 const gchar *
 fu_tpm_eventlog_pcr_to_string(gint pcr);
 guint32
@@ -31,3 +33,13 @@ gchar *
 fu_tpm_eventlog_blobstr(GBytes *blob);
 GPtrArray *
 fu_tpm_eventlog_calc_checksums(GPtrArray *items, guint8 pcr, GError **error);
+FuTpmEventlogReplay *
+fu_tpm_eventlog_replay_new(void);
+void
+fu_tpm_eventlog_replay_free(FuTpmEventlogReplay *self);
+void
+fu_tpm_eventlog_replay_add_item(FuTpmEventlogReplay *self, FuTpmEventlogItem *item);
+GPtrArray *
+fu_tpm_eventlog_replay_get_checksums(FuTpmEventlogReplay *self, guint8 pcr_idx, GError **error);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuTpmEventlogReplay, fu_tpm_eventlog_replay_free)
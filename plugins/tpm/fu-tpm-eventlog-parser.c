@@ -19,7 +19,7 @@
 
 #define FU_TPM_EVENTLOG_V2_HDR_SIGNATURE "Spec ID Event03"
 
-static void
+void
 fu_tpm_eventlog_parser_item_free(FuTpmEventlogItem *item)
 {
 	if (item->blob != NULL)
@@ -33,8 +33,6 @@ fu_tpm_eventlog_parser_item_free(FuTpmEventlogItem *item)
 	g_free(item);
 }
 
-G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuTpmEventlogItem, fu_tpm_eventlog_parser_item_free);
-
 void
 fu_tpm_eventlog_item_to_string(FuTpmEventlogItem *item, guint idt, GString *str)
 {
@@ -64,14 +62,15 @@ fu_tpm_eventlog_item_to_string(FuTpmEventlogItem *item, guint idt, GString *str)
 	}
 }
 
-static GPtrArray *
+static gboolean
 fu_tpm_eventlog_parser_parse_blob_v2(const guint8 *buf,
 				     gsize bufsz,
 				     FuTpmEventlogParserFlags flags,
+				     FuTpmEventlogParserFunc func,
+				     gpointer user_data,
 				     GError **error)
 {
 	guint32 hdrsz = 0x0;
-	g_autoptr(GPtrArray) items = NULL;
 
 	/* advance over the header block */
 	if (!fu_memread_uint32_safe(buf,
@@ -80,8 +79,7 @@ fu_tpm_eventlog_parser_parse_blob_v2(const guint8 *buf,
 				    &hdrsz,
 				    G_LITTLE_ENDIAN,
 				    error))
-		return NULL;
-	items = g_ptr_array_new_with_free_func((GDestroyNotify)fu_tpm_eventlog_parser_item_free);
+		return FALSE;
 	for (gsize idx = FU_TPM_EVENTLOG_V1_SIZE + hdrsz; idx < bufsz;) {
 		guint32 pcr;
 		guint32 digestcnt;
@@ -94,7 +92,7 @@ fu_tpm_eventlog_parser_parse_blob_v2(const guint8 *buf,
 		/* read checksum block */
 		st = fu_struct_tpm_event_log2_parse(buf, bufsz, idx, error);
 		if (st == NULL)
-			return NULL;
+			return FALSE;
 		idx += st->len;
 		digestcnt = fu_struct_tpm_event_log2_get_digest_count(st);
 		for (guint i = 0; i < digestcnt; i++) {
@@ -109,7 +107,7 @@ fu_tpm_eventlog_parser_parse_blob_v2(const guint8 *buf,
 						    &alg_type,
 						    G_LITTLE_ENDIAN,
 						    error))
-				return NULL;
+				return FALSE;
 			alg_size = fu_tpm_eventlog_hash_get_size(alg_type);
 			if (alg_size == 0) {
 				g_set_error(error,
@@ -117,7 +115,7 @@ fu_tpm_eventlog_parser_parse_blob_v2(const guint8 *buf,
 					    FWUPD_ERROR_NOT_SUPPORTED,
 					    "hash algorithm 0x%x size not known",
 					    alg_type);
-				return NULL;
+				return FALSE;
 			}
 
 			/* build checksum */
@@ -133,7 +131,7 @@ fu_tpm_eventlog_parser_parse_blob_v2(const guint8 *buf,
 					    idx, /* src */
 					    alg_size,
 					    error))
-				return NULL;
+				return FALSE;
 
 			/* save this for analysis */
 			if (alg_type == TPM2_ALG_SHA1)
@@ -152,13 +150,13 @@ fu_tpm_eventlog_parser_parse_blob_v2(const guint8 *buf,
 
 		/* read data block */
 		if (!fu_memread_uint32_safe(buf, bufsz, idx, &datasz, G_LITTLE_ENDIAN, error))
-			return NULL;
+			return FALSE;
 		if (datasz > 1024 * 1024) {
 			g_set_error_literal(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_NOT_SUPPORTED,
 					    "event log item too large");
-			return NULL;
+			return FALSE;
 		}
 
 		/* save blob if PCR=0 */
@@ -184,11 +182,12 @@ fu_tpm_eventlog_parser_parse_blob_v2(const guint8 *buf,
 						    idx,
 						    datasz, /* src */
 						    error))
-					return NULL;
+					return FALSE;
 				item->blob = g_bytes_new_take(g_steal_pointer(&data), datasz);
 				fu_dump_bytes(G_LOG_DOMAIN, "TpmEvent", item->blob);
 			}
-			g_ptr_array_add(items, g_steal_pointer(&item));
+			if (!func(g_steal_pointer(&item), user_data, error))
+				return FALSE;
 		}
 
 		/* next entry */
@@ -196,19 +195,22 @@ fu_tpm_eventlog_parser_parse_blob_v2(const guint8 *buf,
 	}
 
 	/* success */
-	return g_steal_pointer(&items);
+	return TRUE;
 }
 
-GPtrArray *
-fu_tpm_eventlog_parser_new(const guint8 *buf,
-			   gsize bufsz,
-			   FuTpmEventlogParserFlags flags,
-			   GError **error)
+/* each item is passed to @func as soon as it is parsed, so large logs do not have to be held */
+gboolean
+fu_tpm_eventlog_parser_foreach(const guint8 *buf,
+			       gsize bufsz,
+			       FuTpmEventlogParserFlags flags,
+			       FuTpmEventlogParserFunc func,
+			       gpointer user_data,
+			       GError **error)
 {
 	gchar sig[] = FU_TPM_EVENTLOG_V2_HDR_SIGNATURE;
-	g_autoptr(GPtrArray) items = NULL;
 
-	g_return_val_if_fail(buf != NULL, NULL);
+	g_return_val_if_fail(buf != NULL, FALSE);
+	g_return_val_if_fail(func != NULL, FALSE);
 
 	/* look for TCG v2 signature */
 	if (!fu_memcpy_safe((guint8 *)sig,
@@ -219,12 +221,16 @@ fu_tpm_eventlog_parser_new(const guint8 *buf,
 			    FU_TPM_EVENTLOG_V1_SIZE, /* src */
 			    sizeof(sig),
 			    error))
-		return NULL;
+		return FALSE;
 	if (g_strcmp0(sig, FU_TPM_EVENTLOG_V2_HDR_SIGNATURE) == 0)
-		return fu_tpm_eventlog_parser_parse_blob_v2(buf, bufsz, flags, error);
+		return fu_tpm_eventlog_parser_parse_blob_v2(buf,
+							    bufsz,
+							    flags,
+							    func,
+							    user_data,
+							    error);
 
 	/* assume v1 structure */
-	items = g_ptr_array_new_with_free_func((GDestroyNotify)fu_tpm_eventlog_parser_item_free);
 	for (gsize idx = 0; idx < bufsz; idx += FU_TPM_EVENTLOG_V1_SIZE) {
 		guint32 datasz = 0;
 		guint32 pcr = 0;
@@ -235,27 +241,27 @@ fu_tpm_eventlog_parser_new(const guint8 *buf,
 					    &pcr,
 					    G_LITTLE_ENDIAN,
 					    error))
-			return NULL;
+			return FALSE;
 		if (!fu_memread_uint32_safe(buf,
 					    bufsz,
 					    idx + FU_TPM_EVENTLOG_V1_IDX_TYPE,
 					    &event_type,
 					    G_LITTLE_ENDIAN,
 					    error))
-			return NULL;
+			return FALSE;
 		if (!fu_memread_uint32_safe(buf,
 					    bufsz,
 					    idx + FU_TPM_EVENTLOG_V1_IDX_EVENT_SIZE,
 					    &datasz,
 					    G_LITTLE_ENDIAN,
 					    error))
-			return NULL;
+			return FALSE;
 		if (datasz > 1024 * 1024) {
 			g_set_error_literal(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_NOT_SUPPORTED,
 					    "event log item too large");
-			return NULL;
+			return FALSE;
 		}
 		if (pcr == ESYS_TR_PCR0 || flags & FU_TPM_EVENTLOG_PARSER_FLAG_ALL_PCRS) {
 			g_autoptr(FuTpmEventlogItem) item = NULL;
@@ -270,7 +276,7 @@ fu_tpm_eventlog_parser_new(const guint8 *buf,
 					    idx + FU_TPM_EVENTLOG_V1_IDX_DIGEST, /* src */
 					    sizeof(digest),
 					    error))
-				return NULL;
+				return FALSE;
 
 			/* build item */
 			item = g_new0(FuTpmEventlogItem, 1);
@@ -287,13 +293,40 @@ fu_tpm_eventlog_parser_new(const guint8 *buf,
 						    idx + FU_TPM_EVENTLOG_V1_SIZE, /* src */
 						    datasz,
 						    error))
-					return NULL;
+					return FALSE;
 				item->blob = g_bytes_new_take(g_steal_pointer(&data), datasz);
 				fu_dump_bytes(G_LOG_DOMAIN, "TpmEvent", item->blob);
 			}
-			g_ptr_array_add(items, g_steal_pointer(&item));
+			if (!func(g_steal_pointer(&item), user_data, error))
+				return FALSE;
 		}
 		idx += datasz;
 	}
+	return TRUE;
+}
+
+static gboolean
+fu_tpm_eventlog_parser_collect_cb(FuTpmEventlogItem *item, gpointer user_data, GError **error)
+{
+	GPtrArray *items = (GPtrArray *)user_data;
+	g_ptr_array_add(items, item);
+	return TRUE;
+}
+
+GPtrArray *
+fu_tpm_eventlog_parser_new(const guint8 *buf,
+			   gsize bufsz,
+			   FuTpmEventlogParserFlags flags,
+			   GError **error)
+{
+	g_autoptr(GPtrArray) items =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_tpm_eventlog_parser_item_free);
+	if (!fu_tpm_eventlog_parser_foreach(buf,
+					    bufsz,
+					    flags,
+					    fu_tpm_eventlog_parser_collect_cb,
+					    items,
+					    error))
+		return NULL;
 	return g_steal_pointer(&items);
 }
@@ -16,10 +16,26 @@ typedef enum {
 	FU_TPM_EVENTLOG_PARSER_FLAG_LAST
 } FuTpmEventlogParserFlags;
 
+/* takes ownership of @item */
+typedef gboolean (*FuTpmEventlogParserFunc)(FuTpmEventlogItem *item,
+					    gpointer user_data,
+					    GError **error);
+
 GPtrArray *
 fu_tpm_eventlog_parser_new(const guint8 *buf,
 			   gsize bufsz,
 			   FuTpmEventlogParserFlags flags,
 			   GError **error);
+gboolean
+fu_tpm_eventlog_parser_foreach(const guint8 *buf,
+			       gsize bufsz,
+			       FuTpmEventlogParserFlags flags,
+			       FuTpmEventlogParserFunc func,
+			       gpointer user_data,
+			       GError **error);
+void
+fu_tpm_eventlog_parser_item_free(FuTpmEventlogItem *item);
 void
 fu_tpm_eventlog_item_to_string(FuTpmEventlogItem *item, guint idt, GString *str);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuTpmEventlogItem, fu_tpm_eventlog_parser_item_free)
@@ -28,20 +28,44 @@ fu_tmp_eventlog_sort_cb(gconstpointer a, gconstpointer b)
 	return 0;
 }
 
+typedef struct {
+	GPtrArray *items;
+	FuTpmEventlogReplay *replay;
+} FuTpmEventlogHelper;
+
+static gboolean
+fu_tmp_eventlog_item_cb(FuTpmEventlogItem *item, gpointer user_data, GError **error)
+{
+	FuTpmEventlogHelper *helper = (FuTpmEventlogHelper *)user_data;
+	fu_tpm_eventlog_replay_add_item(helper->replay, item);
+	g_ptr_array_add(helper->items, item);
+	return TRUE;
+}
+
 static gboolean
 fu_tmp_eventlog_process(const gchar *fn, gint pcr, GError **error)
 {
 	gsize bufsz = 0;
 	g_autofree guint8 *buf = NULL;
-	g_autoptr(GPtrArray) items = NULL;
+	g_autoptr(GPtrArray) items =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_tpm_eventlog_parser_item_free);
+	g_autoptr(FuTpmEventlogReplay) replay = fu_tpm_eventlog_replay_new();
 	g_autoptr(GString) str = g_string_new(NULL);
 	gint max_pcr = 0;
+	FuTpmEventlogHelper helper = {
+	    .items = items,
+	    .replay = replay,
+	};
 
-	/* parse this */
+	/* parse this, replaying every PCR in log order before the items are sorted */
 	if (!g_file_get_contents(fn, (gchar **)&buf, &bufsz, error))
 		return FALSE;
-	items = fu_tpm_eventlog_parser_new(buf, bufsz, FU_TPM_EVENTLOG_PARSER_FLAG_ALL_PCRS, error);
-	if (items == NULL)
+	if (!fu_tpm_eventlog_parser_foreach(buf,
+					    bufsz,
+					    FU_TPM_EVENTLOG_PARSER_FLAG_ALL_PCRS,
+					    fu_tmp_eventlog_item_cb,
+					    &helper,
+					    error))
 		return FALSE;
 	g_ptr_array_sort(items, fu_tmp_eventlog_sort_cb);
 
@@ -64,7 +88,7 @@ fu_tmp_eventlog_process(const gchar *fn, gint pcr, GError **error)
 	}
 	fwupd_codec_string_append(str, 0, "Reconstructed PCRs", "");
 	for (guint8 i = 0; i <= max_pcr; i++) {
-		g_autoptr(GPtrArray) pcrs = fu_tpm_eventlog_calc_checksums(items, i, NULL);
+		g_autoptr(GPtrArray) pcrs = fu_tpm_eventlog_replay_get_checksums(replay, i, NULL);
 		if (pcrs == NULL)
 			continue;
 		for (guint j = 0; j < pcrs->len; j++) {
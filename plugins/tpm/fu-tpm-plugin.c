@@ -15,7 +15,8 @@ struct _FuTpmPlugin {
 	FuPlugin parent_instance;
 	FuTpmDevice *tpm_device;
 	FuDevice *bios_device;
-	GPtrArray *ev_items; /* of FuTpmEventlogItem */
+	GPtrArray *ev_items;		/* of FuTpmEventlogItem */
+	FuTpmEventlogReplay *ev_replay; /* (nullable) all PCRs, built with ev_items */
 };
 
 G_DEFINE_TYPE(FuTpmPlugin, fu_tpm_plugin, FU_TYPE_PLUGIN)
@@ -151,13 +152,13 @@ fu_tpm_plugin_add_security_attr_eventlog(FuPlugin *plugin, FuSecurityAttrs *attr
 	fu_security_attrs_append(attrs, attr);
 
 	/* check reconstructed to PCR0 */
-	if (self->ev_items == NULL) {
+	if (self->ev_replay == NULL) {
 		fwupd_security_attr_set_result(attr, FWUPD_SECURITY_ATTR_RESULT_NOT_FOUND);
 		return;
 	}
 
 	/* calculate from the eventlog */
-	pcr0s_calc = fu_tpm_eventlog_calc_checksums(self->ev_items, 0, &error);
+	pcr0s_calc = fu_tpm_eventlog_replay_get_checksums(self->ev_replay, 0, &error);
 	if (pcr0s_calc == NULL) {
 		g_warning("failed to get eventlog reconstruction: %s", error->message);
 		fwupd_security_attr_set_result(attr, FWUPD_SECURITY_ATTR_RESULT_NOT_VALID);
@@ -276,7 +277,7 @@ fu_tpm_plugin_eventlog_report_metadata(FuPlugin *plugin)
 			g_string_append_printf(str, " [%s]", blobstr);
 		g_string_append(str, "\n");
 	}
-	pcrs = fu_tpm_eventlog_calc_checksums(self->ev_items, 0, NULL);
+	pcrs = fu_tpm_eventlog_replay_get_checksums(self->ev_replay, 0, NULL);
 	if (pcrs != NULL) {
 		for (guint j = 0; j < pcrs->len; j++) {
 			const gchar *csum = g_ptr_array_index(pcrs, j);
@@ -288,6 +289,15 @@ fu_tpm_plugin_eventlog_report_metadata(FuPlugin *plugin)
 	return g_string_free(str, FALSE);
 }
 
+static gboolean
+fu_tpm_plugin_eventlog_item_cb(FuTpmEventlogItem *item, gpointer user_data, GError **error)
+{
+	FuTpmPlugin *self = FU_TPM_PLUGIN(user_data);
+	fu_tpm_eventlog_replay_add_item(self->ev_replay, item);
+	g_ptr_array_add(self->ev_items, item);
+	return TRUE;
+}
+
 static gboolean
 fu_tpm_plugin_coldplug_eventlog(FuPlugin *plugin, GError **error)
 {
@@ -312,10 +322,21 @@ fu_tpm_plugin_coldplug_eventlog(FuPlugin *plugin, GError **error)
 			    fn);
 		return FALSE;
 	}
+
+	/* the PCRs are replayed as the log is parsed, and not again until it is reloaded */
 	self->ev_items =
-	    fu_tpm_eventlog_parser_new(buf, bufsz, FU_TPM_EVENTLOG_PARSER_FLAG_NONE, error);
-	if (self->ev_items == NULL)
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_tpm_eventlog_parser_item_free);
+	self->ev_replay = fu_tpm_eventlog_replay_new();
+	if (!fu_tpm_eventlog_parser_foreach(buf,
+					    bufsz,
+					    FU_TPM_EVENTLOG_PARSER_FLAG_NONE,
+					    fu_tpm_plugin_eventlog_item_cb,
+					    self,
+					    error)) {
+		g_clear_pointer(&self->ev_items, g_ptr_array_unref);
+		g_clear_pointer(&self->ev_replay, fu_tpm_eventlog_replay_free);
 		return FALSE;
+	}
 
 	/* add optional report metadata */
 	str = fu_tpm_plugin_eventlog_report_metadata(plugin);
@@ -385,6 +406,8 @@ fu_tpm_finalize(GObject *obj)
 		g_object_unref(self->bios_device);
 	if (self->ev_items != NULL)
 		g_ptr_array_unref(self->ev_items);
+	if (self->ev_replay != NULL)
+		fu_tpm_eventlog_replay_free(self->ev_replay);
 	G_OBJECT_CLASS(fu_tpm_plugin_parent_class)->finalize(obj);
 }
 
@@ -79,42 +79,17 @@ fu_uefi_bootmgr_parse_name(const gchar *name)
 gboolean
 fu_uefi_bootmgr_verify_fwupd(GError **error)
 {
-	g_autoptr(GPtrArray) names = NULL;
+	g_autoptr(GPtrArray) entries = NULL;
 
-	names = fu_efivar_get_names(FU_EFIVAR_GUID_EFI_GLOBAL, error);
-	if (names == NULL)
+	entries = fu_efivar_get_boot_entries(error);
+	if (entries == NULL)
 		return FALSE;
-	for (guint i = 0; i < names->len; i++) {
-		const gchar *desc;
-		const gchar *name = g_ptr_array_index(names, i);
-		guint16 entry;
-		g_autoptr(FuEfiLoadOption) loadopt = fu_efi_load_option_new();
-		g_autoptr(GBytes) loadopt_blob = NULL;
-		g_autoptr(GError) error_local = NULL;
-
-		/* not BootXXXX */
-		entry = fu_uefi_bootmgr_parse_name(name);
-		if (entry == G_MAXUINT16)
-			continue;
-
-		/* parse key */
-		loadopt_blob =
-		    fu_efivar_get_data_bytes(FU_EFIVAR_GUID_EFI_GLOBAL, name, NULL, &error_local);
-		if (loadopt_blob == NULL) {
-			g_debug("failed to get data for name %s: %s", name, error_local->message);
-			continue;
-		}
-		if (!fu_firmware_parse(FU_FIRMWARE(loadopt),
-				       loadopt_blob,
-				       FWUPD_INSTALL_FLAG_NONE,
-				       &error_local)) {
-			g_debug("%s -> load option was invalid: %s", name, error_local->message);
-			continue;
-		}
-		desc = fu_firmware_get_id(FU_FIRMWARE(loadopt));
+	for (guint i = 0; i < entries->len; i++) {
+		FuFirmware *loadopt = g_ptr_array_index(entries, i);
+		const gchar *desc = fu_firmware_get_id(loadopt);
 		if (g_strcmp0(desc, "Linux Firmware Updater") == 0 ||
 		    g_strcmp0(desc, "Linux-Firmware-Updater") == 0) {
-			g_debug("found %s at Boot%04X", desc, entry);
+			g_debug("found %s at Boot%04X", desc, (guint)fu_firmware_get_idx(loadopt));
 			return TRUE;
 		}
 	}
@@ -256,19 +256,27 @@ static GBytes *
 fu_uefi_capsule_plugin_get_splash_data(guint width, guint height, GError **error)
 {
 	const gchar *const *langs = g_get_language_names();
+	const gchar *basenames[] = {"uefi-capsule-ux.zip", "uefi-capsule-ux.tar.xz", NULL};
 	g_autofree gchar *datadir_pkg = NULL;
 	g_autofree gchar *filename_archive = NULL;
 	g_autofree gchar *langs_str = NULL;
 	g_autoptr(FuArchive) archive = NULL;
 	g_autoptr(GBytes) blob_archive = NULL;
 
-	/* load archive */
+	/* prefer the bundle where each image is compressed on its own */
 	datadir_pkg = fu_path_from_kind(FU_PATH_KIND_DATADIR_PKG);
-	filename_archive = g_build_filename(datadir_pkg, "uefi-capsule-ux.tar.xz", NULL);
+	for (guint i = 0; basenames[i] != NULL; i++) {
+		g_free(filename_archive);
+		filename_archive = g_build_filename(datadir_pkg, basenames[i], NULL);
+		if (g_file_test(filename_archive, G_FILE_TEST_EXISTS))
+			break;
+	}
 	blob_archive = fu_bytes_get_contents(filename_archive, error);
 	if (blob_archive == NULL)
 		return NULL;
-	archive = fu_archive_new(blob_archive, FU_ARCHIVE_FLAG_NONE, error);
+
+	/* only decompress the one image we need */
+	archive = fu_archive_new(blob_archive, FU_ARCHIVE_FLAG_LAZY, error);
 	if (archive == NULL)
 		return NULL;
 
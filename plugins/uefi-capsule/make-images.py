@@ -14,6 +14,7 @@ import os
 import sys
 import argparse
 import tarfile
+import zipfile
 import math
 import io
 import struct
@@ -87,9 +88,40 @@ def _cairo_surface_write_to_bmp(img: cairo.ImageSurface) -> bytes:
     )
 
 
+class Bundle:
+    """either a solid .tar.xz, or a .zip where each image is compressed on its own"""
+
+    def __init__(self, fn: str):
+        self._zip: Optional[zipfile.ZipFile] = None
+        self._tar: Optional[tarfile.TarFile] = None
+        if fn.endswith(".zip"):
+            self._zip = zipfile.ZipFile(
+                fn, "w", compression=zipfile.ZIP_DEFLATED, compresslevel=9
+            )
+        else:
+            self._tar = tarfile.open(fn, "w:xz", preset=8)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        if self._zip:
+            self._zip.close()
+        if self._tar:
+            self._tar.close()
+
+    def addfile(self, filename: str, data: bytes) -> None:
+        if self._zip:
+            self._zip.writestr(filename, data)
+        if self._tar:
+            tarinfo = tarfile.TarInfo(filename)
+            tarinfo.size = len(data)
+            self._tar.addfile(tarinfo, fileobj=io.BytesIO(data))
+
+
 def main(args) -> int:
     # open output archive
-    with tarfile.open(args.out, "w:xz", preset=8) as tar:
+    with Bundle(args.out) as bundle:
         for lang in languages(args.podir):
             # these are the 1.6:1 of some common(ish) screen widths
             if lang == "en":
@@ -196,13 +228,8 @@ def main(args) -> int:
                 img.flush()
 
                 # convert to BMP and add to archive
-                with io.BytesIO() as io_bmp:
-                    io_bmp.write(_cairo_surface_write_to_bmp(img))
-                    filename = f"fwupd-{lang}-{width}-{height}.bmp"
-                    tarinfo = tarfile.TarInfo(filename)
-                    tarinfo.size = io_bmp.tell()
-                    io_bmp.seek(0)
-                    tar.addfile(tarinfo, fileobj=io_bmp)
+                filename = f"fwupd-{lang}-{width}-{height}.bmp"
+                bundle.addfile(filename, _cairo_surface_write_to_bmp(img))
 
     # success
     return 0
@@ -32,36 +32,31 @@ fu_uefi_dbx_get_authenticode_hash(const gchar *fn, GError **error)
 static GPtrArray *
 fu_uefi_dbx_get_basenames_bootxxxx(void)
 {
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) entries = NULL;
 	g_autoptr(GPtrArray) files = g_ptr_array_new_with_free_func(g_free);
 
 	/* hardcoded, as we chainload from shim to these */
 	g_ptr_array_add(files, g_strdup_printf("fwupd%s.efi", EFI_MACHINE_TYPE_NAME));
 	g_ptr_array_add(files, g_strdup_printf("grub%s.efi", EFI_MACHINE_TYPE_NAME));
 
-	for (guint i = 0; i <= G_MAXUINT16; i++) {
+	/* all the BootXXXX entries that exist */
+	entries = fu_efivar_get_boot_entries(&error);
+	if (entries == NULL) {
+		g_debug("failed to get boot entries: %s", error->message);
+		return g_steal_pointer(&files);
+	}
+	for (guint i = 0; i < entries->len; i++) {
+		FuEfiLoadOption *loadopt = g_ptr_array_index(entries, i);
 		g_autofree gchar *basename = NULL;
 		g_autofree gchar *basename_down = NULL;
 		g_autofree gchar *fullpath = NULL;
-		g_autofree gchar *name = g_strdup_printf("Boot%04X", i);
-		g_autoptr(FuEfiLoadOption) loadopt = NULL;
+		g_autofree gchar *name =
+		    g_strdup_printf("Boot%04X", (guint)fu_firmware_get_idx(FU_FIRMWARE(loadopt)));
 		g_autoptr(FuFirmware) dp_buf = NULL;
 		g_autoptr(FuFirmware) dp_file = NULL;
-		g_autoptr(GBytes) blob = NULL;
 		g_autoptr(GError) error_local = NULL;
 
-		/* load EFI load option */
-		blob = fu_efivar_get_data_bytes(FU_EFIVAR_GUID_EFI_GLOBAL, name, NULL, NULL);
-		if (blob == NULL)
-			continue;
-		loadopt = fu_efi_load_option_new();
-		if (!fu_firmware_parse(FU_FIRMWARE(loadopt),
-				       blob,
-				       FWUPD_INSTALL_FLAG_NONE,
-				       &error_local)) {
-			g_warning("failed to parse %s: %s", name, error_local->message);
-			continue;
-		}
-
 		/* get EfiFilePath from the list of DEVICE PATHs */
 		dp_buf = fu_firmware_get_image_by_gtype(FU_FIRMWARE(loadopt),
 							FU_TYPE_EFI_DEVICE_PATH_LIST,
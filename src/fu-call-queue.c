@@ -0,0 +1,135 @@
+/*
+ * Copyright 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define G_LOG_DOMAIN "FuCallQueue"
+
+#include "config.h"
+
+#include "fu-call-queue.h"
+
+/*
+ * Calls can be pushed from any thread, and are run in order by the default main context. Until
+ * fu_call_queue_set_ready() is called they are held back, so that nested main loops (for
+ * instance while the engine is loading) cannot run them early.
+ */
+
+struct _FuCallQueue {
+	GObject parent_instance;
+	GMutex mutex;
+	GQueue *pending; /* (element-type FuCallQueueItem) protected by mutex */
+	gboolean ready;	 /* protected by mutex */
+};
+
+typedef struct {
+	GSourceFunc func;
+	gpointer data;
+	GDestroyNotify destroy;
+} FuCallQueueItem;
+
+G_DEFINE_TYPE(FuCallQueue, fu_call_queue, G_TYPE_OBJECT)
+
+static void
+fu_call_queue_item_free(FuCallQueueItem *item)
+{
+	if (item->destroy != NULL)
+		item->destroy(item->data);
+	g_free(item);
+}
+
+static void
+fu_call_queue_attach(GSourceFunc func, gpointer data, GDestroyNotify destroy)
+{
+	g_autoptr(GSource) source = g_idle_source_new();
+	g_source_set_priority(source, G_PRIORITY_DEFAULT);
+	g_source_set_callback(source, func, data, destroy);
+	g_source_attach(source, NULL);
+}
+
+/* can be called from any thread */
+void
+fu_call_queue_push(FuCallQueue *self, GSourceFunc func, gpointer data, GDestroyNotify destroy)
+{
+	FuCallQueueItem *item;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->mutex);
+
+	g_return_if_fail(FU_IS_CALL_QUEUE(self));
+	g_return_if_fail(func != NULL);
+
+	if (self->ready) {
+		fu_call_queue_attach(func, data, destroy);
+		return;
+	}
+	item = g_new0(FuCallQueueItem, 1);
+	item->func = func;
+	item->data = data;
+	item->destroy = destroy;
+	g_queue_push_tail(self->pending, item);
+}
+
+/* schedules the held calls in the order they were pushed */
+void
+fu_call_queue_set_ready(FuCallQueue *self)
+{
+	FuCallQueueItem *item;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->mutex);
+
+	g_return_if_fail(FU_IS_CALL_QUEUE(self));
+
+	if (self->ready)
+		return;
+	if (g_queue_get_length(self->pending) > 0)
+		g_debug("running %u held calls", g_queue_get_length(self->pending));
+	while ((item = g_queue_pop_head(self->pending)) != NULL) {
+		fu_call_queue_attach(item->func, item->data, item->destroy);
+		g_free(item);
+	}
+	self->ready = TRUE;
+}
+
+gboolean
+fu_call_queue_get_ready(FuCallQueue *self)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->mutex);
+	g_return_val_if_fail(FU_IS_CALL_QUEUE(self), FALSE);
+	return self->ready;
+}
+
+guint
+fu_call_queue_get_pending(FuCallQueue *self)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->mutex);
+	g_return_val_if_fail(FU_IS_CALL_QUEUE(self), 0);
+	return g_queue_get_length(self->pending);
+}
+
+static void
+fu_call_queue_init(FuCallQueue *self)
+{
+	g_mutex_init(&self->mutex);
+	self->pending = g_queue_new();
+}
+
+static void
+fu_call_queue_finalize(GObject *obj)
+{
+	FuCallQueue *self = FU_CALL_QUEUE(obj);
+	g_queue_free_full(self->pending, (GDestroyNotify)fu_call_queue_item_free);
+	g_mutex_clear(&self->mutex);
+	G_OBJECT_CLASS(fu_call_queue_parent_class)->finalize(obj);
+}
+
+static void
+fu_call_queue_class_init(FuCallQueueClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_call_queue_finalize;
+}
+
+FuCallQueue *
+fu_call_queue_new(void)
+{
+	return FU_CALL_QUEUE(g_object_new(FU_TYPE_CALL_QUEUE, NULL));
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include <fwupdplugin.h>
+
+#define FU_TYPE_CALL_QUEUE (fu_call_queue_get_type())
+G_DECLARE_FINAL_TYPE(FuCallQueue, fu_call_queue, FU, CALL_QUEUE, GObject)
+
+FuCallQueue *
+fu_call_queue_new(void);
+void
+fu_call_queue_push(FuCallQueue *self, GSourceFunc func, gpointer data, GDestroyNotify destroy)
+    G_GNUC_NON_NULL(1, 2);
+void
+fu_call_queue_set_ready(FuCallQueue *self) G_GNUC_NON_NULL(1);
+gboolean
+fu_call_queue_get_ready(FuCallQueue *self) G_GNUC_NON_NULL(1);
+guint
+fu_call_queue_get_pending(FuCallQueue *self) G_GNUC_NON_NULL(1);
@@ -16,6 +16,8 @@ struct _FuClient {
 	GHashTable *hints; /* str:str */
 	FwupdFeatureFlags feature_flags;
 	FuClientFlag flags;
+	guint uid;
+	GPtrArray *invocations; /* (element-type GDBusMethodInvocation) */
 };
 
 G_DEFINE_TYPE(FuClient, fu_client, G_TYPE_OBJECT)
@@ -90,6 +92,41 @@ fu_client_has_flag(FuClient *self, FuClientFlag flag)
 	return (self->flags & flag) > 0;
 }
 
+void
+fu_client_set_uid(FuClient *self, guint uid)
+{
+	g_return_if_fail(FU_IS_CLIENT(self));
+	self->uid = uid;
+	fu_client_add_flag(self, FU_CLIENT_FLAG_HAS_UID);
+}
+
+guint
+fu_client_get_uid(FuClient *self)
+{
+	g_return_val_if_fail(FU_IS_CLIENT(self), G_MAXUINT);
+	return self->uid;
+}
+
+/* returns TRUE if this is the first invocation waiting for the credentials */
+gboolean
+fu_client_add_invocation(FuClient *self, GDBusMethodInvocation *invocation)
+{
+	g_return_val_if_fail(FU_IS_CLIENT(self), FALSE);
+	g_return_val_if_fail(G_IS_DBUS_METHOD_INVOCATION(invocation), FALSE);
+	g_ptr_array_add(self->invocations, g_object_ref(invocation));
+	return self->invocations->len == 1;
+}
+
+GPtrArray *
+fu_client_steal_invocations(FuClient *self)
+{
+	g_autoptr(GPtrArray) invocations = NULL;
+	g_return_val_if_fail(FU_IS_CLIENT(self), NULL);
+	invocations = g_steal_pointer(&self->invocations);
+	self->invocations = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	return g_steal_pointer(&invocations);
+}
+
 static void
 fu_client_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
 {
@@ -127,7 +164,9 @@ fu_client_set_property(GObject *object, guint prop_id, const GValue *value, GPar
 static void
 fu_client_init(FuClient *self)
 {
+	self->uid = G_MAXUINT;
 	self->hints = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	self->invocations = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 }
 
 static void
@@ -136,6 +175,7 @@ fu_client_finalize(GObject *obj)
 	FuClient *self = FU_CLIENT(obj);
 	g_free(self->sender);
 	g_hash_table_unref(self->hints);
+	g_ptr_array_unref(self->invocations);
 	G_OBJECT_CLASS(fu_client_parent_class)->finalize(obj);
 }
 
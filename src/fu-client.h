@@ -27,6 +27,14 @@ fu_client_set_feature_flags(FuClient *self, FwupdFeatureFlags feature_flags) G_G
 FwupdFeatureFlags
 fu_client_get_feature_flags(FuClient *self) G_GNUC_NON_NULL(1);
 void
+fu_client_set_uid(FuClient *self, guint uid) G_GNUC_NON_NULL(1);
+guint
+fu_client_get_uid(FuClient *self) G_GNUC_NON_NULL(1);
+gboolean
+fu_client_add_invocation(FuClient *self, GDBusMethodInvocation *invocation) G_GNUC_NON_NULL(1, 2);
+GPtrArray *
+fu_client_steal_invocations(FuClient *self) G_GNUC_NON_NULL(1);
+void
 fu_client_remove_flag(FuClient *self, FuClientFlag flag) G_GNUC_NON_NULL(1);
 gboolean
 fu_client_has_flag(FuClient *self, FuClientFlag flag) G_GNUC_NON_NULL(1);
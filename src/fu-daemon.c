@@ -22,6 +22,7 @@
 #include "fwupd-security-attr-private.h"
 
 #include "fu-bios-settings-private.h"
+#include "fu-call-queue.h"
 #include "fu-client-list.h"
 #include "fu-context-private.h"
 #include "fu-daemon.h"
@@ -46,6 +47,17 @@
 static void
 fu_daemon_finalize(GObject *obj);
 
+static GVariant *
+fu_daemon_daemon_get_property(GDBusConnection *connection_,
+			      const gchar *sender,
+			      const gchar *object_path,
+			      const gchar *interface_name,
+			      const gchar *property_name,
+			      GError **error,
+			      gpointer user_data);
+static void
+fu_daemon_snapshot_devices(FuDaemon *self);
+
 struct _FuDaemon {
 	GObject parent_instance;
 	GDBusConnection *connection;
@@ -65,6 +77,22 @@ struct _FuDaemon {
 	gboolean pending_stop;
 	FuDaemonMachineKind machine_kind;
 	GPtrArray *system_inhibits;
+	guint64 devices_generation;
+	GHashTable *devices_variants; /* (element-type guint GVariant) keyed by FwupdCodecFlags */
+	GThread *dbus_thread;
+	GMainContext *dbus_context;
+	GMainLoop *dbus_loop;
+	GMutex snapshot_mutex;
+	guint snapshot_depth;
+	guint64 snapshot_generation;
+	GPtrArray *warm_devices;	/* (nullable) (element-type FwupdDevice) */
+	GHashTable *snapshot_devices;	/* (nullable) flags:GVariant, protected by mutex */
+	GArray *snapshot_trusted_uids;	/* (nullable) guint64, protected by snapshot_mutex */
+	GVariant *snapshot_security_attrs; /* (nullable) protected by snapshot_mutex */
+	GHashTable *snapshot_props;	/* (nullable) utf8:GVariant, protected by mutex */
+	FuCallQueue *call_queue;	/* calls forwarded from the D-Bus thread */
+	GMutex caller_uids_mutex;
+	GHashTable *caller_uids; /* sender:uid, removed when the client vanishes */
 };
 
 G_DEFINE_TYPE(FuDaemon, fu_daemon, G_TYPE_OBJECT)
@@ -140,59 +168,51 @@ fu_daemon_engine_changed_cb(FuEngine *engine, FuDaemon *self)
 }
 
 static void
-fu_daemon_engine_device_added_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+fu_daemon_emit_device_signal(FuDaemon *self, const gchar *signal_name, FwupdDevice *device)
 {
-	GVariant *val;
-
-	/* not yet connected */
-	if (self->connection == NULL)
-		return;
-	val = fwupd_codec_to_variant(FWUPD_CODEC(device), FWUPD_CODEC_FLAG_NONE);
+	GVariant *val = fwupd_codec_to_variant(FWUPD_CODEC(device), FWUPD_CODEC_FLAG_NONE);
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
 				      FWUPD_DBUS_PATH,
 				      FWUPD_DBUS_INTERFACE,
-				      "DeviceAdded",
+				      signal_name,
 				      g_variant_new_tuple(&val, 1),
 				      NULL);
+}
+
+static void
+fu_daemon_engine_device_added_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+{
+	/* not yet connected, or the snapshot is reconciled when the engine has loaded */
+	if (self->connection == NULL || self->warm_devices != NULL)
+		return;
+	if (self->snapshot_depth > 0)
+		fu_daemon_snapshot_devices(self);
+	fu_daemon_emit_device_signal(self, "DeviceAdded", FWUPD_DEVICE(device));
 	fu_daemon_schedule_housekeeping(self);
 }
 
 static void
 fu_daemon_engine_device_removed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
 {
-	GVariant *val;
-
-	/* not yet connected */
-	if (self->connection == NULL)
+	/* not yet connected, or the snapshot is reconciled when the engine has loaded */
+	if (self->connection == NULL || self->warm_devices != NULL)
 		return;
-	val = fwupd_codec_to_variant(FWUPD_CODEC(device), FWUPD_CODEC_FLAG_NONE);
-	g_dbus_connection_emit_signal(self->connection,
-				      NULL,
-				      FWUPD_DBUS_PATH,
-				      FWUPD_DBUS_INTERFACE,
-				      "DeviceRemoved",
-				      g_variant_new_tuple(&val, 1),
-				      NULL);
+	if (self->snapshot_depth > 0)
+		fu_daemon_snapshot_devices(self);
+	fu_daemon_emit_device_signal(self, "DeviceRemoved", FWUPD_DEVICE(device));
 	fu_daemon_schedule_housekeeping(self);
 }
 
 static void
 fu_daemon_engine_device_changed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
 {
-	GVariant *val;
-
-	/* not yet connected */
-	if (self->connection == NULL)
+	/* not yet connected, or the snapshot is reconciled when the engine has loaded */
+	if (self->connection == NULL || self->warm_devices != NULL)
 		return;
-	val = fwupd_codec_to_variant(FWUPD_CODEC(device), FWUPD_CODEC_FLAG_NONE);
-	g_dbus_connection_emit_signal(self->connection,
-				      NULL,
-				      FWUPD_DBUS_PATH,
-				      FWUPD_DBUS_INTERFACE,
-				      "DeviceChanged",
-				      g_variant_new_tuple(&val, 1),
-				      NULL);
+	if (self->snapshot_depth > 0)
+		fu_daemon_snapshot_devices(self);
+	fu_daemon_emit_device_signal(self, "DeviceChanged", FWUPD_DEVICE(device));
 	fu_daemon_schedule_housekeeping(self);
 }
 
@@ -228,6 +248,16 @@ fu_daemon_emit_property_changed(FuDaemon *self,
 		return;
 	}
 
+	/* keep the snapshot used by the D-Bus thread up to date */
+	g_variant_ref_sink(property_value);
+	g_mutex_lock(&self->snapshot_mutex);
+	if (self->snapshot_props != NULL) {
+		g_hash_table_insert(self->snapshot_props,
+				    g_strdup(property_name),
+				    g_variant_ref(property_value));
+	}
+	g_mutex_unlock(&self->snapshot_mutex);
+
 	/* build the dict */
 	g_variant_builder_init(&invalidated_builder, G_VARIANT_TYPE("as"));
 	g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
@@ -242,6 +272,7 @@ fu_daemon_emit_property_changed(FuDaemon *self,
 	    NULL);
 	g_variant_builder_clear(&builder);
 	g_variant_builder_clear(&invalidated_builder);
+	g_variant_unref(property_value);
 }
 
 static void
@@ -266,6 +297,41 @@ fu_daemon_engine_status_changed_cb(FuEngine *engine, FwupdStatus status, FuDaemo
 		g_main_loop_quit(self->loop);
 }
 
+/* one-shot callers are only registered to cache the UID, so do not keep the daemon alive */
+static void
+fu_daemon_client_list_ensure_inhibit(FuDaemon *self)
+{
+	guint clients_cnt = 0;
+	g_autoptr(GPtrArray) clients = fu_client_list_get_all(self->client_list);
+
+	for (guint i = 0; i < clients->len; i++) {
+		FuClient *client = g_ptr_array_index(clients, i);
+		if (fu_client_has_flag(client, FU_CLIENT_FLAG_INHIBIT_IDLE))
+			clients_cnt++;
+	}
+	g_debug("connected clients: %u of %u", clients_cnt, clients->len);
+	if (clients_cnt > 0 && self->clients_inhibit_id == 0) {
+		self->clients_inhibit_id = fu_engine_idle_inhibit(self->engine,
+								  FU_IDLE_INHIBIT_TIMEOUT,
+								  "connected-clients");
+	} else if (clients_cnt == 0 && self->clients_inhibit_id != 0) {
+		fu_engine_idle_uninhibit(self->engine, self->clients_inhibit_id);
+		self->clients_inhibit_id = 0;
+	}
+}
+
+/* clients that set hints or feature flags, or install, stay connected until they vanish */
+static FuClient *
+fu_daemon_register_client(FuDaemon *self, const gchar *sender)
+{
+	FuClient *client = fu_client_list_register(self->client_list, sender);
+	if (!fu_client_has_flag(client, FU_CLIENT_FLAG_INHIBIT_IDLE)) {
+		fu_client_add_flag(client, FU_CLIENT_FLAG_INHIBIT_IDLE);
+		fu_daemon_client_list_ensure_inhibit(self);
+	}
+	return client;
+}
+
 static FuEngineRequest *
 fu_daemon_create_request(FuDaemon *self, const gchar *sender, GError **error)
 {
@@ -273,7 +339,6 @@ fu_daemon_create_request(FuDaemon *self, const gchar *sender, GError **error)
 	guint calling_uid = 0;
 	g_autoptr(FuClient) client = NULL;
 	g_autoptr(FuEngineRequest) request = fu_engine_request_new();
-	g_autoptr(GVariant) value = NULL;
 
 	/* if using FWUPD_DBUS_SOCKET... */
 	if (sender == NULL) {
@@ -291,18 +356,15 @@ fu_daemon_create_request(FuDaemon *self, const gchar *sender, GError **error)
 	}
 
 	/* are we root and therefore trusted? */
-	value = g_dbus_proxy_call_sync(self->proxy_uid,
-				       "GetConnectionUnixUser",
-				       g_variant_new("(s)", sender),
-				       G_DBUS_CALL_FLAGS_NONE,
-				       2000,
-				       NULL,
-				       error);
-	if (value == NULL) {
-		g_prefix_error(error, "failed to read user id of caller: ");
+	if (client == NULL || !fu_client_has_flag(client, FU_CLIENT_FLAG_HAS_UID)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "failed to read user id of caller %s",
+			    sender);
 		return NULL;
 	}
-	g_variant_get(value, "(u)", &calling_uid);
+	calling_uid = fu_client_get_uid(client);
 	if (fu_engine_is_uid_trusted(self->engine, calling_uid))
 		converter_flags |= FWUPD_CODEC_FLAG_TRUSTED;
 	fu_engine_request_set_converter_flags(request, converter_flags);
@@ -323,6 +385,161 @@ fu_daemon_device_array_to_variant(FuDaemon *self,
 	return fwupd_codec_array_to_variant(devices, flags);
 }
 
+/* the same serialized device list is shared by all callers until something changes */
+static GVariant *
+fu_daemon_get_devices_variant(FuDaemon *self, FuEngineRequest *request, GError **error)
+{
+	FwupdCodecFlags flags = fu_engine_request_get_converter_flags(request);
+	guint64 generation = fu_engine_get_devices_generation(self->engine);
+	GVariant *val;
+	g_autoptr(GPtrArray) devices = NULL;
+
+	if (fu_engine_config_get_show_device_private(fu_engine_get_config(self->engine)))
+		flags |= FWUPD_CODEC_FLAG_TRUSTED;
+	if (generation != self->devices_generation) {
+		g_hash_table_remove_all(self->devices_variants);
+		self->devices_generation = generation;
+	}
+	val = g_hash_table_lookup(self->devices_variants, GUINT_TO_POINTER(flags));
+	if (val != NULL)
+		return g_variant_ref(val);
+
+	/* not cached */
+	devices = fu_engine_get_devices(self->engine, error);
+	if (devices == NULL)
+		return NULL;
+	val = g_variant_ref_sink(fwupd_codec_array_to_variant(devices, flags));
+	g_hash_table_insert(self->devices_variants, GUINT_TO_POINTER(flags), g_variant_ref(val));
+	return val;
+}
+
+/* serialize the devices once for each trust level, as the caller is only known later */
+static void
+fu_daemon_snapshot_set_devices(FuDaemon *self, GPtrArray *devices)
+{
+	FwupdCodecFlags flags_all[] = {FWUPD_CODEC_FLAG_NONE, FWUPD_CODEC_FLAG_TRUSTED};
+	FuEngineConfig *config = fu_engine_get_config(self->engine);
+	GHashTable *snapshot = g_hash_table_new_full(g_direct_hash,
+						     g_direct_equal,
+						     NULL,
+						     (GDestroyNotify)g_variant_unref);
+
+	for (guint i = 0; i < G_N_ELEMENTS(flags_all); i++) {
+		FwupdCodecFlags flags = flags_all[i];
+		GVariant *val;
+		if (fu_engine_config_get_show_device_private(config))
+			flags |= FWUPD_CODEC_FLAG_TRUSTED;
+		val = fwupd_codec_array_to_variant(devices, flags);
+		g_hash_table_insert(snapshot,
+				    GUINT_TO_POINTER(flags_all[i]),
+				    g_variant_ref_sink(val));
+	}
+	g_mutex_lock(&self->snapshot_mutex);
+	if (self->snapshot_devices != NULL)
+		g_hash_table_unref(self->snapshot_devices);
+	self->snapshot_devices = snapshot;
+	if (self->snapshot_trusted_uids != NULL)
+		g_array_unref(self->snapshot_trusted_uids);
+	self->snapshot_trusted_uids = g_array_copy(fu_engine_config_get_trusted_uids(config));
+	g_mutex_unlock(&self->snapshot_mutex);
+}
+
+static void
+fu_daemon_snapshot_clear_devices(FuDaemon *self)
+{
+	g_autoptr(GHashTable) snapshot = NULL;
+	g_autoptr(GArray) trusted_uids = NULL;
+
+	g_mutex_lock(&self->snapshot_mutex);
+	snapshot = g_steal_pointer(&self->snapshot_devices);
+	trusted_uids = g_steal_pointer(&self->snapshot_trusted_uids);
+	g_mutex_unlock(&self->snapshot_mutex);
+}
+
+/* refreshed when the devices change so the D-Bus thread can answer GetDevices while busy */
+static void
+fu_daemon_snapshot_devices(FuDaemon *self)
+{
+	guint64 generation = fu_engine_get_devices_generation(self->engine);
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* only written from the main thread, so no need to lock */
+	if (generation == self->snapshot_generation && self->snapshot_devices != NULL)
+		return;
+	devices = fu_engine_get_devices(self->engine, &error_local);
+	if (devices == NULL) {
+		g_debug("not snapshotting devices: %s", error_local->message);
+		return;
+	}
+	fu_daemon_snapshot_set_devices(self, devices);
+	self->snapshot_generation = generation;
+}
+
+/* called before the main loop is blocked by a long-running engine operation */
+static void
+fu_daemon_snapshot_begin(FuDaemon *self)
+{
+	GDBusInterfaceInfo *info;
+	g_autoptr(GHashTable) props = NULL;
+	g_autoptr(GVariant) security_attrs = NULL;
+
+	/* nested, or no D-Bus thread to use the snapshot */
+	if (self->snapshot_depth++ > 0 || self->dbus_thread == NULL)
+		return;
+
+	info = self->introspection_daemon->interfaces[0];
+	props = g_hash_table_new_full(g_str_hash,
+				      g_str_equal,
+				      g_free,
+				      (GDestroyNotify)g_variant_unref);
+	for (guint i = 0; info->properties != NULL && info->properties[i] != NULL; i++) {
+		const gchar *property_name = info->properties[i]->name;
+		GVariant *val = fu_daemon_daemon_get_property(self->connection,
+							      NULL,
+							      FWUPD_DBUS_PATH,
+							      FWUPD_DBUS_INTERFACE,
+							      property_name,
+							      NULL,
+							      self);
+		if (val == NULL)
+			continue;
+		g_hash_table_insert(props, g_strdup(property_name), g_variant_ref_sink(val));
+	}
+#ifdef HAVE_HSI
+	/* the attributes do not change during the operation, so no need to refresh */
+	if (self->machine_kind == FU_DAEMON_MACHINE_KIND_PHYSICAL ||
+	    g_getenv("UMOCKDEV_DIR") != NULL) {
+		g_autoptr(FuSecurityAttrs) attrs = fu_engine_get_host_security_attrs(self->engine);
+		security_attrs = g_variant_ref_sink(fu_security_attrs_to_variant(attrs));
+	}
+#endif
+	g_mutex_lock(&self->snapshot_mutex);
+	self->snapshot_props = g_steal_pointer(&props);
+	self->snapshot_security_attrs = g_steal_pointer(&security_attrs);
+	g_mutex_unlock(&self->snapshot_mutex);
+	fu_daemon_snapshot_devices(self);
+}
+
+static void
+fu_daemon_snapshot_end(FuDaemon *self)
+{
+	g_autoptr(GHashTable) props = NULL;
+	g_autoptr(GVariant) security_attrs = NULL;
+
+	g_return_if_fail(self->snapshot_depth > 0);
+	if (--self->snapshot_depth > 0)
+		return;
+
+	/* method calls go to the main loop again, unless still warm starting */
+	g_mutex_lock(&self->snapshot_mutex);
+	props = g_steal_pointer(&self->snapshot_props);
+	security_attrs = g_steal_pointer(&self->snapshot_security_attrs);
+	g_mutex_unlock(&self->snapshot_mutex);
+	if (self->warm_devices == NULL)
+		fu_daemon_snapshot_clear_devices(self);
+}
+
 typedef struct {
 	GDBusMethodInvocation *invocation;
 	FuEngineRequest *request;
@@ -638,6 +855,7 @@ static void
 fu_daemon_authorize_activate_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
 	g_autoptr(FuMainAuthHelper) helper = (FuMainAuthHelper *)user_data;
+	gboolean ret;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
 
@@ -659,7 +877,10 @@ fu_daemon_authorize_activate_cb(GObject *source, GAsyncResult *res, gpointer use
 			 helper->self);
 
 	/* authenticated */
-	if (!fu_engine_activate(helper->self->engine, helper->device_id, progress, &error)) {
+	fu_daemon_snapshot_begin(helper->self);
+	ret = fu_engine_activate(helper->self->engine, helper->device_id, progress, &error);
+	fu_daemon_snapshot_end(helper->self);
+	if (!ret) {
 		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
 		return;
 	}
@@ -672,6 +893,7 @@ static void
 fu_daemon_authorize_verify_update_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
 	g_autoptr(FuMainAuthHelper) helper = (FuMainAuthHelper *)user_data;
+	gboolean ret;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
 
@@ -693,7 +915,10 @@ fu_daemon_authorize_verify_update_cb(GObject *source, GAsyncResult *res, gpointe
 			 helper->self);
 
 	/* authenticated */
-	if (!fu_engine_verify_update(helper->self->engine, helper->device_id, progress, &error)) {
+	fu_daemon_snapshot_begin(helper->self);
+	ret = fu_engine_verify_update(helper->self->engine, helper->device_id, progress, &error);
+	fu_daemon_snapshot_end(helper->self);
+	if (!ret) {
 		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
 		return;
 	}
@@ -788,6 +1013,7 @@ fu_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 
 	/* all authenticated, so install all the things */
 	self->update_in_progress = TRUE;
+	fu_daemon_snapshot_begin(self);
 	ret = fu_engine_install_releases(helper->self->engine,
 					 helper->request,
 					 helper->releases,
@@ -795,6 +1021,7 @@ fu_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 					 helper->progress,
 					 helper->flags,
 					 &error);
+	fu_daemon_snapshot_end(self);
 	self->update_in_progress = FALSE;
 	if (self->pending_stop)
 		g_main_loop_quit(self->loop);
@@ -1100,18 +1327,14 @@ fu_daemon_client_flags_notify_cb(FuClient *client, GParamSpec *pspec, FuMainAuth
 #endif
 
 static void
-fu_daemon_daemon_method_call(GDBusConnection *connection,
-			     const gchar *sender,
-			     const gchar *object_path,
-			     const gchar *interface_name,
-			     const gchar *method_name,
-			     GVariant *parameters,
-			     GDBusMethodInvocation *invocation,
-			     gpointer user_data)
+fu_daemon_daemon_method_call_process(FuDaemon *self,
+				     const gchar *sender,
+				     const gchar *method_name,
+				     GVariant *parameters,
+				     GDBusMethodInvocation *invocation)
 {
 	FuPolkitAuthorityCheckFlags auth_flags =
 	    FU_POLKIT_AUTHORITY_CHECK_FLAG_ALLOW_USER_INTERACTION;
-	FuDaemon *self = FU_DAEMON(user_data);
 	GVariant *val = NULL;
 	g_autoptr(FuEngineRequest) request = NULL;
 	g_autoptr(GError) error = NULL;
@@ -1129,18 +1352,39 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 	fu_engine_idle_reset(self->engine);
 
 	if (g_strcmp0(method_name, "GetDevices") == 0) {
-		g_autoptr(GPtrArray) devices = NULL;
+		g_autoptr(GVariant) devices_val = NULL;
 		g_debug("Called %s()", method_name);
-		devices = fu_engine_get_devices(self->engine, &error);
-		if (devices == NULL) {
+		devices_val = fu_daemon_get_devices_variant(self, request, &error);
+		if (devices_val == NULL) {
 			fu_daemon_method_invocation_return_gerror(invocation, error);
 			return;
 		}
-		val = fu_daemon_device_array_to_variant(self, request, devices, &error);
-		if (val == NULL) {
+		g_dbus_method_invocation_return_value(invocation, devices_val);
+		return;
+	}
+	if (g_strcmp0(method_name, "GetDevicesIfChanged") == 0) {
+		guint64 generation_client = 0;
+		guint64 generation = fu_engine_get_devices_generation(self->engine);
+		g_autoptr(GVariant) devices_val = NULL;
+		g_autoptr(GVariant) devices_array = NULL;
+
+		g_variant_get(parameters, "(t)", &generation_client);
+		g_debug("Called %s(%" G_GUINT64_FORMAT ")", method_name, generation_client);
+
+		/* nothing changed since the client last asked */
+		if (generation_client == generation) {
+			g_dbus_method_invocation_return_value(
+			    invocation,
+			    g_variant_new("(aa{sv}t)", NULL, generation));
+			return;
+		}
+		devices_val = fu_daemon_get_devices_variant(self, request, &error);
+		if (devices_val == NULL) {
 			fu_daemon_method_invocation_return_gerror(invocation, error);
 			return;
 		}
+		devices_array = g_variant_get_child_value(devices_val, 0);
+		val = g_variant_new("(@aa{sv}t)", devices_array, generation);
 		g_dbus_method_invocation_return_value(invocation, val);
 		return;
 	}
@@ -1151,6 +1395,12 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_dbus_method_invocation_return_value(invocation, val);
 		return;
 	}
+	if (g_strcmp0(method_name, "GetTimings") == 0) {
+		g_debug("Called %s()", method_name);
+		val = fu_engine_get_runner_stats(self->engine);
+		g_dbus_method_invocation_return_value(invocation, val);
+		return;
+	}
 	if (g_strcmp0(method_name, "GetReleases") == 0) {
 		const gchar *device_id;
 		g_autoptr(GPtrArray) releases = NULL;
@@ -1519,6 +1769,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		GDBusMessage *message;
 		GUnixFDList *fd_list;
 		const gchar *remote_id = NULL;
+		gboolean ret;
 		gint fd_data;
 		gint fd_sig;
 
@@ -1545,7 +1796,10 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		}
 
 		/* store new metadata (will close the fds when done) */
-		if (!fu_engine_update_metadata(self->engine, remote_id, fd_data, fd_sig, &error)) {
+		fu_daemon_snapshot_begin(self);
+		ret = fu_engine_update_metadata(self->engine, remote_id, fd_data, fd_sig, &error);
+		fu_daemon_snapshot_end(self);
+		if (!ret) {
 			g_prefix_error(&error, "Failed to update metadata for %s: ", remote_id);
 			fu_daemon_method_invocation_return_gerror(invocation, error);
 			return;
@@ -1721,6 +1975,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 	}
 	if (g_strcmp0(method_name, "Verify") == 0) {
 		const gchar *device_id = NULL;
+		gboolean ret;
 		g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
 
 		g_variant_get(parameters, "(&s)", &device_id);
@@ -1741,7 +1996,10 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 				 G_CALLBACK(fu_daemon_progress_status_changed_cb),
 				 self);
 
-		if (!fu_engine_verify(self->engine, device_id, progress, &error)) {
+		fu_daemon_snapshot_begin(self);
+		ret = fu_engine_verify(self->engine, device_id, progress, &error);
+		fu_daemon_snapshot_end(self);
+		if (!ret) {
 			fu_daemon_method_invocation_return_gerror(invocation, error);
 			return;
 		}
@@ -1756,7 +2014,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_debug("Called %s(%" G_GUINT64_FORMAT ")", method_name, feature_flags_u64);
 
 		/* old flags for the same sender will be automatically destroyed */
-		client = fu_client_list_register(self->client_list, sender);
+		client = fu_daemon_register_client(self, sender);
 		fu_client_set_feature_flags(client, feature_flags_u64);
 		g_dbus_method_invocation_return_value(invocation, NULL);
 		return;
@@ -1769,7 +2027,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 
 		g_variant_get(parameters, "(a{ss})", &iter);
 		g_debug("Called %s()", method_name);
-		client = fu_client_list_register(self->client_list, sender);
+		client = fu_daemon_register_client(self, sender);
 		while (g_variant_iter_next(iter, "{&s&s}", &prop_key, &prop_value)) {
 			g_debug("got hint %s=%s", prop_key, prop_value);
 			fu_client_insert_hint(client, prop_key, prop_value);
@@ -1904,14 +2162,14 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 			fu_daemon_method_invocation_return_gerror(invocation, error);
 			return;
 		}
-		helper->stream = fu_unix_seekable_input_stream_new(fd, TRUE);
+		helper->stream = fu_unix_seekable_input_stream_new_sealed(fd);
 
 		/* relax these */
 		if (fu_engine_config_get_ignore_requirements(fu_engine_get_config(self->engine)))
 			helper->flags |= FWUPD_INSTALL_FLAG_IGNORE_REQUIREMENTS;
 
 		/* install all the things in the store */
-		helper->client = fu_client_list_register(self->client_list, sender);
+		helper->client = fu_daemon_register_client(self, sender);
 		helper->client_sender_changed_id =
 		    g_signal_connect(FU_CLIENT(helper->client),
 				     "notify::flags",
@@ -1957,7 +2215,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		}
 
 		/* get details about the file (will close the fd when done) */
-		stream = fu_unix_seekable_input_stream_new(fd, TRUE);
+		stream = fu_unix_seekable_input_stream_new_sealed(fd);
 		if (stream == NULL) {
 			fu_daemon_method_invocation_return_gerror(invocation, error);
 			return;
@@ -2092,6 +2350,144 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 					      method_name);
 }
 
+typedef struct {
+	FuDaemon *self;	  /* no-ref */
+	FuClient *client; /* ref */
+} FuDaemonCredentialsHelper;
+
+static void
+fu_daemon_credentials_helper_free(FuDaemonCredentialsHelper *helper)
+{
+	g_object_unref(helper->client);
+	g_free(helper);
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-function"
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuDaemonCredentialsHelper, fu_daemon_credentials_helper_free)
+#pragma clang diagnostic pop
+
+/* the UIDs are shared with the D-Bus thread so it does not have to ask the bus each time */
+static gboolean
+fu_daemon_caller_uid_lookup(FuDaemon *self, const gchar *sender, guint *uid)
+{
+	gpointer value = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->caller_uids_mutex);
+	if (!g_hash_table_lookup_extended(self->caller_uids, sender, NULL, &value))
+		return FALSE;
+	*uid = GPOINTER_TO_UINT(value);
+	return TRUE;
+}
+
+static void
+fu_daemon_caller_uid_insert(FuDaemon *self, const gchar *sender, guint uid)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->caller_uids_mutex);
+	g_hash_table_insert(self->caller_uids, g_strdup(sender), GUINT_TO_POINTER(uid));
+}
+
+static void
+fu_daemon_caller_uid_remove(FuDaemon *self, const gchar *sender)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->caller_uids_mutex);
+	g_hash_table_remove(self->caller_uids, sender);
+}
+
+static void
+fu_daemon_get_connection_unix_user_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(FuDaemonCredentialsHelper) helper = (FuDaemonCredentialsHelper *)user_data;
+	guint calling_uid = 0;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) invocations = fu_client_steal_invocations(helper->client);
+	g_autoptr(GVariant) value = NULL;
+
+	value = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res, &error);
+	if (value == NULL) {
+		g_prefix_error(&error, "failed to read user id of caller: ");
+		for (guint i = 0; i < invocations->len; i++) {
+			GDBusMethodInvocation *invocation = g_ptr_array_index(invocations, i);
+			fu_daemon_method_invocation_return_gerror(g_object_ref(invocation),
+								  error);
+		}
+		return;
+	}
+
+	/* the unique name is never reused, so this is valid until the client vanishes */
+	g_variant_get(value, "(u)", &calling_uid);
+	fu_client_set_uid(helper->client, calling_uid);
+	fu_daemon_caller_uid_insert(helper->self, fu_client_get_sender(helper->client), calling_uid);
+
+	/* run everything that arrived while we were waiting */
+	for (guint i = 0; i < invocations->len; i++) {
+		GDBusMethodInvocation *invocation = g_ptr_array_index(invocations, i);
+		fu_daemon_daemon_method_call_process(
+		    helper->self,
+		    g_dbus_method_invocation_get_sender(invocation),
+		    g_dbus_method_invocation_get_method_name(invocation),
+		    g_dbus_method_invocation_get_parameters(invocation),
+		    g_object_ref(invocation));
+	}
+}
+
+static void
+fu_daemon_daemon_method_call(GDBusConnection *connection,
+			     const gchar *sender,
+			     const gchar *object_path,
+			     const gchar *interface_name,
+			     const gchar *method_name,
+			     GVariant *parameters,
+			     GDBusMethodInvocation *invocation,
+			     gpointer user_data)
+{
+	FuDaemon *self = FU_DAEMON(user_data);
+	gboolean is_first;
+	guint calling_uid = 0;
+	g_autoptr(FuClient) client = NULL;
+	g_autoptr(FuDaemonCredentialsHelper) helper = NULL;
+
+	/* if using FWUPD_DBUS_SOCKET... */
+	if (sender == NULL) {
+		fu_daemon_daemon_method_call_process(self,
+						     sender,
+						     method_name,
+						     parameters,
+						     invocation);
+		return;
+	}
+
+	/* we already know who this is, perhaps from the D-Bus thread */
+	client = fu_client_list_register(self->client_list, sender);
+	if (!fu_client_has_flag(client, FU_CLIENT_FLAG_HAS_UID) &&
+	    fu_daemon_caller_uid_lookup(self, sender, &calling_uid))
+		fu_client_set_uid(client, calling_uid);
+	if (fu_client_has_flag(client, FU_CLIENT_FLAG_HAS_UID)) {
+		fu_daemon_daemon_method_call_process(self,
+						     sender,
+						     method_name,
+						     parameters,
+						     invocation);
+		return;
+	}
+
+	/* wait for the credentials without blocking the main loop, and only ask once */
+	is_first = fu_client_add_invocation(client, invocation);
+	g_object_unref(invocation);
+	if (!is_first)
+		return;
+	helper = g_new0(FuDaemonCredentialsHelper, 1);
+	helper->self = self;
+	helper->client = g_object_ref(client);
+	g_dbus_proxy_call(self->proxy_uid,
+			  "GetConnectionUnixUser",
+			  g_variant_new("(s)", sender),
+			  G_DBUS_CALL_FLAGS_NONE,
+			  2000,
+			  NULL,
+			  fu_daemon_get_connection_unix_user_cb,
+			  g_steal_pointer(&helper));
+}
+
 static GVariant *
 fu_daemon_daemon_get_property(GDBusConnection *connection_,
 			      const gchar *sender,
@@ -2199,21 +2595,6 @@ fu_daemon_register_object(FuDaemon *self)
 	g_assert(registration_id > 0);
 }
 
-static void
-fu_daemon_client_list_ensure_inhibit(FuDaemon *self)
-{
-	g_autoptr(GPtrArray) clients = fu_client_list_get_all(self->client_list);
-	g_debug("connected clients: %u", clients->len);
-	if (clients->len > 0 && self->clients_inhibit_id == 0) {
-		self->clients_inhibit_id = fu_engine_idle_inhibit(self->engine,
-								  FU_IDLE_INHIBIT_TIMEOUT,
-								  "connected-clients");
-	} else if (clients->len == 0 && self->clients_inhibit_id != 0) {
-		fu_engine_idle_uninhibit(self->engine, self->clients_inhibit_id);
-		self->clients_inhibit_id = 0;
-	}
-}
-
 static void
 fu_daemon_client_list_added_cb(FuClientList *client_list, FuClient *client, gpointer user_data)
 {
@@ -2225,6 +2606,7 @@ static void
 fu_daemon_client_list_removed_cb(FuClientList *client_list, FuClient *client, gpointer user_data)
 {
 	FuDaemon *self = FU_DAEMON(user_data);
+	fu_daemon_caller_uid_remove(self, fu_client_get_sender(client));
 	fu_daemon_client_list_ensure_inhibit(self);
 }
 
@@ -2246,31 +2628,6 @@ fu_daemon_set_connection(FuDaemon *self, GDBusConnection *connection)
 	}
 }
 
-static void
-fu_daemon_dbus_bus_acquired_cb(GDBusConnection *connection, const gchar *name, gpointer user_data)
-{
-	FuDaemon *self = FU_DAEMON(user_data);
-	g_autoptr(GError) error = NULL;
-
-	fu_daemon_set_connection(self, connection);
-	fu_daemon_register_object(self);
-
-	/* connect to D-Bus directly */
-	self->proxy_uid = g_dbus_proxy_new_sync(self->connection,
-						G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES |
-						    G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
-						NULL,
-						"org.freedesktop.DBus",
-						"/org/freedesktop/DBus",
-						"org.freedesktop.DBus",
-						NULL,
-						&error);
-	if (self->proxy_uid == NULL) {
-		g_warning("cannot connect to DBus: %s", error->message);
-		return;
-	}
-}
-
 static void
 fu_daemon_dbus_name_acquired_cb(GDBusConnection *connection, const gchar *name, gpointer user_data)
 {
@@ -2314,6 +2671,456 @@ fu_daemon_dbus_new_connection_cb(GDBusServer *server,
 	return TRUE;
 }
 
+typedef struct {
+	FuDaemon *self;
+	GDBusMethodInvocation *invocation;
+} FuDaemonDispatchHelper;
+
+static void
+fu_daemon_dispatch_helper_free(FuDaemonDispatchHelper *helper)
+{
+	if (helper->invocation != NULL)
+		g_object_unref(helper->invocation);
+	g_free(helper);
+}
+
+/* the object registered in the D-Bus thread handles the properties itself, in the main thread */
+static void
+fu_daemon_dispatch_properties_call(FuDaemon *self, GDBusMethodInvocation *invocation)
+{
+	GDBusInterfaceInfo *info = self->introspection_daemon->interfaces[0];
+	GDBusConnection *connection = g_dbus_method_invocation_get_connection(invocation);
+	GVariant *parameters = g_dbus_method_invocation_get_parameters(invocation);
+	const gchar *method_name = g_dbus_method_invocation_get_method_name(invocation);
+	const gchar *sender = g_dbus_method_invocation_get_sender(invocation);
+
+	if (g_strcmp0(method_name, "Get") == 0) {
+		const gchar *property_name = NULL;
+		GVariant *val;
+		g_autoptr(GError) error = NULL;
+
+		g_variant_get(parameters, "(&s&s)", NULL, &property_name);
+		val = fu_daemon_daemon_get_property(connection,
+						    sender,
+						    FWUPD_DBUS_PATH,
+						    FWUPD_DBUS_INTERFACE,
+						    property_name,
+						    &error,
+						    self);
+		if (val == NULL) {
+			g_dbus_method_invocation_return_gerror(invocation, error);
+			return;
+		}
+		g_dbus_method_invocation_return_value(invocation, g_variant_new("(v)", val));
+		return;
+	}
+	if (g_strcmp0(method_name, "GetAll") == 0) {
+		GVariantBuilder builder;
+
+		g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+		for (guint i = 0; info->properties != NULL && info->properties[i] != NULL; i++) {
+			const gchar *property_name = info->properties[i]->name;
+			GVariant *val = fu_daemon_daemon_get_property(connection,
+								      sender,
+								      FWUPD_DBUS_PATH,
+								      FWUPD_DBUS_INTERFACE,
+								      property_name,
+								      NULL,
+								      self);
+			if (val == NULL)
+				continue;
+			g_variant_builder_add(&builder, "{sv}", property_name, val);
+		}
+		g_dbus_method_invocation_return_value(invocation,
+						      g_variant_new("(a{sv})", &builder));
+		return;
+	}
+	g_dbus_method_invocation_return_error(invocation,
+					      G_DBUS_ERROR,
+					      G_DBUS_ERROR_PROPERTY_READ_ONLY,
+					      "daemon properties are read-only");
+}
+
+static gboolean
+fu_daemon_dispatch_cb(gpointer user_data)
+{
+	FuDaemonDispatchHelper *helper = (FuDaemonDispatchHelper *)user_data;
+	GDBusMethodInvocation *invocation = g_steal_pointer(&helper->invocation);
+
+	if (g_strcmp0(g_dbus_method_invocation_get_interface_name(invocation),
+		      "org.freedesktop.DBus.Properties") == 0) {
+		fu_daemon_dispatch_properties_call(helper->self, invocation);
+		return G_SOURCE_REMOVE;
+	}
+	fu_daemon_daemon_method_call(g_dbus_method_invocation_get_connection(invocation),
+				     g_dbus_method_invocation_get_sender(invocation),
+				     g_dbus_method_invocation_get_object_path(invocation),
+				     g_dbus_method_invocation_get_interface_name(invocation),
+				     g_dbus_method_invocation_get_method_name(invocation),
+				     g_dbus_method_invocation_get_parameters(invocation),
+				     invocation,
+				     helper->self);
+	return G_SOURCE_REMOVE;
+}
+
+/* runs in the D-Bus thread, so must not use the engine */
+static gboolean
+fu_daemon_snapshot_properties_call(FuDaemon *self,
+				   const gchar *method_name,
+				   GVariant *parameters,
+				   GDBusMethodInvocation *invocation)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->snapshot_mutex);
+
+	if (self->snapshot_props == NULL)
+		return FALSE;
+	if (g_strcmp0(method_name, "Get") == 0) {
+		const gchar *property_name = NULL;
+		GVariant *val;
+
+		g_variant_get(parameters, "(&s&s)", NULL, &property_name);
+		val = g_hash_table_lookup(self->snapshot_props, property_name);
+		if (val == NULL) {
+			g_dbus_method_invocation_return_error(invocation,
+							      G_DBUS_ERROR,
+							      G_DBUS_ERROR_UNKNOWN_PROPERTY,
+							      "failed to get daemon property %s",
+							      property_name);
+			return TRUE;
+		}
+		g_dbus_method_invocation_return_value(invocation, g_variant_new("(v)", val));
+		return TRUE;
+	}
+	if (g_strcmp0(method_name, "GetAll") == 0) {
+		GHashTableIter iter;
+		GVariantBuilder builder;
+		gpointer key;
+		gpointer value;
+
+		g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+		g_hash_table_iter_init(&iter, self->snapshot_props);
+		while (g_hash_table_iter_next(&iter, &key, &value))
+			g_variant_builder_add(&builder, "{sv}", key, value);
+		g_dbus_method_invocation_return_value(invocation,
+						      g_variant_new("(a{sv})", &builder));
+		return TRUE;
+	}
+	return FALSE;
+}
+
+typedef struct {
+	FuDaemon *self;
+	gchar *sender;
+} FuDaemonRegisterHelper;
+
+static void
+fu_daemon_register_helper_free(FuDaemonRegisterHelper *helper)
+{
+	g_free(helper->sender);
+	g_free(helper);
+}
+
+/* runs in the main thread, so the UID is removed from the cache when the caller vanishes */
+static gboolean
+fu_daemon_register_caller_cb(gpointer user_data)
+{
+	FuDaemonRegisterHelper *helper = (FuDaemonRegisterHelper *)user_data;
+	g_autoptr(FuClient) client = NULL;
+
+	if (helper->self->client_list != NULL)
+		client = fu_client_list_register(helper->self->client_list, helper->sender);
+	return G_SOURCE_REMOVE;
+}
+
+/* the same trust check as fu_daemon_create_request(), but without using the client list */
+static gboolean
+fu_daemon_dbus_thread_get_converter_flags(FuDaemon *self,
+					  const gchar *sender,
+					  GArray *trusted_uids,
+					  FwupdCodecFlags *flags,
+					  GError **error)
+{
+	guint calling_uid = 0;
+	FuDaemonRegisterHelper *helper;
+	g_autoptr(GVariant) val = NULL;
+
+	/* if using FWUPD_DBUS_SOCKET... */
+	if (sender == NULL) {
+		*flags = FWUPD_CODEC_FLAG_TRUSTED;
+		return TRUE;
+	}
+
+	/* the main thread or an earlier call already asked the bus */
+	if (fu_daemon_caller_uid_lookup(self, sender, &calling_uid))
+		goto out;
+
+	/* this thread is not blocked by the engine, so a sync call is fine */
+	val = g_dbus_connection_call_sync(self->connection,
+					  "org.freedesktop.DBus",
+					  "/org/freedesktop/DBus",
+					  "org.freedesktop.DBus",
+					  "GetConnectionUnixUser",
+					  g_variant_new("(s)", sender),
+					  G_VARIANT_TYPE("(u)"),
+					  G_DBUS_CALL_FLAGS_NONE,
+					  -1,
+					  NULL,
+					  error);
+	if (val == NULL)
+		return FALSE;
+	g_variant_get(val, "(u)", &calling_uid);
+	fu_daemon_caller_uid_insert(self, sender, calling_uid);
+
+	/* watch the caller from the main thread so that the cached UID gets removed */
+	helper = g_new0(FuDaemonRegisterHelper, 1);
+	helper->self = self;
+	helper->sender = g_strdup(sender);
+	g_main_context_invoke_full(NULL,
+				   G_PRIORITY_DEFAULT,
+				   fu_daemon_register_caller_cb,
+				   helper,
+				   (GDestroyNotify)fu_daemon_register_helper_free);
+
+out:
+	/* are we root and therefore trusted? */
+	*flags = FWUPD_CODEC_FLAG_NONE;
+	if (calling_uid == 0) {
+		*flags = FWUPD_CODEC_FLAG_TRUSTED;
+		return TRUE;
+	}
+	for (guint i = 0; i < trusted_uids->len; i++) {
+		if (calling_uid == g_array_index(trusted_uids, guint64, i)) {
+			*flags = FWUPD_CODEC_FLAG_TRUSTED;
+			break;
+		}
+	}
+	return TRUE;
+}
+
+/* runs in the D-Bus thread, so must not use the engine */
+static void
+fu_daemon_dbus_thread_method_call(GDBusConnection *connection,
+				  const gchar *sender,
+				  const gchar *object_path,
+				  const gchar *interface_name,
+				  const gchar *method_name,
+				  GVariant *parameters,
+				  GDBusMethodInvocation *invocation,
+				  gpointer user_data)
+{
+	FuDaemon *self = FU_DAEMON(user_data);
+	FuDaemonDispatchHelper *helper;
+
+	/* the engine is still loading or busy, so use the devices from the snapshot */
+	if (g_strcmp0(interface_name, FWUPD_DBUS_INTERFACE) == 0 &&
+	    g_strcmp0(method_name, "GetDevices") == 0) {
+		FwupdCodecFlags flags = FWUPD_CODEC_FLAG_NONE;
+		g_autoptr(GHashTable) snapshot = NULL;
+		g_autoptr(GArray) trusted_uids = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		g_mutex_lock(&self->snapshot_mutex);
+		if (self->snapshot_devices != NULL) {
+			snapshot = g_hash_table_ref(self->snapshot_devices);
+			trusted_uids = g_array_ref(self->snapshot_trusted_uids);
+		}
+		g_mutex_unlock(&self->snapshot_mutex);
+		if (snapshot != NULL) {
+			if (fu_daemon_dbus_thread_get_converter_flags(self,
+								      sender,
+								      trusted_uids,
+								      &flags,
+								      &error_local)) {
+				GVariant *val =
+				    g_hash_table_lookup(snapshot, GUINT_TO_POINTER(flags));
+				g_debug("Called %s() when busy, using snapshot", method_name);
+				g_dbus_method_invocation_return_value(invocation, val);
+				return;
+			}
+			g_debug("not using snapshot: %s", error_local->message);
+		}
+	}
+
+	/* the host security attributes cannot change while busy */
+	if (g_strcmp0(interface_name, FWUPD_DBUS_INTERFACE) == 0 &&
+	    g_strcmp0(method_name, "GetHostSecurityAttrs") == 0) {
+		g_autoptr(GVariant) val = NULL;
+
+		g_mutex_lock(&self->snapshot_mutex);
+		if (self->snapshot_security_attrs != NULL)
+			val = g_variant_ref(self->snapshot_security_attrs);
+		g_mutex_unlock(&self->snapshot_mutex);
+		if (val != NULL) {
+			g_debug("Called %s() when busy, using snapshot", method_name);
+			g_dbus_method_invocation_return_value(invocation, val);
+			return;
+		}
+	}
+
+	/* the main thread is busy, so use the properties from when it started */
+	if (g_strcmp0(interface_name, "org.freedesktop.DBus.Properties") == 0) {
+		if (fu_daemon_snapshot_properties_call(self, method_name, parameters, invocation))
+			return;
+	}
+
+	/* everything else is processed by the main loop, but only once the engine has loaded --
+	 * the nested main loops used when loading must not run the call early */
+	helper = g_new0(FuDaemonDispatchHelper, 1);
+	helper->self = self;
+	helper->invocation = invocation;
+	fu_call_queue_push(self->call_queue,
+			   fu_daemon_dispatch_cb,
+			   helper,
+			   (GDestroyNotify)fu_daemon_dispatch_helper_free);
+}
+
+static gpointer
+fu_daemon_dbus_thread_cb(gpointer user_data)
+{
+	FuDaemon *self = FU_DAEMON(user_data);
+	g_main_context_push_thread_default(self->dbus_context);
+	g_main_loop_run(self->dbus_loop);
+	g_main_context_pop_thread_default(self->dbus_context);
+	return NULL;
+}
+
+static gboolean
+fu_daemon_dbus_thread_quit_cb(gpointer user_data)
+{
+	FuDaemon *self = FU_DAEMON(user_data);
+	g_main_loop_quit(self->dbus_loop);
+	return G_SOURCE_REMOVE;
+}
+
+/* method calls are dispatched in the context the object was registered from, and that keeps
+ * running while the main thread is blocked by the engine coldplug or a firmware update */
+static gboolean
+fu_daemon_dbus_thread_start(FuDaemon *self, GError **error)
+{
+	guint registration_id;
+	static const GDBusInterfaceVTable interface_vtable = {fu_daemon_dbus_thread_method_call,
+							      NULL,
+							      NULL};
+	g_autoptr(GDBusConnection) connection = NULL;
+
+	connection = g_bus_get_sync(G_BUS_TYPE_SYSTEM, NULL, error);
+	if (connection == NULL)
+		return FALSE;
+	fu_daemon_set_connection(self, connection);
+	self->proxy_uid = g_dbus_proxy_new_sync(self->connection,
+						G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES |
+						    G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
+						NULL,
+						"org.freedesktop.DBus",
+						"/org/freedesktop/DBus",
+						"org.freedesktop.DBus",
+						NULL,
+						error);
+	if (self->proxy_uid == NULL)
+		return FALSE;
+
+	self->dbus_context = g_main_context_new();
+	self->dbus_loop = g_main_loop_new(self->dbus_context, FALSE);
+	g_main_context_push_thread_default(self->dbus_context);
+	registration_id =
+	    g_dbus_connection_register_object(self->connection,
+					      FWUPD_DBUS_PATH,
+					      self->introspection_daemon->interfaces[0],
+					      &interface_vtable,
+					      self, /* user_data */
+					      NULL, /* user_data_free_func */
+					      error);
+	g_main_context_pop_thread_default(self->dbus_context);
+	if (registration_id == 0)
+		return FALSE;
+	self->dbus_thread = g_thread_new("fu-daemon-dbus", fu_daemon_dbus_thread_cb, self);
+
+	/* the name is owned even if the callbacks are not run until the engine is loaded */
+	self->owner_id = g_bus_own_name_on_connection(self->connection,
+						      FWUPD_DBUS_SERVICE,
+						      G_BUS_NAME_OWNER_FLAGS_ALLOW_REPLACEMENT |
+							  G_BUS_NAME_OWNER_FLAGS_REPLACE,
+						      fu_daemon_dbus_name_acquired_cb,
+						      fu_daemon_dbus_name_lost_cb,
+						      self,
+						      NULL);
+
+	/* success */
+	return TRUE;
+}
+
+/* own the name before the engine is loaded so that GetDevices can use the saved devices */
+static gboolean
+fu_daemon_warm_start(FuDaemon *self, GError **error)
+{
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+
+	/* not an error, as this is only an optimization */
+	devices = fu_engine_load_devices_file(&error_local);
+	if (devices == NULL) {
+		g_info("not warm starting: %s", error_local->message);
+		return TRUE;
+	}
+	g_info("warm starting with %u devices", devices->len);
+	if (devices->len > 0)
+		fu_daemon_snapshot_set_devices(self, devices);
+	self->warm_devices = g_steal_pointer(&devices);
+	return fu_daemon_dbus_thread_start(self, error);
+}
+
+/* clients only have what was in the snapshot, so any difference at all is a change */
+static gboolean
+fu_daemon_warm_device_changed(FwupdDevice *device_old, FwupdDevice *device)
+{
+	FwupdCodecFlags flags = FWUPD_CODEC_FLAG_TRUSTED;
+	g_autoptr(GVariant) val_old =
+	    g_variant_ref_sink(fwupd_codec_to_variant(FWUPD_CODEC(device_old), flags));
+	g_autoptr(GVariant) val =
+	    g_variant_ref_sink(fwupd_codec_to_variant(FWUPD_CODEC(device), flags));
+	return !g_variant_equal(val_old, val);
+}
+
+/* the engine has now loaded, so tell clients what is different to the snapshot */
+static void
+fu_daemon_warm_start_finish(FuDaemon *self)
+{
+	GHashTableIter iter;
+	gpointer value;
+	g_autoptr(GPtrArray) devices_old = g_steal_pointer(&self->warm_devices);
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GHashTable) devices_old_by_id = g_hash_table_new(g_str_hash, g_str_equal);
+
+	/* GetDevices now goes to the main loop like every other method */
+	fu_daemon_snapshot_clear_devices(self);
+
+	for (guint i = 0; i < devices_old->len; i++) {
+		FwupdDevice *device_old = g_ptr_array_index(devices_old, i);
+		if (fwupd_device_get_id(device_old) == NULL)
+			continue;
+		g_hash_table_insert(devices_old_by_id,
+				    (gpointer)fwupd_device_get_id(device_old),
+				    device_old);
+	}
+	devices = fu_engine_get_devices(self->engine, NULL);
+	for (guint i = 0; devices != NULL && i < devices->len; i++) {
+		FwupdDevice *device = g_ptr_array_index(devices, i);
+		FwupdDevice *device_old =
+		    g_hash_table_lookup(devices_old_by_id, fwupd_device_get_id(device));
+		if (device_old == NULL) {
+			fu_daemon_emit_device_signal(self, "DeviceAdded", device);
+			continue;
+		}
+		if (fu_daemon_warm_device_changed(device_old, device))
+			fu_daemon_emit_device_signal(self, "DeviceChanged", device);
+		g_hash_table_remove(devices_old_by_id, fwupd_device_get_id(device));
+	}
+	g_hash_table_iter_init(&iter, devices_old_by_id);
+	while (g_hash_table_iter_next(&iter, NULL, &value))
+		fu_daemon_emit_device_signal(self, "DeviceRemoved", FWUPD_DEVICE(value));
+	fu_daemon_engine_changed_cb(self->engine, self);
+}
+
 static GDBusNodeInfo *
 fu_daemon_load_introspection(const gchar *filename, GError **error)
 {
@@ -2374,8 +3181,9 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
-	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 99, "load-engine");
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 1, "load-introspection");
+	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 1, "warm-start");
+	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 98, "load-engine");
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 1, "load-authority");
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 1, "own-name");
 
@@ -2396,6 +3204,15 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 		}
 	}
 
+	/* load introspection from file */
+	self->introspection_daemon =
+	    fu_daemon_load_introspection(FWUPD_DBUS_INTERFACE ".xml", error);
+	if (self->introspection_daemon == NULL) {
+		g_prefix_error(error, "failed to load introspection: ");
+		return FALSE;
+	}
+	fu_progress_step_done(progress);
+
 	/* load engine */
 	self->engine = fu_engine_new(ctx);
 	g_signal_connect(FU_ENGINE(self->engine),
@@ -2422,6 +3239,19 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 			 "status-changed",
 			 G_CALLBACK(fu_daemon_engine_status_changed_cb),
 			 self);
+
+	/* optionally answer clients while the devices are being enumerated */
+	if (!fu_engine_load_config(self->engine, error))
+		return FALSE;
+	if (socket_address == NULL &&
+	    fu_engine_config_get_warm_start(fu_engine_get_config(self->engine))) {
+		if (!fu_daemon_warm_start(self, error)) {
+			g_prefix_error(error, "failed to warm start: ");
+			return FALSE;
+		}
+	}
+	fu_progress_step_done(progress);
+
 	if (!fu_engine_load(self->engine,
 			    FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_HWINFO |
 				FU_ENGINE_LOAD_FLAG_REMOTES | FU_ENGINE_LOAD_FLAG_BUILTIN_PLUGINS,
@@ -2430,15 +3260,8 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 		g_prefix_error(error, "failed to load engine: ");
 		return FALSE;
 	}
-	fu_progress_step_done(progress);
-
-	/* load introspection from file */
-	self->introspection_daemon =
-	    fu_daemon_load_introspection(FWUPD_DBUS_INTERFACE ".xml", error);
-	if (self->introspection_daemon == NULL) {
-		g_prefix_error(error, "failed to load introspection: ");
-		return FALSE;
-	}
+	if (self->warm_devices != NULL)
+		fu_daemon_warm_start_finish(self);
 	fu_progress_step_done(progress);
 
 	/* get authority */
@@ -2447,6 +3270,9 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 		return FALSE;
 	fu_progress_step_done(progress);
 
+	/* the engine and authority are set up, so run any calls made while loading */
+	fu_call_queue_set_ready(self->call_queue);
+
 	/* own the object */
 	if (socket_address != NULL) {
 		g_autofree gchar *guid = g_dbus_generate_guid();
@@ -2468,16 +3294,11 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 				 "new-connection",
 				 G_CALLBACK(fu_daemon_dbus_new_connection_cb),
 				 self);
-	} else {
-		self->owner_id = g_bus_own_name(G_BUS_TYPE_SYSTEM,
-						FWUPD_DBUS_SERVICE,
-						G_BUS_NAME_OWNER_FLAGS_ALLOW_REPLACEMENT |
-						    G_BUS_NAME_OWNER_FLAGS_REPLACE,
-						fu_daemon_dbus_bus_acquired_cb,
-						fu_daemon_dbus_name_acquired_cb,
-						fu_daemon_dbus_name_lost_cb,
-						self,
-						NULL);
+	} else if (self->owner_id == 0) {
+		if (!fu_daemon_dbus_thread_start(self, error)) {
+			g_prefix_error(error, "failed to own name: ");
+			return FALSE;
+		}
 	}
 	fu_progress_step_done(progress);
 
@@ -2512,6 +3333,14 @@ fu_daemon_init(FuDaemon *self)
 	self->loop = g_main_loop_new(NULL, FALSE);
 	self->system_inhibits =
 	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_daemon_system_inhibit_free);
+	self->devices_variants = g_hash_table_new_full(g_direct_hash,
+						       g_direct_equal,
+						       NULL,
+						       (GDestroyNotify)g_variant_unref);
+	g_mutex_init(&self->snapshot_mutex);
+	g_mutex_init(&self->caller_uids_mutex);
+	self->caller_uids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	self->call_queue = fu_call_queue_new();
 }
 
 static void
@@ -2519,7 +3348,32 @@ fu_daemon_finalize(GObject *obj)
 {
 	FuDaemon *self = FU_DAEMON(obj);
 
+	if (self->dbus_thread != NULL) {
+		g_autoptr(GSource) source = g_idle_source_new();
+		g_source_set_callback(source, fu_daemon_dbus_thread_quit_cb, self, NULL);
+		g_source_attach(source, self->dbus_context);
+		g_thread_join(self->dbus_thread);
+	}
+	if (self->dbus_loop != NULL)
+		g_main_loop_unref(self->dbus_loop);
+	if (self->dbus_context != NULL)
+		g_main_context_unref(self->dbus_context);
+	if (self->warm_devices != NULL)
+		g_ptr_array_unref(self->warm_devices);
+	if (self->snapshot_devices != NULL)
+		g_hash_table_unref(self->snapshot_devices);
+	if (self->snapshot_trusted_uids != NULL)
+		g_array_unref(self->snapshot_trusted_uids);
+	if (self->snapshot_security_attrs != NULL)
+		g_variant_unref(self->snapshot_security_attrs);
+	if (self->snapshot_props != NULL)
+		g_hash_table_unref(self->snapshot_props);
+	g_mutex_clear(&self->snapshot_mutex);
+	g_hash_table_unref(self->caller_uids);
+	g_mutex_clear(&self->caller_uids_mutex);
+	g_object_unref(self->call_queue);
 	g_ptr_array_unref(self->system_inhibits);
+	g_hash_table_unref(self->devices_variants);
 	if (self->client_list != NULL)
 		g_object_unref(self->client_list);
 	if (self->process_quit_id != 0)
@@ -858,15 +858,34 @@ fu_device_list_get_by_guid(FuDeviceList *self, const gchar *guid, GError **error
 	return NULL;
 }
 
+/* is @device in the same device tree as any of @devices */
+static gboolean
+fu_device_list_device_in_scope(FuDevice *device, GPtrArray *devices)
+{
+	g_autoptr(FuDevice) root = fu_device_get_root(device);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device_tmp = g_ptr_array_index(devices, i);
+		g_autoptr(FuDevice) root_tmp = fu_device_get_root(device_tmp);
+		if (g_strcmp0(fu_device_get_id(root), fu_device_get_id(root_tmp)) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
 static GPtrArray *
-fu_device_list_get_wait_for_replug(FuDeviceList *self)
+fu_device_list_get_wait_for_replug(FuDeviceList *self, GPtrArray *devices_scope)
 {
 	GPtrArray *devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
 	for (guint i = 0; i < self->devices->len; i++) {
 		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		if (fu_device_has_flag(item_tmp->device, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG) &&
-		    !fu_device_has_flag(item_tmp->device, FWUPD_DEVICE_FLAG_EMULATED))
-			g_ptr_array_add(devices, g_object_ref(item_tmp->device));
+		if (!fu_device_has_flag(item_tmp->device, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG) ||
+		    fu_device_has_flag(item_tmp->device, FWUPD_DEVICE_FLAG_EMULATED))
+			continue;
+		if (devices_scope != NULL &&
+		    !fu_device_list_device_in_scope(item_tmp->device, devices_scope))
+			continue;
+		g_ptr_array_add(devices, g_object_ref(item_tmp->device));
 	}
 	return devices;
 }
@@ -886,6 +905,26 @@ fu_device_list_get_wait_for_replug(FuDeviceList *self)
  **/
 gboolean
 fu_device_list_wait_for_replug(FuDeviceList *self, GError **error)
+{
+	return fu_device_list_wait_for_replug_full(self, NULL, error);
+}
+
+/**
+ * fu_device_list_wait_for_replug_full:
+ * @self: a device list
+ * @devices: (nullable) (element-type FuDevice): only wait for devices in these device trees
+ * @error: (nullable): optional return location for an error
+ *
+ * Waits for the devices with %FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG to replug, optionally only
+ * considering the device trees that @devices belong to. This allows groups of devices to be
+ * installed at the same time without waiting for, or clearing the flag of, each other.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_device_list_wait_for_replug_full(FuDeviceList *self, GPtrArray *devices, GError **error)
 {
 	guint remove_delay = 0;
 	g_autoptr(GTimer) timer = g_timer_new();
@@ -896,7 +935,7 @@ fu_device_list_wait_for_replug(FuDeviceList *self, GError **error)
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
 	/* not required, or possibly literally just happened */
-	devices_wfr1 = fu_device_list_get_wait_for_replug(self);
+	devices_wfr1 = fu_device_list_get_wait_for_replug(self, devices);
 	if (devices_wfr1->len == 0) {
 		g_info("no replug or re-enumerate required");
 		return TRUE;
@@ -924,13 +963,13 @@ fu_device_list_wait_for_replug(FuDeviceList *self, GError **error)
 		g_autoptr(GPtrArray) devices_wfr_tmp = NULL;
 		g_usleep(1000);
 		g_main_context_iteration(NULL, FALSE);
-		devices_wfr_tmp = fu_device_list_get_wait_for_replug(self);
+		devices_wfr_tmp = fu_device_list_get_wait_for_replug(self, devices);
 		if (devices_wfr_tmp->len == 0)
 			break;
 	} while (g_timer_elapsed(timer, NULL) * 1000.f < remove_delay);
 
 	/* check that no other devices are still waiting for replug */
-	devices_wfr2 = fu_device_list_get_wait_for_replug(self);
+	devices_wfr2 = fu_device_list_get_wait_for_replug(self, devices);
 	if (devices_wfr2->len > 0) {
 		g_autoptr(GPtrArray) device_ids = g_ptr_array_new_with_free_func(g_free);
 		g_autofree gchar *device_ids_str = NULL;
@@ -326,6 +326,18 @@ fu_engine_config_get_ignore_requirements(FuEngineConfig *self)
 	return fu_config_get_value_bool(FU_CONFIG(self), "fwupd", "IgnoreRequirements");
 }
 
+gboolean
+fu_engine_config_get_parallel_install(FuEngineConfig *self)
+{
+	return fu_config_get_value_bool(FU_CONFIG(self), "fwupd", "ParallelInstall");
+}
+
+gboolean
+fu_engine_config_get_warm_start(FuEngineConfig *self)
+{
+	return fu_config_get_value_bool(FU_CONFIG(self), "fwupd", "WarmStart");
+}
+
 gboolean
 fu_engine_config_get_release_dedupe(FuEngineConfig *self)
 {
@@ -418,6 +430,7 @@ fu_engine_config_init(FuEngineConfig *self)
 	fu_engine_set_config_default(self, "IgnoreRequirements", "false");
 	fu_engine_set_config_default(self, "OnlyTrusted", "true");
 	fu_engine_set_config_default(self, "P2pPolicy", FU_DEFAULT_P2P_POLICY);
+	fu_engine_set_config_default(self, "ParallelInstall", "false");
 	fu_engine_set_config_default(self, "ReleaseDedupe", "true");
 	fu_engine_set_config_default(self, "ReleasePriority", "local");
 	fu_engine_set_config_default(self, "ShowDevicePrivate", "true");
@@ -427,6 +440,7 @@ fu_engine_config_init(FuEngineConfig *self)
 	fu_engine_set_config_default(self, "UpdateMotd", "true");
 	fu_engine_set_config_default(self, "UriSchemes", "file;https;http;ipfs");
 	fu_engine_set_config_default(self, "VerboseDomains", NULL);
+	fu_engine_set_config_default(self, "WarmStart", "false");
 }
 
 static void
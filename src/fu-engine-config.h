@@ -52,6 +52,10 @@ gboolean
 fu_engine_config_get_ignore_requirements(FuEngineConfig *self) G_GNUC_NON_NULL(1);
 gboolean
 fu_engine_config_get_release_dedupe(FuEngineConfig *self) G_GNUC_NON_NULL(1);
+gboolean
+fu_engine_config_get_parallel_install(FuEngineConfig *self) G_GNUC_NON_NULL(1);
+gboolean
+fu_engine_config_get_warm_start(FuEngineConfig *self) G_GNUC_NON_NULL(1);
 FuReleasePriority
 fu_engine_config_get_release_priority(FuEngineConfig *self) G_GNUC_NON_NULL(1);
 FuP2pPolicy
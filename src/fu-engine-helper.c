@@ -17,6 +17,7 @@
 
 #include "fu-engine-helper.h"
 #include "fu-engine.h"
+#include "fu-release.h"
 
 static FwupdRelease *
 fu_engine_get_release_with_tag(FuEngine *self,
@@ -146,31 +147,48 @@ fu_engine_update_motd(FuEngine *self, GError **error)
 	return g_file_set_contents(target, str->str, str->len, error);
 }
 
+/* used to ignore device lists saved before the last reboot */
+static gchar *
+fu_engine_get_boot_id(void)
+{
+	g_autofree gchar *procfs = fu_path_from_kind(FU_PATH_KIND_PROCFS);
+	g_autofree gchar *fn = g_build_filename(procfs, "sys", "kernel", "random", "boot_id", NULL);
+	g_autofree gchar *buf = NULL;
+
+	if (!g_file_get_contents(fn, &buf, NULL, NULL))
+		return NULL;
+	return g_strstrip(g_steal_pointer(&buf));
+}
+
+/* this includes the private details, as the warm start filters them for each caller */
 gboolean
 fu_engine_update_devices_file(FuEngine *self, GError **error)
 {
-	FwupdCodecFlags flags = FWUPD_CODEC_FLAG_NONE;
 	gsize len;
 	g_autoptr(JsonBuilder) builder = NULL;
 	g_autoptr(JsonGenerator) generator = NULL;
 	g_autoptr(JsonNode) root = NULL;
 	g_autoptr(GPtrArray) devices = NULL;
+	g_autofree gchar *boot_id = fu_engine_get_boot_id();
 	g_autofree gchar *data = NULL;
 	g_autofree gchar *directory = NULL;
 	g_autofree gchar *target = NULL;
 
-	if (fu_engine_config_get_show_device_private(fu_engine_get_config(self)))
-		flags |= FWUPD_CODEC_FLAG_TRUSTED;
-
 	builder = json_builder_new();
 	json_builder_begin_object(builder);
+	json_builder_set_member_name(builder, "DaemonVersion");
+	json_builder_add_string_value(builder, VERSION);
+	if (boot_id != NULL) {
+		json_builder_set_member_name(builder, "BootId");
+		json_builder_add_string_value(builder, boot_id);
+	}
 	json_builder_set_member_name(builder, "Devices");
 	json_builder_begin_array(builder);
 	devices = fu_engine_get_devices(self, NULL);
 	if (devices != NULL) {
 		for (guint i = 0; i < devices->len; i++) {
 			FwupdDevice *dev = g_ptr_array_index(devices, i);
-			fwupd_codec_to_json(FWUPD_CODEC(dev), builder, flags);
+			fwupd_codec_to_json(FWUPD_CODEC(dev), builder, FWUPD_CODEC_FLAG_TRUSTED);
 		}
 	}
 	json_builder_end_array(builder);
@@ -191,7 +209,69 @@ fu_engine_update_devices_file(FuEngine *self, GError **error)
 
 	directory = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
 	target = g_build_filename(directory, "devices.json", NULL);
-	return g_file_set_contents(target, data, (gssize)len, error);
+	return g_file_set_contents_full(target,
+					data,
+					(gssize)len,
+					G_FILE_SET_CONTENTS_CONSISTENT,
+					0600, /* only readable by root */
+					error);
+}
+
+/* the devices saved by fu_engine_update_devices_file() from this boot and daemon version */
+GPtrArray *
+fu_engine_load_devices_file(GError **error)
+{
+	JsonArray *json_array;
+	JsonObject *json_obj;
+	JsonNode *json_root;
+	g_autofree gchar *boot_id = fu_engine_get_boot_id();
+	g_autofree gchar *directory = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *fn = g_build_filename(directory, "devices.json", NULL);
+	g_autoptr(GPtrArray) devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	if (!json_parser_load_from_mapped_file(parser, fn, error))
+		return NULL;
+	json_root = json_parser_get_root(parser);
+	if (json_root == NULL || !JSON_NODE_HOLDS_OBJECT(json_root)) {
+		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA, "no root object in %s", fn);
+		return NULL;
+	}
+	json_obj = json_node_get_object(json_root);
+	if (g_strcmp0(json_object_get_string_member_with_default(json_obj, "DaemonVersion", NULL),
+		      VERSION) != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "%s was not saved by fwupd %s",
+			    fn,
+			    VERSION);
+		return NULL;
+	}
+	if (g_strcmp0(json_object_get_string_member_with_default(json_obj, "BootId", NULL),
+		      boot_id) != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "%s was saved before the last reboot",
+			    fn);
+		return NULL;
+	}
+	if (!json_object_has_member(json_obj, "Devices")) {
+		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA, "no Devices in %s", fn);
+		return NULL;
+	}
+	json_array = json_object_get_array_member(json_obj, "Devices");
+	for (guint i = 0; i < json_array_get_length(json_array); i++) {
+		JsonNode *node_tmp = json_array_get_element(json_array, i);
+		g_autoptr(FwupdDevice) dev = fwupd_device_new();
+		if (!fwupd_codec_from_json(FWUPD_CODEC(dev), node_tmp, error))
+			return NULL;
+		g_ptr_array_add(devices, g_steal_pointer(&dev));
+	}
+
+	/* success */
+	return g_steal_pointer(&devices);
 }
 
 static void
@@ -242,6 +322,8 @@ fu_engine_integrity_measure_uefi(GHashTable *self)
 		    {FU_EFIVAR_GUID_SECURITY_DATABASE, "dbx"},
 		    {FU_EFIVAR_GUID_SECURITY_DATABASE, "dbxDefault"},
 		    {NULL, NULL}};
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GPtrArray) names = NULL;
 
 	/* important keys */
 	for (guint i = 0; keys[i].guid != NULL; i++) {
@@ -253,25 +335,37 @@ fu_engine_integrity_measure_uefi(GHashTable *self)
 		}
 	}
 
-	/* Boot#### */
-	for (guint i = 0; i < 0xFF; i++) {
-		g_autofree gchar *name = g_strdup_printf("Boot%04X", i);
-		g_autoptr(GBytes) blob =
-		    fu_efivar_get_data_bytes(FU_EFIVAR_GUID_EFI_GLOBAL, name, NULL, NULL);
-		if (blob != NULL && g_bytes_get_size(blob) > 0) {
-			const guint8 needle[] = "f\0w\0u\0p\0d";
-			g_autofree gchar *id = g_strdup_printf("UEFI:%s", name);
-			if (fu_memmem_safe(g_bytes_get_data(blob, NULL),
-					   g_bytes_get_size(blob),
-					   needle,
-					   sizeof(needle),
-					   NULL,
-					   NULL)) {
-				g_debug("skipping %s as fwupd found", id);
-				continue;
-			}
-			fu_engine_integrity_add_measurement(self, id, blob);
+	/* Boot####, including any that cannot be parsed as a load option */
+	names = fu_efivar_get_names(FU_EFIVAR_GUID_EFI_GLOBAL, &error_local);
+	if (names == NULL) {
+		g_debug("failed to get names: %s", error_local->message);
+		return;
+	}
+	for (guint i = 0; i < names->len; i++) {
+		const gchar *name = g_ptr_array_index(names, i);
+		const guint8 needle[] = "f\0w\0u\0p\0d";
+		g_autofree gchar *id = NULL;
+		g_autoptr(GBytes) blob = NULL;
+
+		/* not BootXXXX */
+		if (!g_str_has_prefix(name, "Boot") || strlen(name) != 8)
+			continue;
+		if (!g_ascii_string_to_unsigned(name + 4, 16, 0, G_MAXUINT16, NULL, NULL))
+			continue;
+		blob = fu_efivar_get_data_bytes(FU_EFIVAR_GUID_EFI_GLOBAL, name, NULL, NULL);
+		if (blob == NULL || g_bytes_get_size(blob) == 0)
+			continue;
+		id = g_strdup_printf("UEFI:%s", name);
+		if (fu_memmem_safe(g_bytes_get_data(blob, NULL),
+				   g_bytes_get_size(blob),
+				   needle,
+				   sizeof(needle),
+				   NULL,
+				   NULL)) {
+			g_debug("skipping %s as fwupd found", id);
+			continue;
 		}
+		fu_engine_integrity_add_measurement(self, id, blob);
 	}
 }
 
@@ -484,3 +578,90 @@ fu_engine_build_machine_id(const gchar *salt, GError **error)
 	g_checksum_update(csum, (const guchar *)buf, (gssize)bufsz);
 	return g_strdup(g_checksum_get_string(csum));
 }
+
+static void
+fu_engine_install_group_add_device_keys(GPtrArray *keys, FuDevice *device)
+{
+	g_autoptr(FuDevice) root = fu_device_get_root(device);
+
+	/* anything in the same device tree */
+	g_ptr_array_add(keys, g_strdup(fu_device_get_id(root)));
+
+	/* anything in the same composite update */
+	if (fu_device_get_composite_id(device) != NULL)
+		g_ptr_array_add(keys, g_strdup(fu_device_get_composite_id(device)));
+
+	/* the plugin has set an order that may span multiple device trees */
+	if (fu_device_has_internal_flag(root, FU_DEVICE_INTERNAL_FLAG_EXPLICIT_ORDER))
+		g_ptr_array_add(keys, g_strdup("explicit-order"));
+}
+
+static guint
+fu_engine_install_group_find_root(GArray *links, guint idx)
+{
+	while (g_array_index(links, guint, idx) != idx)
+		idx = g_array_index(links, guint, idx);
+	return idx;
+}
+
+/**
+ * fu_engine_install_releases_build_groups:
+ * @releases: (element-type FuRelease): releases, already sorted into install order
+ *
+ * Splits the releases into groups that share no parent, proxy or composite device, and so
+ * can be installed at the same time. The existing install order is preserved in each group.
+ *
+ * Returns: (transfer container) (element-type GPtrArray): groups of #FuRelease
+ **/
+GPtrArray *
+fu_engine_install_releases_build_groups(GPtrArray *releases)
+{
+	g_autoptr(GArray) links = g_array_sized_new(FALSE, FALSE, sizeof(guint), releases->len);
+	g_autoptr(GHashTable) key_idx = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	g_autoptr(GHashTable) groups_by_root = g_hash_table_new(g_direct_hash, g_direct_equal);
+	g_autoptr(GPtrArray) groups =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_ptr_array_unref);
+
+	/* link any releases that share a device key */
+	for (guint i = 0; i < releases->len; i++) {
+		FuRelease *release = g_ptr_array_index(releases, i);
+		FuDevice *device = fu_release_get_device(release);
+		FuDevice *proxy = fu_device_get_proxy(device);
+		g_autoptr(GPtrArray) keys = g_ptr_array_new_with_free_func(g_free);
+
+		g_array_append_val(links, i);
+		fu_engine_install_group_add_device_keys(keys, device);
+		if (proxy != NULL)
+			fu_engine_install_group_add_device_keys(keys, proxy);
+		for (guint j = 0; j < keys->len; j++) {
+			const gchar *key = g_ptr_array_index(keys, j);
+			gpointer idx_tmp = NULL;
+			guint root1;
+			guint root2;
+
+			if (!g_hash_table_lookup_extended(key_idx, key, NULL, &idx_tmp)) {
+				g_hash_table_insert(key_idx, g_strdup(key), GUINT_TO_POINTER(i));
+				continue;
+			}
+			root1 = fu_engine_install_group_find_root(links, GPOINTER_TO_UINT(idx_tmp));
+			root2 = fu_engine_install_group_find_root(links, i);
+			g_array_index(links, guint, MAX(root1, root2)) = MIN(root1, root2);
+		}
+	}
+
+	/* split into groups, keeping the existing install order */
+	for (guint i = 0; i < releases->len; i++) {
+		FuRelease *release = g_ptr_array_index(releases, i);
+		guint root = fu_engine_install_group_find_root(links, i);
+		GPtrArray *group = g_hash_table_lookup(groups_by_root, GUINT_TO_POINTER(root));
+		if (group == NULL) {
+			group = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+			g_hash_table_insert(groups_by_root, GUINT_TO_POINTER(root), group);
+			g_ptr_array_add(groups, group);
+		}
+		g_ptr_array_add(group, g_object_ref(release));
+	}
+
+	/* success */
+	return g_steal_pointer(&groups);
+}
@@ -12,6 +12,8 @@ gboolean
 fu_engine_update_motd(FuEngine *self, GError **error) G_GNUC_NON_NULL(1);
 gboolean
 fu_engine_update_devices_file(FuEngine *self, GError **error) G_GNUC_NON_NULL(1);
+GPtrArray *
+fu_engine_load_devices_file(GError **error);
 
 GHashTable *
 fu_engine_integrity_new(GError **error);
@@ -22,3 +24,5 @@ GError *
 fu_engine_error_array_get_best(GPtrArray *errors);
 gchar *
 fu_engine_build_machine_id(const gchar *salt, GError **error);
+GPtrArray *
+fu_engine_install_releases_build_groups(GPtrArray *releases) G_GNUC_NON_NULL(1);
@@ -10,9 +10,21 @@
 
 #include "fu-engine-requirements.h"
 
+static gint
+fu_engine_requirements_vercmp(const gchar *version,
+			      const FuVersionKey *version_key,
+			      const gchar *version_req,
+			      FwupdVersionFormat fmt)
+{
+	if (version_key != NULL)
+		return fu_version_key_compare_string(version_key, version_req);
+	return fu_version_compare(version, version_req, fmt);
+}
+
 static gboolean
 fu_engine_requirements_require_vercmp(XbNode *req,
 				      const gchar *version,
+				      const FuVersionKey *version_key,
 				      FwupdVersionFormat fmt,
 				      GError **error)
 {
@@ -22,22 +34,22 @@ fu_engine_requirements_require_vercmp(XbNode *req,
 	const gchar *version_req = xb_node_get_attr(req, "version");
 
 	if (g_strcmp0(tmp, "eq") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
+		rc = fu_engine_requirements_vercmp(version, version_key, version_req, fmt);
 		ret = rc == 0;
 	} else if (g_strcmp0(tmp, "ne") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
+		rc = fu_engine_requirements_vercmp(version, version_key, version_req, fmt);
 		ret = rc != 0;
 	} else if (g_strcmp0(tmp, "lt") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
+		rc = fu_engine_requirements_vercmp(version, version_key, version_req, fmt);
 		ret = rc < 0;
 	} else if (g_strcmp0(tmp, "gt") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
+		rc = fu_engine_requirements_vercmp(version, version_key, version_req, fmt);
 		ret = rc > 0;
 	} else if (g_strcmp0(tmp, "le") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
+		rc = fu_engine_requirements_vercmp(version, version_key, version_req, fmt);
 		ret = rc <= 0;
 	} else if (g_strcmp0(tmp, "ge") == 0) {
-		rc = fu_version_compare(version, version_req, fmt);
+		rc = fu_engine_requirements_vercmp(version, version_key, version_req, fmt);
 		ret = rc >= 0;
 	} else if (g_strcmp0(tmp, "glob") == 0) {
 		ret = g_pattern_match_simple(version_req, version);
@@ -99,6 +111,7 @@ fu_engine_requirements_check_not_child(FuEngine *self,
 		}
 		if (fu_engine_requirements_require_vercmp(req,
 							  version,
+							  fu_device_get_version_key(child),
 							  fu_device_get_version_format(child),
 							  NULL)) {
 			g_set_error(error,
@@ -244,6 +257,7 @@ fu_engine_requirements_check_firmware(FuEngine *self,
 		if (!fu_engine_requirements_require_vercmp(
 			req,
 			version,
+			fu_device_get_version_key(device_actual),
 			fu_device_get_version_format(device_actual),
 			&error_local)) {
 			if (g_strcmp0(xb_node_get_attr(req, "compare"), "ge") == 0) {
@@ -272,6 +286,7 @@ fu_engine_requirements_check_firmware(FuEngine *self,
 		if (!fu_engine_requirements_require_vercmp(
 			req,
 			version,
+			NULL,
 			fu_device_get_version_format(device_actual),
 			&error_local)) {
 			if (g_strcmp0(xb_node_get_attr(req, "compare"), "ge") == 0) {
@@ -438,6 +453,7 @@ fu_engine_requirements_check_firmware(FuEngine *self,
 	if (version != NULL && xb_node_get_attr(req, "compare") != NULL &&
 	    !fu_engine_requirements_require_vercmp(req,
 						   version,
+						   fu_device_get_version_key(device_actual),
 						   fu_device_get_version_format(device_actual),
 						   &error_local)) {
 		if (g_strcmp0(xb_node_get_attr(req, "compare"), "ge") == 0) {
@@ -489,6 +505,7 @@ fu_engine_requirements_check_id(FuEngine *self, XbNode *req, GError **error)
 	}
 	if (!fu_engine_requirements_require_vercmp(req,
 						   version,
+						   NULL,
 						   FWUPD_VERSION_FORMAT_UNKNOWN,
 						   &error_local)) {
 		if (g_strcmp0(xb_node_get_attr(req, "compare"), "ge") == 0) {
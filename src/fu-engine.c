@@ -93,6 +93,8 @@
 #define FU_ENGINE_MAX_METADATA_SIZE  0x2000000 /* 32MB */
 #define FU_ENGINE_MAX_SIGNATURE_SIZE 0x100000  /* 1MB */
 
+#define FU_ENGINE_PARALLEL_INSTALL_MAX 16 /* threads */
+
 static void
 fu_engine_constructed(GObject *obj);
 static void
@@ -129,18 +131,25 @@ struct _FuEngine {
 	GHashTable *blocked_firmware;	      /* (nullable) */
 	GHashTable *emulation_phases;	      /* (element-type int utf8) */
 	GHashTable *emulation_backend_ids;    /* (element-type str int) */
+	guint64 emulation_load_us;
 	GHashTable *device_changed_allowlist; /* (element-type str int) */
 	gchar *host_machine_id;
 	JcatContext *jcat_context;
 	gboolean loaded;
+	gboolean config_loaded;
 	gchar *host_security_id;
+	gboolean host_security_dirty;
 	FuSecurityAttrs *host_security_attrs;
+	GHashTable *host_security_cache; /* (element-type utf8 FuSecurityAttrs) */
+	guint64 devices_generation;	 /* bumped when anything in GetDevices might change */
 	GPtrArray *local_monitors; /* (element-type GFileMonitor) */
 	GMainLoop *acquiesce_loop;
 	guint acquiesce_id;
 	guint acquiesce_delay;
 	guint update_motd_id;
 	FuEngineInstallPhase install_phase;
+	gboolean install_parallel;
+	GThread *main_thread; /* signal handlers are only run in this thread */
 #ifdef HAVE_PASSIM
 	PassimClient *passim_client;
 #endif
@@ -196,6 +205,80 @@ fu_engine_update_motd_reset(FuEngine *self)
 						     self);
 }
 
+static void
+fu_engine_devices_generation_bump(FuEngine *self)
+{
+	self->devices_generation++;
+}
+
+/* signature of the handlers that can be deferred, where @data is optional */
+typedef void (*FuEngineDeferFunc)(GObject *object, gpointer data, FuEngine *self);
+
+typedef struct {
+	FuEngine *self;
+	GObject *object;
+	GObject *data; /* (nullable) */
+	GCallback func;
+} FuEngineDeferHelper;
+
+static void
+fu_engine_defer_helper_free(FuEngineDeferHelper *helper)
+{
+	g_object_unref(helper->self);
+	g_object_unref(helper->object);
+	if (helper->data != NULL)
+		g_object_unref(helper->data);
+	g_free(helper);
+}
+
+static gboolean
+fu_engine_defer_idle_cb(gpointer user_data)
+{
+	FuEngineDeferHelper *helper = (FuEngineDeferHelper *)user_data;
+	((FuEngineDeferFunc)helper->func)(helper->object, helper->data, helper->self);
+	return G_SOURCE_REMOVE;
+}
+
+/*
+ * Signals can be emitted from an install worker thread, but the engine state and the signals the
+ * engine emits are only safe to use from the main thread.
+ *
+ * Returns TRUE if @func will be called again from the main thread, in which case the caller
+ * should return without doing anything else.
+ */
+static gboolean
+fu_engine_defer_to_main_thread(FuEngine *self, GCallback func, GObject *object, GObject *data)
+{
+	FuEngineDeferHelper *helper;
+	g_autoptr(GSource) source = NULL;
+
+	if (g_thread_self() == self->main_thread)
+		return FALSE;
+	helper = g_new0(FuEngineDeferHelper, 1);
+	helper->self = g_object_ref(self);
+	helper->object = g_object_ref(object);
+	helper->data = data != NULL ? g_object_ref(data) : NULL;
+	helper->func = func;
+	source = g_idle_source_new();
+	g_source_set_callback(source,
+			      fu_engine_defer_idle_cb,
+			      helper,
+			      (GDestroyNotify)fu_engine_defer_helper_free);
+	g_source_attach(source, NULL);
+	return TRUE;
+}
+
+static void
+fu_engine_devices_generation_notify_cb(FuDevice *device, GParamSpec *pspec, FuEngine *self)
+{
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_devices_generation_notify_cb),
+					   G_OBJECT(device),
+					   NULL))
+		return;
+	fu_engine_devices_generation_bump(self);
+}
+
 static void
 fu_engine_emit_changed(FuEngine *self)
 {
@@ -205,6 +288,7 @@ fu_engine_emit_changed(FuEngine *self)
 	if (!self->loaded)
 		return;
 
+	fu_engine_devices_generation_bump(self);
 	g_signal_emit(self, signals[SIGNAL_CHANGED], 0);
 	fu_engine_idle_reset(self);
 
@@ -217,15 +301,65 @@ fu_engine_emit_changed(FuEngine *self)
 		g_info("failed to update list of devices: %s", error->message);
 }
 
+static gchar *
+fu_engine_security_attrs_device_key(FuDevice *device)
+{
+	return g_strdup_printf("device:%s", fu_device_get_id(device));
+}
+
+static gchar *
+fu_engine_security_attrs_plugin_key(const gchar *plugin_name)
+{
+	return g_strdup_printf("plugin:%s", plugin_name);
+}
+
+/* all the attributes are added again the next time they are required */
+static void
+fu_engine_security_attrs_invalidate(FuEngine *self)
+{
+	g_hash_table_remove_all(self->host_security_cache);
+	self->host_security_dirty = TRUE;
+}
+
+/* only the attributes from the device and the plugin that owns it are added again */
+static void
+fu_engine_security_attrs_invalidate_device(FuEngine *self, FuDevice *device)
+{
+	g_autofree gchar *key = fu_engine_security_attrs_device_key(device);
+	g_hash_table_remove(self->host_security_cache, key);
+	if (fu_device_get_plugin(device) != NULL) {
+		g_autofree gchar *key_plugin =
+		    fu_engine_security_attrs_plugin_key(fu_device_get_plugin(device));
+		g_hash_table_remove(self->host_security_cache, key_plugin);
+	}
+	self->host_security_dirty = TRUE;
+}
+
+static void
+fu_engine_emit_device_changed_safe(FuEngine *self, FuDevice *device);
+
+static void
+fu_engine_emit_device_changed_safe_cb(FuDevice *device, gpointer data, FuEngine *self)
+{
+	fu_engine_emit_device_changed_safe(self, device);
+}
+
 static void
 fu_engine_emit_device_changed_safe(FuEngine *self, FuDevice *device)
 {
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_emit_device_changed_safe_cb),
+					   G_OBJECT(device),
+					   NULL))
+		return;
+
 	/* do nothing */
 	if (!self->loaded)
 		return;
 
-	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	/* invalidate host security attributes and any cached GetDevices result */
+	fu_engine_security_attrs_invalidate_device(self, device);
+	fu_engine_devices_generation_bump(self);
 	g_signal_emit(self, signals[SIGNAL_DEVICE_CHANGED], 0, device);
 }
 
@@ -261,6 +395,11 @@ fu_engine_set_status(FuEngine *self, FwupdStatus status)
 static void
 fu_engine_generic_notify_cb(FuDevice *device, GParamSpec *pspec, FuEngine *self)
 {
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_generic_notify_cb),
+					   G_OBJECT(device),
+					   NULL))
+		return;
 	if (fu_idle_has_inhibit(self->idle, FU_IDLE_INHIBIT_SIGNALS) &&
 	    !g_hash_table_contains(self->device_changed_allowlist, fu_device_get_id(device))) {
 		g_debug("suppressing notification from %s as transaction is in progress",
@@ -273,6 +412,11 @@ fu_engine_generic_notify_cb(FuDevice *device, GParamSpec *pspec, FuEngine *self)
 static void
 fu_engine_history_notify_cb(FuDevice *device, GParamSpec *pspec, FuEngine *self)
 {
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_history_notify_cb),
+					   G_OBJECT(device),
+					   NULL))
+		return;
 	if (self->write_history) {
 		g_autoptr(GError) error_local = NULL;
 		if (!fu_history_modify_device(self->history, device, &error_local)) {
@@ -291,6 +435,11 @@ fu_engine_history_notify_cb(FuDevice *device, GParamSpec *pspec, FuEngine *self)
 static void
 fu_engine_device_request_cb(FuDevice *device, FwupdRequest *request, FuEngine *self)
 {
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_device_request_cb),
+					   G_OBJECT(device),
+					   G_OBJECT(request)))
+		return;
 	g_info("Emitting DeviceRequest('Message'='%s')", fwupd_request_get_message(request));
 	g_signal_emit(self, signals[SIGNAL_DEVICE_REQUEST], 0, request);
 }
@@ -302,6 +451,17 @@ fu_engine_set_install_phase(FuEngine *self, FuEngineInstallPhase install_phase)
 	self->install_phase = install_phase;
 }
 
+/* (element-type FuDevice): the devices being installed by the current worker thread, if any */
+static GPrivate fu_engine_install_group_devices = G_PRIVATE_INIT(NULL);
+
+/* only wait for the devices in the group being installed by this thread */
+static gboolean
+fu_engine_wait_for_replug(FuEngine *self, GError **error)
+{
+	GPtrArray *devices = g_private_get(&fu_engine_install_group_devices);
+	return fu_device_list_wait_for_replug_full(self->device_list, devices, error);
+}
+
 static void
 fu_engine_watch_device(FuEngine *self, FuDevice *device)
 {
@@ -310,7 +470,15 @@ fu_engine_watch_device(FuEngine *self, FuDevice *device)
 		g_signal_handlers_disconnect_by_func(device_old, fu_engine_generic_notify_cb, self);
 		g_signal_handlers_disconnect_by_func(device_old, fu_engine_history_notify_cb, self);
 		g_signal_handlers_disconnect_by_func(device_old, fu_engine_device_request_cb, self);
+		g_signal_handlers_disconnect_by_func(device_old,
+						     fu_engine_devices_generation_notify_cb,
+						     self);
 	}
+	g_signal_handlers_disconnect_by_func(device, fu_engine_devices_generation_notify_cb, self);
+	g_signal_connect(FU_DEVICE(device),
+			 "notify",
+			 G_CALLBACK(fu_engine_devices_generation_notify_cb),
+			 self);
 	g_signal_connect(FU_DEVICE(device),
 			 "notify::flags",
 			 G_CALLBACK(fu_engine_generic_notify_cb),
@@ -430,12 +598,18 @@ fu_engine_wait_for_acquiesce(FuEngine *self, guint acquiesce_delay)
 static void
 fu_engine_device_added_cb(FuDeviceList *device_list, FuDevice *device, FuEngine *self)
 {
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_device_added_cb),
+					   G_OBJECT(device_list),
+					   G_OBJECT(device)))
+		return;
 	fu_engine_watch_device(self, device);
 	fu_engine_ensure_device_power_inhibit(self, device);
 	fu_engine_ensure_device_lid_inhibit(self, device);
 	fu_engine_ensure_device_display_required_inhibit(self, device);
 	fu_engine_ensure_device_system_inhibit(self, device);
 	fu_engine_acquiesce_reset(self);
+	fu_engine_devices_generation_bump(self);
 	g_signal_emit(self, signals[SIGNAL_DEVICE_ADDED], 0, device);
 }
 
@@ -452,8 +626,15 @@ fu_engine_device_runner_device_removed(FuEngine *self, FuDevice *device)
 static void
 fu_engine_device_removed_cb(FuDeviceList *device_list, FuDevice *device, FuEngine *self)
 {
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_device_removed_cb),
+					   G_OBJECT(device_list),
+					   G_OBJECT(device)))
+		return;
 	fu_engine_device_runner_device_removed(self, device);
 	fu_engine_acquiesce_reset(self);
+	fu_engine_security_attrs_invalidate_device(self, device);
+	fu_engine_devices_generation_bump(self);
 	g_signal_handlers_disconnect_by_data(device, self);
 	g_signal_emit(self, signals[SIGNAL_DEVICE_REMOVED], 0, device);
 }
@@ -461,7 +642,13 @@ fu_engine_device_removed_cb(FuDeviceList *device_list, FuDevice *device, FuEngin
 static void
 fu_engine_device_changed_cb(FuDeviceList *device_list, FuDevice *device, FuEngine *self)
 {
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_device_changed_cb),
+					   G_OBJECT(device_list),
+					   G_OBJECT(device)))
+		return;
 	fu_engine_watch_device(self, device);
+	fu_engine_devices_generation_bump(self);
 	fu_engine_emit_device_changed(self, fu_device_get_id(device));
 	fu_engine_acquiesce_reset(self);
 }
@@ -1826,7 +2013,7 @@ fu_engine_composite_prepare(FuEngine *self, GPtrArray *devices, GError **error)
 	}
 
 	/* wait for any device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, error)) {
 		g_prefix_error(error, "failed to wait for composite prepare: ");
 		return FALSE;
 	}
@@ -1875,7 +2062,7 @@ fu_engine_composite_cleanup(FuEngine *self, GPtrArray *devices, GError **error)
 	}
 
 	/* wait for any device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, error)) {
 		g_prefix_error(error, "failed to wait for composite cleanup: ");
 		return FALSE;
 	}
@@ -1963,6 +2150,307 @@ fu_engine_install_release_version_check(FuEngine *self,
 	return TRUE;
 }
 
+static gboolean
+fu_engine_install_releases_serial(FuEngine *self,
+				  GPtrArray *releases,
+				  FuProgress *progress,
+				  FwupdInstallFlags flags,
+				  GError **error)
+{
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, releases->len);
+	for (guint i = 0; i < releases->len; i++) {
+		FuRelease *release = g_ptr_array_index(releases, i);
+		GInputStream *stream = fu_release_get_stream(release);
+		if (stream == NULL) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_NOT_SUPPORTED,
+					    "no stream for release");
+			return FALSE;
+		}
+		if (!fu_engine_install_release(self,
+					       release,
+					       stream,
+					       fu_progress_get_child(progress),
+					       flags,
+					       error))
+			return FALSE;
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_engine_install_releases_can_parallel(FuEngine *self, GPtrArray *groups)
+{
+	if (groups->len < 2)
+		return FALSE;
+	if (!fu_engine_config_get_parallel_install(self->config))
+		return FALSE;
+
+	/* the emulation phases are global to the engine */
+	if (fu_context_has_flag(self->ctx, FU_CONTEXT_FLAG_SAVE_EVENTS) ||
+	    g_hash_table_size(self->emulation_phases) > 0)
+		return FALSE;
+	return TRUE;
+}
+
+/*
+ * Threading model for parallel installs:
+ *
+ * Each independent group of releases is installed by a worker thread while the main thread runs
+ * a GMainLoop, so that backend events, and therefore device replugs, are still processed.
+ *
+ * - FuDeviceList and FuHistory take their own locks and can be used from any thread.
+ * - Plugin runners are not serialized, so a plugin can write two of its devices at the same time.
+ *   Each device is only in one group and so only used by one worker. FuPlugin locks the device
+ *   cache, the device list and the report metadata, and any other plugin state has to be
+ *   protected by the plugin itself.
+ * - Device, device list and plugin signal handlers are deferred to the main thread using
+ *   fu_engine_defer_to_main_thread(), and so the engine only emits signals from there.
+ * - fu_engine_wait_for_replug() only waits for devices in the group of the calling thread.
+ * - The install phase and emulation data are global, so groups are never installed in parallel
+ *   when recording or replaying emulation data.
+ * - FuProgress is not thread-safe, so each group reports into a standalone progress which is
+ *   forwarded to the parent progress from the main thread.
+ *
+ * The remaining plugin signals, e.g. ::check-supported and ::rules-changed, are not emitted by
+ * the install vfuncs and are not deferred.
+ */
+
+typedef struct {
+	GMainLoop *loop;
+	FuProgress *progress;
+	GPtrArray *helpers;   /* (element-type FuEngineInstallGroupHelper) */
+	gboolean finished;    /* main thread only */
+	gint refresh_pending; /* atomic */
+} FuEngineInstallParallelHelper;
+
+typedef struct {
+	FuEngine *self;
+	FuEngineInstallParallelHelper *parallel;
+	GPtrArray *releases; /* (element-type FuRelease) */
+	GPtrArray *devices;  /* (element-type FuDevice) */
+	FuProgress *progress;
+	FwupdInstallFlags flags;
+	GError *error;
+	gint percentage; /* atomic */
+	gint done;	 /* atomic */
+} FuEngineInstallGroupHelper;
+
+static void
+fu_engine_install_parallel_helper_clear(FuEngineInstallParallelHelper *parallel)
+{
+	g_main_loop_unref(parallel->loop);
+	g_object_unref(parallel->progress);
+	g_ptr_array_unref(parallel->helpers);
+}
+
+static void
+fu_engine_install_parallel_helper_unref(FuEngineInstallParallelHelper *parallel)
+{
+	g_atomic_rc_box_release_full(parallel,
+				     (GDestroyNotify)fu_engine_install_parallel_helper_clear);
+}
+
+static void
+fu_engine_install_group_helper_free(FuEngineInstallGroupHelper *helper)
+{
+	g_ptr_array_unref(helper->releases);
+	g_ptr_array_unref(helper->devices);
+	g_object_unref(helper->progress);
+	if (helper->error != NULL)
+		g_error_free(helper->error);
+	g_free(helper);
+}
+
+/* runs in the main thread */
+static gboolean
+fu_engine_install_parallel_refresh_cb(gpointer user_data)
+{
+	FuEngineInstallParallelHelper *parallel = (FuEngineInstallParallelHelper *)user_data;
+	guint done = 0;
+	guint64 percentage = 0;
+	guint releases_total = 0;
+
+	/* clear first so that any later worker update schedules another refresh */
+	g_atomic_int_set(&parallel->refresh_pending, 0);
+	if (parallel->finished)
+		return G_SOURCE_REMOVE;
+
+	/* each group is weighted by the number of releases it installs */
+	for (guint i = 0; i < parallel->helpers->len; i++) {
+		FuEngineInstallGroupHelper *helper = g_ptr_array_index(parallel->helpers, i);
+		guint percentage_tmp = (guint)g_atomic_int_get(&helper->percentage);
+		percentage += (guint64)percentage_tmp * helper->releases->len;
+		releases_total += helper->releases->len;
+		if (g_atomic_int_get(&helper->done) == 1)
+			done++;
+	}
+	fu_progress_set_percentage(parallel->progress, percentage / releases_total);
+	if (done == parallel->helpers->len)
+		g_main_loop_quit(parallel->loop);
+	return G_SOURCE_REMOVE;
+}
+
+/* runs in a worker thread, and coalesces updates so the main thread is not flooded */
+static void
+fu_engine_install_parallel_refresh(FuEngineInstallParallelHelper *parallel)
+{
+	g_autoptr(GSource) source = NULL;
+
+	if (!g_atomic_int_compare_and_exchange(&parallel->refresh_pending, 0, 1))
+		return;
+	source = g_idle_source_new();
+	g_source_set_callback(source,
+			      fu_engine_install_parallel_refresh_cb,
+			      g_atomic_rc_box_acquire(parallel),
+			      (GDestroyNotify)fu_engine_install_parallel_helper_unref);
+	g_source_attach(source, NULL);
+}
+
+static void
+fu_engine_install_group_percentage_changed_cb(FuProgress *progress,
+					      guint percentage,
+					      FuEngineInstallGroupHelper *helper)
+{
+	g_atomic_int_set(&helper->percentage, (gint)percentage);
+	fu_engine_install_parallel_refresh(helper->parallel);
+}
+
+static void
+fu_engine_install_group_thread_cb(gpointer data, gpointer user_data)
+{
+	FuEngineInstallGroupHelper *helper = (FuEngineInstallGroupHelper *)data;
+
+	g_private_set(&fu_engine_install_group_devices, helper->devices);
+	if (!fu_engine_install_releases_serial(helper->self,
+					       helper->releases,
+					       helper->progress,
+					       helper->flags,
+					       &helper->error)) {
+		g_info("failed to install group of %u releases: %s",
+		       helper->releases->len,
+		       helper->error->message);
+	}
+	g_private_set(&fu_engine_install_group_devices, NULL);
+	g_atomic_int_set(&helper->percentage, 100);
+	g_atomic_int_set(&helper->done, 1);
+	fu_engine_install_parallel_refresh(helper->parallel);
+}
+
+static gboolean
+fu_engine_install_releases_parallel(FuEngine *self,
+				    GPtrArray *groups,
+				    FuProgress *progress,
+				    FwupdInstallFlags flags,
+				    GError **error)
+{
+	guint acquiesce_delay = 0;
+	FuEngineInstallParallelHelper *parallel;
+	GPtrArray *helpers;
+	GThreadPool *pool;
+
+	/* the group progress is forwarded as FuProgress is not thread-safe */
+	parallel = g_atomic_rc_box_new0(FuEngineInstallParallelHelper);
+	parallel->loop = g_main_loop_new(NULL, FALSE);
+	parallel->progress = g_object_ref(progress);
+	parallel->helpers =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_install_group_helper_free);
+	helpers = parallel->helpers;
+	for (guint i = 0; i < groups->len; i++) {
+		GPtrArray *releases = g_ptr_array_index(groups, i);
+		FuEngineInstallGroupHelper *helper = g_new0(FuEngineInstallGroupHelper, 1);
+		helper->self = self;
+		helper->parallel = parallel;
+		helper->releases = g_ptr_array_ref(releases);
+		helper->devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+		for (guint j = 0; j < releases->len; j++) {
+			FuRelease *release = g_ptr_array_index(releases, j);
+			FuDevice *device = fu_release_get_device(release);
+			g_ptr_array_add(helper->devices, g_object_ref(device));
+			if (fu_device_get_proxy(device) != NULL)
+				g_ptr_array_add(helper->devices,
+						g_object_ref(fu_device_get_proxy(device)));
+		}
+		helper->progress = fu_progress_new(G_STRLOC);
+		g_signal_connect(FU_PROGRESS(helper->progress),
+				 "percentage-changed",
+				 G_CALLBACK(fu_engine_install_group_percentage_changed_cb),
+				 helper);
+		helper->flags = flags;
+		g_ptr_array_add(helpers, helper);
+	}
+
+	/* run each independent group on a worker thread */
+	g_info("installing %u independent groups in parallel", groups->len);
+	pool = g_thread_pool_new(fu_engine_install_group_thread_cb,
+				 NULL,
+				 MIN(groups->len, FU_ENGINE_PARALLEL_INSTALL_MAX),
+				 FALSE,
+				 error);
+	if (pool == NULL) {
+		fu_engine_install_parallel_helper_unref(parallel);
+		return FALSE;
+	}
+
+	/* the history is written from the main thread for all the groups */
+	self->install_parallel = TRUE;
+	self->write_history = (flags & FWUPD_INSTALL_FLAG_NO_HISTORY) == 0;
+	for (guint i = 0; i < helpers->len; i++) {
+		FuEngineInstallGroupHelper *helper = g_ptr_array_index(helpers, i);
+		if (!g_thread_pool_push(pool, helper, error)) {
+			/* wait for the groups already pushed */
+			g_thread_pool_free(pool, TRUE, TRUE);
+			parallel->finished = TRUE;
+			self->install_parallel = FALSE;
+			fu_engine_install_parallel_helper_unref(parallel);
+			return FALSE;
+		}
+	}
+
+	/* process replug events and deferred signals until every group has finished */
+	g_main_loop_run(parallel->loop);
+	g_thread_pool_free(pool, FALSE, TRUE);
+	parallel->finished = TRUE;
+	self->install_parallel = FALSE;
+
+	/* a failure in one group does not abort the others */
+	for (guint i = 0; i < helpers->len; i++) {
+		FuEngineInstallGroupHelper *helper = g_ptr_array_index(helpers, i);
+		if (helper->error != NULL) {
+			g_propagate_error(error, g_steal_pointer(&helper->error));
+			fu_engine_install_parallel_helper_unref(parallel);
+			return FALSE;
+		}
+	}
+
+	/* wait for the system to acquiesce using the longest delay of any device */
+	for (guint i = 0; i < helpers->len; i++) {
+		FuEngineInstallGroupHelper *helper = g_ptr_array_index(helpers, i);
+		for (guint j = 0; j < helper->releases->len; j++) {
+			FuRelease *release = g_ptr_array_index(helper->releases, j);
+			FuDevice *device = fu_release_get_device(release);
+			if (fu_device_has_flag(device, FWUPD_DEVICE_FLAG_EMULATED) ||
+			    fu_device_get_update_state(device) != FWUPD_UPDATE_STATE_SUCCESS)
+				continue;
+			acquiesce_delay =
+			    MAX(acquiesce_delay, fu_device_get_acquiesce_delay(device));
+		}
+	}
+	fu_engine_install_parallel_helper_unref(parallel);
+	if (acquiesce_delay > 0) {
+		fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_BUSY);
+		fu_engine_wait_for_acquiesce(self, acquiesce_delay);
+	}
+
+	/* success */
+	return TRUE;
+}
+
 /**
  * fu_engine_install_releases:
  * @self: a #FuEngine
@@ -1989,9 +2477,11 @@ fu_engine_install_releases(FuEngine *self,
 			   FwupdInstallFlags flags,
 			   GError **error)
 {
+	gboolean ret;
 	g_autoptr(FuIdleLocker) locker = NULL;
 	g_autoptr(GPtrArray) devices = NULL;
 	g_autoptr(GPtrArray) devices_new = NULL;
+	g_autoptr(GPtrArray) groups = NULL;
 
 	/* do not allow auto-shutdown during this time */
 	locker = fu_idle_locker_new(self->idle,
@@ -2034,33 +2524,20 @@ fu_engine_install_releases(FuEngine *self,
 		return FALSE;
 	}
 
-	/* all authenticated, so install all the things */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, releases->len);
-	for (guint i = 0; i < releases->len; i++) {
-		FuRelease *release = g_ptr_array_index(releases, i);
-		GInputStream *stream = fu_release_get_stream(release);
-		if (stream == NULL) {
-			g_set_error_literal(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_NOT_SUPPORTED,
-					    "no stream for release");
-			return FALSE;
-		}
-		if (!fu_engine_install_release(self,
-					       release,
-					       stream,
-					       fu_progress_get_child(progress),
-					       flags,
-					       error)) {
-			g_autoptr(GError) error_local = NULL;
-			if (!fu_engine_composite_cleanup(self, devices, &error_local)) {
-				g_warning("failed to cleanup failed composite action: %s",
-					  error_local->message);
-			}
-			return FALSE;
+	/* all authenticated, so install all the things, optionally in parallel */
+	groups = fu_engine_install_releases_build_groups(releases);
+	if (fu_engine_install_releases_can_parallel(self, groups)) {
+		ret = fu_engine_install_releases_parallel(self, groups, progress, flags, error);
+	} else {
+		ret = fu_engine_install_releases_serial(self, releases, progress, flags, error);
+	}
+	if (!ret) {
+		g_autoptr(GError) error_local = NULL;
+		if (!fu_engine_composite_cleanup(self, devices, &error_local)) {
+			g_warning("failed to cleanup failed composite action: %s",
+				  error_local->message);
 		}
-		fu_progress_step_done(progress);
+		return FALSE;
 	}
 
 	/* set all the device statuses back to unknown */
@@ -2444,6 +2921,41 @@ fu_engine_save_into_backup_remote(FuEngine *self, GBytes *fw, GError **error)
 	return fwupd_remote_save_to_filename(remote, remotes_fn, NULL, error);
 }
 
+/* the sleeps and retries are only known by the device that was updated, so save them now rather
+ * than in fu_engine_update_history_device() */
+static void
+fu_engine_install_release_save_timing(FuEngine *self, const gchar *device_id)
+{
+	FuRelease *rel_history;
+	g_autoptr(FuDevice) device = NULL;
+	g_autoptr(FuDevice) dev_history = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GHashTable) metadata =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+
+	device = fu_device_list_get_by_id(self->device_list, device_id, NULL);
+	if (device == NULL)
+		return;
+	fu_device_add_report_metadata_timing(device, metadata);
+	if (g_hash_table_size(metadata) == 0)
+		return;
+	dev_history = fu_history_get_device_by_id(self->history, device_id, &error_local);
+	if (dev_history == NULL) {
+		g_debug("not saving timing: %s", error_local->message);
+		return;
+	}
+	rel_history = FU_RELEASE(fu_device_get_release_default(dev_history));
+	if (rel_history == NULL)
+		return;
+	fu_release_add_metadata(rel_history, metadata);
+	if (!fu_history_modify_device_release(self->history,
+					      dev_history,
+					      rel_history,
+					      &error_local)) {
+		g_warning("failed to save timing for %s: %s", device_id, error_local->message);
+	}
+}
+
 /**
  * fu_engine_install_release:
  * @self: a #FuEngine
@@ -2547,8 +3059,9 @@ fu_engine_install_release(FuEngine *self,
 		return fu_engine_schedule_update(self, device, release, blob_cab, flags, error);
 	}
 
-	/* set this for the callback */
-	self->write_history = (flags & FWUPD_INSTALL_FLAG_NO_HISTORY) == 0;
+	/* set this for the callback, which is set once for all the groups when in parallel */
+	if (!self->install_parallel)
+		self->write_history = (flags & FWUPD_INSTALL_FLAG_NO_HISTORY) == 0;
 
 	/* get per-release firmware blob */
 	stream_fw = fu_release_get_stream(release);
@@ -2585,6 +3098,8 @@ fu_engine_install_release(FuEngine *self,
 				    feature_flags,
 				    &error_local)) {
 		FwupdUpdateState state = fu_device_get_update_state(device);
+		if ((flags & FWUPD_INSTALL_FLAG_NO_HISTORY) == 0)
+			fu_engine_install_release_save_timing(self, fu_device_get_id(device));
 		if (state != FWUPD_UPDATE_STATE_FAILED &&
 		    state != FWUPD_UPDATE_STATE_FAILED_TRANSIENT)
 			fu_device_set_update_state(device_orig, FWUPD_UPDATE_STATE_FAILED);
@@ -2602,6 +3117,8 @@ fu_engine_install_release(FuEngine *self,
 		return FALSE;
 	}
 	g_set_object(&device, device_tmp);
+	if ((flags & FWUPD_INSTALL_FLAG_NO_HISTORY) == 0)
+		fu_engine_install_release_save_timing(self, fu_device_get_id(device));
 
 	/* update state (which updates the database if required) */
 	if (fu_device_has_flag(device, FWUPD_DEVICE_FLAG_NEEDS_REBOOT) ||
@@ -2614,9 +3131,10 @@ fu_engine_install_release(FuEngine *self,
 	if (fu_device_get_update_state(device) != FWUPD_UPDATE_STATE_NEEDS_REBOOT)
 		fu_device_set_update_state(device, FWUPD_UPDATE_STATE_SUCCESS);
 
-	/* wait for the system to acquiesce if required */
+	/* wait for the system to acquiesce if required, which is done once for all the groups
+	 * when installing in parallel */
 	if (fu_device_get_acquiesce_delay(device_orig) > 0 &&
-	    !fu_device_has_flag(device, FWUPD_DEVICE_FLAG_EMULATED)) {
+	    !fu_device_has_flag(device, FWUPD_DEVICE_FLAG_EMULATED) && !self->install_parallel) {
 		fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_BUSY);
 		fu_engine_wait_for_acquiesce(self, fu_device_get_acquiesce_delay(device_orig));
 	}
@@ -2661,8 +3179,84 @@ fu_engine_get_plugin_by_name(FuEngine *self, const gchar *name, GError **error)
 	return fu_plugin_list_find_by_name(self->plugin_list, name, error);
 }
 
+/**
+ * fu_engine_get_runner_stats:
+ * @self: a #FuEngine
+ *
+ * Gets the call count and latency of every plugin and backend vfunc that has been run.
+ *
+ * Returns: (transfer floating): a #GVariant of type `(aa{sv})`
+ *
+ * Since: 2.0.0
+ **/
+GVariant *
+fu_engine_get_runner_stats(FuEngine *self)
+{
+	GPtrArray *plugins;
+	GVariantBuilder builder;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	for (guint i = 0; i < self->backends->len; i++) {
+		FuBackend *backend = g_ptr_array_index(self->backends, i);
+		fu_backend_add_runner_stats(backend, &builder);
+	}
+	plugins = fu_plugin_list_get_all(self->plugin_list);
+	for (guint i = 0; i < plugins->len; i++) {
+		FuPlugin *plugin = g_ptr_array_index(plugins, i);
+		fu_plugin_add_runner_stats(plugin, &builder);
+	}
+	return g_variant_new("(aa{sv})", &builder);
+}
+
+/**
+ * fu_engine_get_plugin_runner_us:
+ * @self: a #FuEngine
+ *
+ * Gets the total time spent in every plugin vfunc that has been run, counting the vfuncs that
+ * were run from another plugin vfunc only once.
+ *
+ * Returns: time in microseconds
+ *
+ * Since: 2.0.0
+ **/
+guint64
+fu_engine_get_plugin_runner_us(FuEngine *self)
+{
+	GPtrArray *plugins;
+	guint64 total_us = 0;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), 0);
+
+	plugins = fu_plugin_list_get_all(self->plugin_list);
+	for (guint i = 0; i < plugins->len; i++) {
+		FuPlugin *plugin = g_ptr_array_index(plugins, i);
+		total_us += fu_plugin_get_runner_total_us(plugin);
+	}
+	return total_us;
+}
+
+/**
+ * fu_engine_get_emulation_load_us:
+ * @self: a #FuEngine
+ *
+ * Gets the total time spent loading recorded devices into the backends, not including the time
+ * spent in the plugin vfuncs that then probe the devices.
+ *
+ * Returns: time in microseconds
+ *
+ * Since: 2.0.0
+ **/
+guint64
+fu_engine_get_emulation_load_us(FuEngine *self)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), 0);
+	return self->emulation_load_us;
+}
+
 static gboolean
-fu_engine_emulation_load_json(FuEngine *self, const gchar *json, GError **error)
+fu_engine_emulation_load_json_backends(FuEngine *self, const gchar *json, GError **error)
 {
 	JsonNode *root;
 	g_autoptr(JsonParser) parser = json_parser_new();
@@ -2687,6 +3281,24 @@ fu_engine_emulation_load_json(FuEngine *self, const gchar *json, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_engine_emulation_load_json(FuEngine *self, const gchar *json, GError **error)
+{
+	gboolean ret;
+	gint64 begin_us = g_get_monotonic_time();
+	guint64 plugin_us = fu_engine_get_plugin_runner_us(self);
+	guint64 elapsed_us;
+
+	/* the plugin vfuncs run when the devices are added are counted separately, and as nested
+	 * vfuncs are only counted once they cannot take longer than the load itself */
+	ret = fu_engine_emulation_load_json_backends(self, json, error);
+	elapsed_us = g_get_monotonic_time() - begin_us;
+	plugin_us = fu_engine_get_plugin_runner_us(self) - plugin_us;
+	g_warn_if_fail(plugin_us <= elapsed_us);
+	self->emulation_load_us += elapsed_us - MIN(plugin_us, elapsed_us);
+	return ret;
+}
+
 static gboolean
 fu_engine_emulation_load_phase(FuEngine *self, GError **error)
 {
@@ -2896,7 +3508,7 @@ fu_engine_get_device(FuEngine *self, const gchar *device_id, GError **error)
 	}
 
 	/* wait for any device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, error)) {
 		g_prefix_error(error, "failed to wait for device: ");
 		return NULL;
 	}
@@ -3040,7 +3652,7 @@ fu_engine_prepare(FuEngine *self,
 	}
 
 	/* wait for any device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, error)) {
 		g_prefix_error(error, "failed to wait for prepare replug: ");
 		return FALSE;
 	}
@@ -3085,7 +3697,7 @@ fu_engine_cleanup(FuEngine *self,
 	}
 
 	/* wait for any device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, error)) {
 		g_prefix_error(error, "failed to wait for cleanup replug: ");
 		return FALSE;
 	}
@@ -3158,7 +3770,7 @@ fu_engine_detach(FuEngine *self,
 	}
 
 	/* wait for any device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, error)) {
 		g_prefix_error(error, "failed to wait for detach replug: ");
 		return FALSE;
 	}
@@ -3208,7 +3820,7 @@ fu_engine_attach(FuEngine *self, const gchar *device_id, FuProgress *progress, G
 	}
 
 	/* wait for any device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, error)) {
 		g_prefix_error(error, "failed to wait for attach replug: ");
 		return FALSE;
 	}
@@ -3300,7 +3912,7 @@ fu_engine_reload(FuEngine *self, const gchar *device_id, GError **error)
 	}
 
 	/* wait for any device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, error)) {
 		g_prefix_error(error, "failed to wait for reload replug: ");
 		return FALSE;
 	}
@@ -3391,7 +4003,7 @@ fu_engine_write_firmware(FuEngine *self,
 	}
 
 	/* wait for any device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, error)) {
 		g_prefix_error(error, "failed to wait for write-firmware replug: ");
 		return FALSE;
 	}
@@ -4179,7 +4791,7 @@ fu_engine_metadata_changed(FuEngine *self)
 	fu_engine_md_refresh_devices(self);
 
 	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_security_attrs_invalidate(self);
 
 	/* make the UI update */
 	fu_engine_emit_changed(self);
@@ -4475,7 +5087,7 @@ fu_engine_update_metadata_bytes(FuEngine *self,
 	fu_engine_md_refresh_devices(self);
 
 	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_security_attrs_invalidate(self);
 
 	/* make the UI update */
 	fu_engine_emit_changed(self);
@@ -4516,8 +5128,8 @@ fu_engine_update_metadata(FuEngine *self,
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
 	/* ensures the fd's are closed on error */
-	stream_fd = fu_unix_seekable_input_stream_new(fd, TRUE);
-	stream_sig = fu_unix_seekable_input_stream_new(fd_sig, TRUE);
+	stream_fd = fu_unix_seekable_input_stream_new_sealed(fd);
+	stream_sig = fu_unix_seekable_input_stream_new_sealed(fd_sig);
 
 	/* read the entire file into memory */
 	bytes_raw = fu_input_stream_read_bytes(stream_fd, 0, FU_ENGINE_MAX_METADATA_SIZE, error);
@@ -4863,6 +5475,23 @@ fu_engine_get_devices(FuEngine *self, GError **error)
 	return g_steal_pointer(&devices);
 }
 
+/**
+ * fu_engine_get_devices_generation:
+ * @self: a #FuEngine
+ *
+ * Gets a counter that is incremented whenever a device is added, removed or changed, so that
+ * callers can tell if the result of fu_engine_get_devices() might be different. The initial
+ * value is random so that it does not repeat when the daemon is restarted.
+ *
+ * Returns: integer
+ **/
+guint64
+fu_engine_get_devices_generation(FuEngine *self)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), 0);
+	return self->devices_generation;
+}
+
 /**
  * fu_engine_get_devices_by_guid:
  * @self: a #FuEngine
@@ -5123,10 +5752,15 @@ fu_engine_sort_releases_cb(gconstpointer a, gconstpointer b, gpointer user_data)
 	if (rc != 0)
 		return rc;
 
-	/* then by version */
-	rc = fu_version_compare(fu_release_get_version(rel_b),
-				fu_release_get_version(rel_a),
-				fu_device_get_version_format(device));
+	/* then by version, using the cached keys when the format is the same */
+	if (fu_release_get_device(rel_a) == device && fu_release_get_device(rel_b) == device) {
+		rc = fu_version_key_compare(fu_release_get_version_key(rel_b),
+					    fu_release_get_version_key(rel_a));
+	} else {
+		rc = fu_version_compare(fu_release_get_version(rel_b),
+					fu_release_get_version(rel_a),
+					fu_device_get_version_format(device));
+	}
 	if (rc != 0)
 		return rc;
 
@@ -6059,6 +6693,11 @@ static void
 fu_engine_plugin_device_register_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_plugin_device_register_cb),
+					   G_OBJECT(plugin),
+					   G_OBJECT(device)))
+		return;
 	fu_engine_plugin_device_register(self, device);
 }
 
@@ -6067,6 +6706,12 @@ fu_engine_plugin_device_added_cb(FuPlugin *plugin, FuDevice *device, gpointer us
 {
 	FuEngine *self = FU_ENGINE(user_data);
 
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_plugin_device_added_cb),
+					   G_OBJECT(plugin),
+					   G_OBJECT(device)))
+		return;
+
 	/* plugin has prio and device not already set from quirk */
 	if (fu_plugin_get_priority(plugin) > 0 && fu_device_get_priority(device) == 0) {
 		g_info("auto-setting %s priority to %u",
@@ -6464,13 +7109,27 @@ fu_engine_plugin_rules_changed_cb(FuPlugin *plugin, gpointer user_data)
 	}
 }
 
+static void
+fu_engine_plugin_security_changed_cb(FuPlugin *plugin, gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(user_data);
+	g_autofree gchar *key = fu_engine_security_attrs_plugin_key(fu_plugin_get_name(plugin));
+
+	/* invalidate host security attributes from just this plugin */
+	g_hash_table_remove(self->host_security_cache, key);
+	self->host_security_dirty = TRUE;
+
+	/* make UI refresh */
+	fu_engine_emit_changed(self);
+}
+
 static void
 fu_engine_context_security_changed_cb(FuContext *ctx, gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
 
 	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_security_attrs_invalidate(self);
 
 	/* make UI refresh */
 	fu_engine_emit_changed(self);
@@ -6484,6 +7143,12 @@ fu_engine_plugin_device_removed_cb(FuPlugin *plugin, FuDevice *device, gpointer
 	g_autoptr(FuDevice) device_tmp = NULL;
 	g_autoptr(GError) error = NULL;
 
+	if (fu_engine_defer_to_main_thread(self,
+					   G_CALLBACK(fu_engine_plugin_device_removed_cb),
+					   G_OBJECT(plugin),
+					   G_OBJECT(device)))
+		return;
+
 	device_tmp = fu_device_list_get_by_id(self->device_list, fu_device_get_id(device), &error);
 	if (device_tmp == NULL) {
 		g_info("failed to find device %s: %s", fu_device_get_id(device), error->message);
@@ -7122,20 +7787,81 @@ fu_engine_load_host_emulation(FuEngine *self, const gchar *fn, GError **error)
 	return TRUE;
 }
 
+#ifdef HAVE_HSI
+/* reuses the attributes from the last time if the device or plugin has not changed */
+static void
+fu_engine_ensure_security_attrs_producer(FuEngine *self, GObject *producer)
+{
+	FuSecurityAttrs *attrs_cached;
+	guint lookup_cnt;
+	g_autofree gchar *key = NULL;
+	g_autoptr(GPtrArray) items_old = NULL;
+	g_autoptr(GPtrArray) items_new = NULL;
+
+	if (FU_IS_DEVICE(producer))
+		key = fu_engine_security_attrs_device_key(FU_DEVICE(producer));
+	else
+		key = fu_engine_security_attrs_plugin_key(fu_plugin_get_name(FU_PLUGIN(producer)));
+	attrs_cached = g_hash_table_lookup(self->host_security_cache, key);
+	if (attrs_cached != NULL) {
+		g_autoptr(GPtrArray) items = fu_security_attrs_get_all(attrs_cached);
+		for (guint i = 0; i < items->len; i++) {
+			FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
+			g_autoptr(FwupdSecurityAttr) attr_copy = fwupd_security_attr_copy(attr);
+			fu_security_attrs_append_internal(self->host_security_attrs, attr_copy);
+		}
+		return;
+	}
+
+	/* call into the device or plugin */
+	items_old = fu_security_attrs_get_all(self->host_security_attrs);
+	lookup_cnt = fu_security_attrs_get_lookup_count(self->host_security_attrs);
+	if (FU_IS_DEVICE(producer)) {
+		fu_device_add_security_attrs(FU_DEVICE(producer), self->host_security_attrs);
+	} else {
+		fu_plugin_runner_add_security_attrs(FU_PLUGIN(producer),
+						    self->host_security_attrs);
+	}
+
+	/* this uses or modifies the attributes added by something else, so cannot be reused */
+	if (fu_security_attrs_get_lookup_count(self->host_security_attrs) != lookup_cnt)
+		return;
+
+	/* save a copy before the depsolve modifies them */
+	attrs_cached = fu_security_attrs_new();
+	items_new = fu_security_attrs_get_all(self->host_security_attrs);
+	for (guint i = items_old->len; i < items_new->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items_new, i);
+		g_autoptr(FwupdSecurityAttr) attr_copy = fwupd_security_attr_copy(attr);
+		fu_security_attrs_append_internal(attrs_cached, attr_copy);
+	}
+	g_hash_table_insert(self->host_security_cache, g_steal_pointer(&key), attrs_cached);
+}
+#endif
+
 static void
 fu_engine_ensure_security_attrs(FuEngine *self)
 {
 #ifdef HAVE_HSI
 	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
+	g_autofree gchar *host_security_id_old = NULL;
+	g_autoptr(FuSecurityAttrs) attrs_old = fu_security_attrs_new();
 	g_autoptr(GPtrArray) devices = fu_device_list_get_active(self->device_list);
+	g_autoptr(GPtrArray) items_old = NULL;
 	g_autoptr(GPtrArray) vals = NULL;
 	g_autoptr(GError) error = NULL;
 
 	/* already valid */
-	if (self->host_security_id != NULL || self->host_emulation)
+	if (!self->host_security_dirty || self->host_emulation)
 		return;
 
-	/* clear old values */
+	/* save old values so we can tell if anything changed */
+	host_security_id_old = g_steal_pointer(&self->host_security_id);
+	items_old = fu_security_attrs_get_all(self->host_security_attrs);
+	for (guint i = 0; i < items_old->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items_old, i);
+		fu_security_attrs_append_internal(attrs_old, attr);
+	}
 	fu_security_attrs_remove_all(self->host_security_attrs);
 
 	/* built in */
@@ -7145,13 +7871,13 @@ fu_engine_ensure_security_attrs(FuEngine *self)
 	/* call into devices */
 	for (guint i = 0; i < devices->len; i++) {
 		FuDevice *device = g_ptr_array_index(devices, i);
-		fu_device_add_security_attrs(device, self->host_security_attrs);
+		fu_engine_ensure_security_attrs_producer(self, G_OBJECT(device));
 	}
 
 	/* call into plugins */
 	for (guint j = 0; j < plugins->len; j++) {
 		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
-		fu_plugin_runner_add_security_attrs(plugin_tmp, self->host_security_attrs);
+		fu_engine_ensure_security_attrs_producer(self, G_OBJECT(plugin_tmp));
 	}
 
 	/* sanity check */
@@ -7173,6 +7899,14 @@ fu_engine_ensure_security_attrs(FuEngine *self)
 
 	/* depsolve */
 	fu_engine_security_attrs_depsolve(self);
+	self->host_security_dirty = FALSE;
+
+	/* nothing to record */
+	if (g_strcmp0(host_security_id_old, self->host_security_id) == 0 &&
+	    fu_security_attrs_equal(attrs_old, self->host_security_attrs)) {
+		g_debug("HSI attributes unchanged");
+		return;
+	}
 
 	/* record into the database (best effort) */
 	if (!fu_engine_record_security_attrs(self, &error))
@@ -7392,6 +8126,10 @@ fu_engine_plugins_init(FuEngine *self, FuProgress *progress, GError **error)
 				 "rules-changed",
 				 G_CALLBACK(fu_engine_plugin_rules_changed_cb),
 				 self);
+		g_signal_connect(FU_PLUGIN(plugin),
+				 "security-changed",
+				 G_CALLBACK(fu_engine_plugin_security_changed_cb),
+				 self);
 		fu_progress_step_done(progress);
 	}
 
@@ -8145,6 +8883,32 @@ fu_engine_backends_coldplug(FuEngine *self, FuProgress *progress)
 	}
 }
 
+/**
+ * fu_engine_load_config:
+ * @self: a #FuEngine
+ * @error: (nullable): optional return location for an error
+ *
+ * Loads the daemon config file, which allows the caller to use the config before the engine has
+ * been loaded. This is done automatically by fu_engine_load() if not already done.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_engine_load_config(FuEngine *self, GError **error)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (self->config_loaded)
+		return TRUE;
+	if (!fu_config_load(FU_CONFIG(self->config), error)) {
+		g_prefix_error(error, "Failed to load config: ");
+		return FALSE;
+	}
+	self->config_loaded = TRUE;
+	return TRUE;
+}
+
 /**
  * fu_engine_load:
  * @self: a #FuEngine
@@ -8230,10 +8994,8 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 		return FALSE;
 
 	/* read config file */
-	if (!fu_config_load(FU_CONFIG(self->config), error)) {
-		g_prefix_error(error, "Failed to load config: ");
+	if (!fu_engine_load_config(self, error))
 		return FALSE;
-	}
 	fu_progress_step_done(progress);
 
 	/* set the hardcoded ESP */
@@ -8475,6 +9237,10 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 			 self);
 	fu_engine_set_status(self, FWUPD_STATUS_LOADING);
 
+	/* share the udev parents between devices until the coldplug is complete */
+	if (flags & FU_ENGINE_LOAD_FLAG_COLDPLUG)
+		fu_context_set_udev_cache_enabled(self->ctx, TRUE);
+
 	/* add devices */
 	if (flags & FU_ENGINE_LOAD_FLAG_COLDPLUG) {
 		fu_engine_plugins_startup(self, fu_progress_get_child(progress));
@@ -8489,6 +9255,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 	/* coldplug backends */
 	if (flags & FU_ENGINE_LOAD_FLAG_COLDPLUG)
 		fu_engine_backends_coldplug(self, fu_progress_get_child(progress));
+	fu_context_set_udev_cache_enabled(self->ctx, FALSE);
 	fu_progress_step_done(progress);
 
 	/* coldplug done, so plugin is ready */
@@ -8905,6 +9672,12 @@ fu_engine_init(FuEngine *self)
 	self->plugin_list = fu_plugin_list_new();
 	self->plugin_filter = g_ptr_array_new_with_free_func(g_free);
 	self->host_security_attrs = fu_security_attrs_new();
+	self->host_security_dirty = TRUE;
+	self->host_security_cache =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_object_unref);
+	/* clients may keep a generation across a daemon restart, so never start from the same value */
+	self->devices_generation = ((guint64)g_random_int() << 32) + 1;
+	self->main_thread = g_thread_self();
 	self->backends = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	self->local_monitors = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	self->acquiesce_loop = g_main_loop_new(NULL, FALSE);
@@ -8966,6 +9739,7 @@ fu_engine_finalize(GObject *obj)
 	g_free(self->host_machine_id);
 	g_free(self->host_security_id);
 	g_object_unref(self->host_security_attrs);
+	g_hash_table_unref(self->host_security_cache);
 	g_object_unref(self->idle);
 	g_object_unref(self->config);
 	g_object_unref(self->remote_list);
@@ -60,6 +60,8 @@ fu_engine_idle_inhibit(FuEngine *self, FuIdleInhibit inhibit, const gchar *reaso
 void
 fu_engine_idle_uninhibit(FuEngine *self, guint32 token) G_GNUC_NON_NULL(1);
 gboolean
+fu_engine_load_config(FuEngine *self, GError **error) G_GNUC_NON_NULL(1);
+gboolean
 fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GError **error)
     G_GNUC_NON_NULL(1, 3);
 const gchar *
@@ -84,8 +86,16 @@ fu_engine_get_plugins(FuEngine *self) G_GNUC_NON_NULL(1);
 FuPlugin *
 fu_engine_get_plugin_by_name(FuEngine *self, const gchar *name, GError **error)
     G_GNUC_NON_NULL(1, 2);
+GVariant *
+fu_engine_get_runner_stats(FuEngine *self) G_GNUC_NON_NULL(1);
+guint64
+fu_engine_get_plugin_runner_us(FuEngine *self) G_GNUC_NON_NULL(1);
+guint64
+fu_engine_get_emulation_load_us(FuEngine *self) G_GNUC_NON_NULL(1);
 GPtrArray *
 fu_engine_get_devices(FuEngine *self, GError **error) G_GNUC_NON_NULL(1);
+guint64
+fu_engine_get_devices_generation(FuEngine *self) G_GNUC_NON_NULL(1);
 FuDevice *
 fu_engine_get_device(FuEngine *self, const gchar *device_id, GError **error) G_GNUC_NON_NULL(1, 2);
 GPtrArray *
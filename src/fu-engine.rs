@@ -45,4 +45,6 @@ enum FuIdleInhibit {
 enum FuClientFlag {
     None = 0,
     Active = 1 << 0,
+    HasUid = 1 << 1,
+    InhibitIdle = 1 << 2,
 }
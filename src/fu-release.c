@@ -32,6 +32,7 @@ struct _FuRelease {
 	GPtrArray *soft_reqs; /* nullable, element-type XbNode */
 	GPtrArray *hard_reqs; /* nullable, element-type XbNode */
 	guint64 priority;
+	FuVersionKey *version_key; /* nullable */
 };
 
 G_DEFINE_TYPE(FuRelease, fu_release, FWUPD_TYPE_RELEASE)
@@ -141,6 +142,32 @@ fu_release_set_device(FuRelease *self, FuDevice *device)
 	fu_release_set_device_version_old(self, fu_device_get_version(device));
 }
 
+/**
+ * fu_release_get_version_key:
+ * @self: a #FuRelease
+ *
+ * Gets the release version parsed using the device version format, which is cached so that
+ * sorting many releases does not have to allocate memory.
+ *
+ * Returns: (nullable): a #FuVersionKey, or %NULL if the version is unset
+ **/
+const FuVersionKey *
+fu_release_get_version_key(FuRelease *self)
+{
+	FwupdVersionFormat fmt = FWUPD_VERSION_FORMAT_UNKNOWN;
+	const gchar *version = fu_release_get_version(self);
+
+	g_return_val_if_fail(FU_IS_RELEASE(self), NULL);
+
+	if (self->device != NULL)
+		fmt = fu_device_get_version_format(self->device);
+	if (!fu_version_key_matches(self->version_key, version, fmt)) {
+		g_clear_pointer(&self->version_key, fu_version_key_free);
+		self->version_key = fu_version_key_new(version, fmt);
+	}
+	return self->version_key;
+}
+
 /**
  * fu_release_get_device:
  * @self: a #FuRelease
@@ -1299,6 +1326,9 @@ fu_release_compare(FuRelease *release1, FuRelease *release2)
 	}
 
 	/* FWUPD_DEVICE_FLAG_INSTALL_ALL_RELEASES has to be from oldest to newest */
+	if (device1 == device2)
+		return fu_version_key_compare(fu_release_get_version_key(release1),
+					      fu_release_get_version_key(release2));
 	return fu_version_compare(fu_release_get_version(release1),
 				  fu_release_get_version(release2),
 				  fu_device_get_version_format(device1));
@@ -1331,6 +1361,8 @@ fu_release_finalize(GObject *obj)
 		g_ptr_array_unref(self->soft_reqs);
 	if (self->hard_reqs != NULL)
 		g_ptr_array_unref(self->hard_reqs);
+	if (self->version_key != NULL)
+		fu_version_key_free(self->version_key);
 
 	G_OBJECT_CLASS(fu_release_parent_class)->finalize(obj);
 }
@@ -12,7 +12,10 @@
 #include <glib/gstdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
+#include "fwupd-common-private.h"
+#include "fwupd-enums-private.h"
 #include "fwupd-remote-private.h"
 #include "fwupd-security-attr-private.h"
 
@@ -20,6 +23,7 @@
 #include "fu-backend-private.h"
 #include "fu-bios-settings-private.h"
 #include "fu-cabinet.h"
+#include "fu-call-queue.h"
 #include "fu-client-list.h"
 #include "fu-config-private.h"
 #include "fu-console.h"
@@ -182,11 +186,71 @@ fu_client_list_func(void)
 	g_assert_cmpstr(fu_client_lookup_hint(client, "key"), ==, "value");
 	g_assert_cmpint(fu_client_get_feature_flags(client), ==, FWUPD_FEATURE_FLAG_UPDATE_ACTION);
 
+	/* credentials are cached on the client */
+	g_assert_false(fu_client_has_flag(client, FU_CLIENT_FLAG_HAS_UID));
+	fu_client_set_uid(client, 0);
+	g_assert_true(fu_client_has_flag(client, FU_CLIENT_FLAG_HAS_UID));
+	g_assert_cmpint(fu_client_get_uid(client_find), ==, 0);
+
 	/* emulate disconnect */
 	fu_client_remove_flag(client, FU_CLIENT_FLAG_ACTIVE);
 	g_assert_false(fu_client_has_flag(client, FU_CLIENT_FLAG_ACTIVE));
 }
 
+typedef struct {
+	FuCallQueue *call_queue;
+	GString *str;
+} FuCallQueueHelper;
+
+static gboolean
+fu_call_queue_append_cb(gpointer user_data)
+{
+	GString *str = (GString *)user_data;
+	g_string_append_c(str, 'x');
+	return G_SOURCE_REMOVE;
+}
+
+static gpointer
+fu_call_queue_thread_cb(gpointer user_data)
+{
+	FuCallQueueHelper *helper = (FuCallQueueHelper *)user_data;
+	fu_call_queue_push(helper->call_queue, fu_call_queue_append_cb, helper->str, NULL);
+	return NULL;
+}
+
+static void
+fu_call_queue_func(void)
+{
+	GThread *thread;
+	g_autoptr(FuCallQueue) call_queue = fu_call_queue_new();
+	g_autoptr(GString) str = g_string_new(NULL);
+	FuCallQueueHelper helper = {.call_queue = call_queue, .str = str};
+
+	/* a call arrives from the D-Bus thread while the engine is loading */
+	thread = g_thread_new("fu-call-queue", fu_call_queue_thread_cb, &helper);
+	g_thread_join(thread);
+	g_assert_cmpint(fu_call_queue_get_pending(call_queue), ==, 1);
+
+	/* a nested main loop while loading does not run it */
+	while (g_main_context_iteration(NULL, FALSE))
+		;
+	g_assert_cmpstr(str->str, ==, "");
+
+	/* the engine has loaded */
+	fu_call_queue_set_ready(call_queue);
+	g_assert_cmpint(fu_call_queue_get_pending(call_queue), ==, 0);
+	while (g_main_context_iteration(NULL, FALSE))
+		;
+	g_assert_cmpstr(str->str, ==, "x");
+
+	/* no longer held */
+	fu_call_queue_push(call_queue, fu_call_queue_append_cb, str, NULL);
+	g_assert_cmpint(fu_call_queue_get_pending(call_queue), ==, 0);
+	while (g_main_context_iteration(NULL, FALSE))
+		;
+	g_assert_cmpstr(str->str, ==, "xx");
+}
+
 static void
 fu_idle_func(void)
 {
@@ -1972,6 +2036,7 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	FuTest *self = (FuTest *)user_data;
 	FwupdRelease *rel;
 	gboolean ret;
+	guint64 generation;
 	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
 	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
 	g_autoptr(FuEngineRequest) request = fu_engine_request_new();
@@ -2104,7 +2169,9 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	fu_device_add_guid(device, "aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee");
 	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE);
 	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UNSIGNED_PAYLOAD);
+	generation = fu_engine_get_devices_generation(engine);
 	fu_engine_add_device(engine, device);
+	g_assert_cmpint(fu_engine_get_devices_generation(engine), >, generation);
 	devices = fu_engine_get_devices(engine, &error);
 	g_assert_no_error(error);
 	g_assert_nonnull(devices);
@@ -2112,6 +2179,11 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	g_assert_true(fu_device_has_flag(device, FWUPD_DEVICE_FLAG_SUPPORTED));
 	g_assert_true(fu_device_has_flag(device, FWUPD_DEVICE_FLAG_REGISTERED));
 
+	/* any property change invalidates the serialized device list */
+	generation = fu_engine_get_devices_generation(engine);
+	fu_device_set_update_message(device, "Unplug the cable");
+	g_assert_cmpint(fu_engine_get_devices_generation(engine), >, generation);
+
 	/* get the releases for one device */
 	releases = fu_engine_get_releases(engine, request, fu_device_get_id(device), &error);
 	g_assert_no_error(error);
@@ -2787,6 +2859,158 @@ fu_engine_multiple_rels_func(gconstpointer user_data)
 	g_assert_true(ret);
 }
 
+static void
+fu_engine_install_parallel_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	FuEngineConfig *config;
+	gboolean ret;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(FuCabinet) cabinet = NULL;
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new();
+	g_autoptr(GPtrArray) devices =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_autoptr(GPtrArray) groups = NULL;
+	g_autoptr(GPtrArray) releases = NULL;
+	g_autoptr(GPtrArray) rels = NULL;
+	g_autoptr(XbQuery) query = NULL;
+
+#ifndef HAVE_LIBARCHIVE
+	g_test_skip("no libarchive support");
+	return;
+#endif
+
+	/* ensure empty tree */
+	fu_self_test_mkroot();
+
+	/* no metadata in daemon */
+	fu_engine_set_silo(engine, silo_empty);
+
+	/* set up dummy plugin */
+	ret = fu_plugin_reset_config_values(self->plugin, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_engine_add_plugin(engine, self->plugin);
+
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_NO_CACHE, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* make the writes long enough to overlap */
+	ret = fu_plugin_set_config_value(self->plugin, "WriteDelay", "500", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* install each device in a different thread */
+	config = fu_engine_get_config(engine);
+	ret = fu_config_set_value(FU_CONFIG(config), "fwupd", "ParallelInstall", "true", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* add two unrelated devices of the same plugin so that they are in different groups */
+	for (guint i = 0; i < 2; i++) {
+		g_autofree gchar *id = g_strdup_printf("test_device%u", i);
+		g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+		fu_device_set_version_format(device, FWUPD_VERSION_FORMAT_TRIPLET);
+		fu_device_set_version(device, "1.2.2");
+		fu_device_set_id(device, id);
+		fu_device_add_vendor_id(device, "USB:FFFF");
+		fu_device_add_protocol(device, "com.acme");
+		fu_device_set_name(device, "Test Device");
+		fu_device_set_plugin(device, "test");
+		fu_device_add_guid(device, "12345678-1234-1234-1234-123456789012");
+		fu_device_add_checksum(device, "0123456789abcdef0123456789abcdef01234567");
+		fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE);
+		fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UNSIGNED_PAYLOAD);
+		fu_device_add_flag(device, FWUPD_DEVICE_FLAG_INSTALL_ALL_RELEASES);
+		fu_device_set_created(device, 1515338000);
+		fu_device_set_metadata_integer(device, "nr-update", 0);
+		fu_engine_add_device(engine, device);
+		g_ptr_array_add(devices, g_steal_pointer(&device));
+	}
+
+	filename = g_test_build_filename(G_TEST_BUILT,
+					 "tests",
+					 "multiple-rels",
+					 "multiple-rels-1.2.4.cab",
+					 NULL);
+	stream = fu_input_stream_from_path(filename, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(stream);
+	cabinet = fu_engine_build_cabinet_from_stream(engine, stream, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(cabinet);
+	component = fu_cabinet_get_component(cabinet, "com.hughski.test.firmware", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(component);
+	query = xb_query_new_full(xb_node_get_silo(component),
+				  "releases/release",
+				  XB_QUERY_FLAG_FORCE_NODE_CACHE,
+				  &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(query);
+	rels = xb_node_query_full(component, query, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(rels);
+
+	/* both releases for both devices */
+	releases = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	for (guint j = 0; j < devices->len; j++) {
+		FuDevice *device = g_ptr_array_index(devices, j);
+		for (guint i = 0; i < rels->len; i++) {
+			XbNode *rel = g_ptr_array_index(rels, i);
+			g_autoptr(FuRelease) release = fu_release_new();
+			fu_release_set_device(release, device);
+			ret = fu_release_load(release,
+					      cabinet,
+					      component,
+					      rel,
+					      FWUPD_INSTALL_FLAG_NONE,
+					      &error);
+			g_assert_no_error(error);
+			g_assert_true(ret);
+			g_ptr_array_add(releases, g_steal_pointer(&release));
+		}
+	}
+	groups = fu_engine_install_releases_build_groups(releases);
+	g_assert_cmpint(groups->len, ==, 2);
+
+	/* install them */
+	fu_progress_reset(progress);
+	ret = fu_engine_install_releases(engine,
+					 request,
+					 releases,
+					 cabinet,
+					 progress,
+					 FWUPD_INSTALL_FLAG_NONE,
+					 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_progress_get_percentage(progress), ==, 100);
+
+	/* check each device did 1.2.2 -> 1.2.3 -> 1.2.4, and the plugin wrote both at once */
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		g_assert_cmpint(fu_device_get_metadata_integer(device, "nr-update"), ==, 2);
+		g_assert_cmpstr(fu_device_get_version(device), ==, "1.2.4");
+		g_assert_true(fu_device_get_metadata_boolean(device, "WriteOverlapped"));
+	}
+
+	/* reset the config back to defaults */
+	ret = fu_config_set_value(FU_CONFIG(config), "fwupd", "ParallelInstall", "false", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_engine_reset_config(engine, "test", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
 static void
 fu_engine_history_inherit(gconstpointer user_data)
 {
@@ -3526,6 +3750,43 @@ fu_device_list_replug_user_func(gconstpointer user_data)
 	g_assert_false(fu_device_has_flag(device2, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG));
 }
 
+static void
+fu_device_list_replug_scope_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	g_autoptr(FuDevice) device1 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device2 = fu_device_new(self->ctx);
+	g_autoptr(FuDeviceList) device_list = fu_device_list_new();
+	g_autoptr(GPtrArray) scope1 = g_ptr_array_new();
+	g_autoptr(GPtrArray) scope2 = g_ptr_array_new();
+	g_autoptr(GError) error = NULL;
+
+	/* two unrelated devices */
+	fu_device_set_id(device1, "device1");
+	fu_device_set_plugin(device1, "self-test");
+	fu_device_set_id(device2, "device2");
+	fu_device_set_plugin(device2, "self-test");
+	fu_device_set_remove_delay(device2, 10);
+	fu_device_list_add(device_list, device1);
+	fu_device_list_add(device_list, device2);
+	g_ptr_array_add(scope1, device1);
+	g_ptr_array_add(scope2, device2);
+
+	/* only device2 is waiting, so the group with device1 does not wait or clear it */
+	fu_device_add_flag(device2, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG);
+	ret = fu_device_list_wait_for_replug_full(device_list, scope1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_true(fu_device_has_flag(device2, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG));
+
+	/* device2 never comes back */
+	ret = fu_device_list_wait_for_replug_full(device_list, scope2, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_false(ret);
+	g_assert_false(fu_device_has_flag(device2, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG));
+}
+
 static void
 fu_device_list_compatible_func(gconstpointer user_data)
 {
@@ -4750,6 +5011,130 @@ fu_plugin_composite_func(gconstpointer user_data)
 	}
 }
 
+G_DECLARE_FINAL_TYPE(FuHsiTestPlugin, fu_hsi_test_plugin, FU, HSI_TEST_PLUGIN, FuPlugin)
+
+struct _FuHsiTestPlugin {
+	FuPlugin parent_instance;
+	const gchar *appstream_id;
+	FwupdSecurityAttrResult result;
+	guint add_cnt;
+};
+
+G_DEFINE_TYPE(FuHsiTestPlugin, fu_hsi_test_plugin, FU_TYPE_PLUGIN)
+
+static void
+fu_hsi_test_plugin_add_security_attrs(FuPlugin *plugin, FuSecurityAttrs *attrs)
+{
+	FuHsiTestPlugin *self = FU_HSI_TEST_PLUGIN(plugin);
+	g_autoptr(FwupdSecurityAttr) attr = fu_plugin_security_attr_new(plugin, self->appstream_id);
+	fwupd_security_attr_set_result(attr, self->result);
+	fu_security_attrs_append(attrs, attr);
+	self->add_cnt++;
+}
+
+static void
+fu_hsi_test_plugin_init(FuHsiTestPlugin *self)
+{
+	self->result = FWUPD_SECURITY_ATTR_RESULT_ENABLED;
+}
+
+static void
+fu_hsi_test_plugin_class_init(FuHsiTestPluginClass *klass)
+{
+	FuPluginClass *plugin_class = FU_PLUGIN_CLASS(klass);
+	plugin_class->add_security_attrs = fu_hsi_test_plugin_add_security_attrs;
+}
+
+static void
+fu_engine_security_attrs_cache_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	FuHsiTestPlugin *hsi1;
+	FuHsiTestPlugin *hsi2;
+	gboolean ret;
+	g_autofree gchar *history_db = NULL;
+	g_autofree gchar *localstatedir = NULL;
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuHistory) history = fu_history_new();
+	g_autoptr(FuPlugin) plugin1 = NULL;
+	g_autoptr(FuPlugin) plugin2 = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) attrs_array1 = NULL;
+	g_autoptr(GPtrArray) attrs_array2 = NULL;
+	g_autoptr(GPtrArray) attrs_array3 = NULL;
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+
+#ifndef HAVE_HSI
+	g_test_skip("no HSI support");
+	return;
+#endif
+#ifndef HAVE_SQLITE
+	g_test_skip("no sqlite support");
+	return;
+#endif
+
+	/* delete history */
+	localstatedir = fu_path_from_kind(FU_PATH_KIND_LOCALSTATEDIR_PKG);
+	history_db = g_build_filename(localstatedir, "pending.db", NULL);
+	(void)g_unlink(history_db);
+
+	/* no metadata in daemon */
+	fu_engine_set_silo(engine, silo_empty);
+
+	/* set up two plugins that each add one attribute */
+	plugin1 = fu_plugin_new_from_gtype(fu_hsi_test_plugin_get_type(), self->ctx);
+	fu_plugin_set_name(plugin1, "hsi1");
+	hsi1 = FU_HSI_TEST_PLUGIN(plugin1);
+	hsi1->appstream_id = FWUPD_SECURITY_ATTR_ID_ENCRYPTED_RAM;
+	fu_engine_add_plugin(engine, plugin1);
+	plugin2 = fu_plugin_new_from_gtype(fu_hsi_test_plugin_get_type(), self->ctx);
+	fu_plugin_set_name(plugin2, "hsi2");
+	hsi2 = FU_HSI_TEST_PLUGIN(plugin2);
+	hsi2->appstream_id = FWUPD_SECURITY_ATTR_ID_IOMMU;
+	fu_engine_add_plugin(engine, plugin2);
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_NO_CACHE, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* both plugins are called the first time, and the result is recorded */
+	g_assert_nonnull(fu_engine_get_host_security_id(engine));
+	g_assert_cmpint(hsi1->add_cnt, ==, 1);
+	g_assert_cmpint(hsi2->add_cnt, ==, 1);
+	attrs_array1 = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_array1);
+	g_assert_cmpint(attrs_array1->len, ==, 1);
+
+	/* nothing changed, so nothing is called */
+	g_assert_nonnull(fu_engine_get_host_security_id(engine));
+	g_assert_cmpint(hsi1->add_cnt, ==, 1);
+	g_assert_cmpint(hsi2->add_cnt, ==, 1);
+
+	/* only the plugin that signalled is called, and the history is not checked */
+	g_test_expect_message("FuEngine", G_LOG_LEVEL_DEBUG, "HSI attributes unchanged");
+	fu_plugin_security_changed(plugin1);
+	g_assert_nonnull(fu_engine_get_host_security_id(engine));
+	g_test_assert_expected_messages();
+	g_assert_cmpint(hsi1->add_cnt, ==, 2);
+	g_assert_cmpint(hsi2->add_cnt, ==, 1);
+	attrs_array2 = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_array2);
+	g_assert_cmpint(attrs_array2->len, ==, 1);
+
+	/* a different result from the plugin is recorded */
+	hsi1->result = FWUPD_SECURITY_ATTR_RESULT_NOT_ENCRYPTED;
+	fu_plugin_security_changed(plugin1);
+	g_assert_nonnull(fu_engine_get_host_security_id(engine));
+	g_assert_cmpint(hsi1->add_cnt, ==, 3);
+	g_assert_cmpint(hsi2->add_cnt, ==, 1);
+	attrs_array3 = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_array3);
+	g_assert_cmpint(attrs_array3->len, ==, 2);
+}
+
 static void
 fu_security_attr_func(gconstpointer user_data)
 {
@@ -5045,6 +5430,51 @@ fu_release_compare_func(gconstpointer user_data)
 	g_assert_cmpstr(fu_release_get_branch(g_ptr_array_index(releases, 2)), ==, "1");
 }
 
+static void
+fu_engine_install_groups_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	GPtrArray *group;
+	g_autoptr(GPtrArray) groups = NULL;
+	g_autoptr(GPtrArray) releases =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_autoptr(FuDevice) device1 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device2 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device3 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device4 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device5 = fu_device_new(self->ctx);
+	FuDevice *devices[] = {device2, device3, device1, device5, device4};
+
+	/* device2 is a child of device1, device4 is proxied by device3 */
+	fu_device_set_id(device1, "device1");
+	fu_device_set_id(device2, "device2");
+	fu_device_set_id(device3, "device3");
+	fu_device_set_id(device4, "device4");
+	fu_device_set_id(device5, "device5");
+	fu_device_add_child(device1, device2);
+	fu_device_set_proxy(device4, device3);
+	for (guint i = 0; i < G_N_ELEMENTS(devices); i++) {
+		g_autoptr(FuRelease) release = fu_release_new();
+		fu_release_set_device(release, devices[i]);
+		g_ptr_array_add(releases, g_steal_pointer(&release));
+	}
+
+	/* the install order is preserved in each group */
+	groups = fu_engine_install_releases_build_groups(releases);
+	g_assert_cmpint(groups->len, ==, 3);
+	group = g_ptr_array_index(groups, 0);
+	g_assert_cmpint(group->len, ==, 2);
+	g_assert_true(fu_release_get_device(g_ptr_array_index(group, 0)) == device2);
+	g_assert_true(fu_release_get_device(g_ptr_array_index(group, 1)) == device1);
+	group = g_ptr_array_index(groups, 1);
+	g_assert_cmpint(group->len, ==, 2);
+	g_assert_true(fu_release_get_device(g_ptr_array_index(group, 0)) == device3);
+	g_assert_true(fu_release_get_device(g_ptr_array_index(group, 1)) == device4);
+	group = g_ptr_array_index(groups, 2);
+	g_assert_cmpint(group->len, ==, 1);
+	g_assert_true(fu_release_get_device(g_ptr_array_index(group, 0)) == device5);
+}
+
 static void
 fu_release_uri_scheme_func(void)
 {
@@ -5947,6 +6377,69 @@ fu_unix_seekable_input_stream_func(void)
 #endif
 }
 
+static void
+fu_unix_seekable_input_stream_sealed_func(void)
+{
+#ifdef HAVE_GIO_UNIX
+	gboolean ret;
+	gint fd;
+	guint8 buf[6] = {0};
+	g_autofree gchar *fn = NULL;
+	g_autoptr(GBytes) blob = g_bytes_new_static("hello world", 11);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GUnixInputStream) stream_client = NULL;
+
+	/* as the client would send it */
+	stream_client = fwupd_unix_input_stream_from_bytes(blob, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(stream_client);
+	fd = dup(g_unix_input_stream_get_fd(stream_client));
+	g_assert_cmpint(fd, >=, 0);
+
+	/* mapped rather than read if the kernel supports sealing */
+	stream = fu_unix_seekable_input_stream_new_sealed(fd);
+	g_assert_nonnull(stream);
+#if defined(HAVE_MEMFD_CREATE) && defined(F_GET_SEALS)
+	g_assert_true(G_IS_MEMORY_INPUT_STREAM(stream));
+#endif
+	ret = g_input_stream_read(stream, buf, sizeof(buf) - 1, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpstr((const gchar *)buf, ==, "hello");
+	g_clear_object(&stream);
+	g_clear_object(&stream_client);
+
+	/* a file is also sent as a sealed memfd */
+	fn = g_test_build_filename(G_TEST_DIST, "tests", "metadata.xml", NULL);
+	stream_client = fwupd_unix_input_stream_from_fn(fn, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(stream_client);
+	fd = dup(g_unix_input_stream_get_fd(stream_client));
+	g_assert_cmpint(fd, >=, 0);
+	stream = fu_unix_seekable_input_stream_new_sealed(fd);
+	g_assert_nonnull(stream);
+#if defined(HAVE_MEMFD_CREATE) && defined(F_GET_SEALS)
+	g_assert_true(G_IS_MEMORY_INPUT_STREAM(stream));
+#endif
+	g_clear_object(&stream);
+
+	/* an fd that is not sealed is read as before */
+	fd = open(fn, O_RDONLY);
+	g_assert_cmpint(fd, >=, 0);
+	stream = fu_unix_seekable_input_stream_new_sealed(fd);
+	g_assert_nonnull(stream);
+	g_assert_true(FU_IS_UNIX_SEEKABLE_INPUT_STREAM(stream));
+	memset(buf, 0, sizeof(buf));
+	ret = g_input_stream_read(stream, buf, sizeof(buf) - 1, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpstr((const gchar *)buf, ==, "<?xml");
+#else
+	g_test_skip("No gio-unix-2.0 support, skipping");
+#endif
+}
+
 static void
 fu_remote_download_func(void)
 {
@@ -6406,6 +6899,156 @@ fu_config_migrate_1_7_func(void)
 	g_assert_cmpstr(localconf_data, ==, "");
 }
 
+static void
+fu_engine_integrity_boot_entries_func(void)
+{
+	gboolean ret;
+	const guint32 attr = FU_EFIVAR_ATTR_NON_VOLATILE | FU_EFIVAR_ATTR_BOOTSERVICE_ACCESS |
+			     FU_EFIVAR_ATTR_RUNTIME_ACCESS;
+	const guint8 buf1[] = {0x01, 0x02, 0x03};
+	const guint8 buf2[] = {0x01, 0x02, 0x04};
+	g_autofree gchar *csum = NULL;
+	g_autofree gchar *efivardir = NULL;
+	g_autofree gchar *sysfsfwdir_old = g_strdup(g_getenv("FWUPD_SYSFSFWDIR"));
+	g_autofree gchar *tmpdir = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) integrity = NULL;
+
+#ifndef __linux__
+	g_test_skip("only works on Linux");
+	return;
+#endif
+
+	/* these tests will write */
+	tmpdir = g_dir_make_tmp("fwupd-self-test-XXXXXX", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(tmpdir);
+	efivardir = g_build_filename(tmpdir, "efi", "efivars", NULL);
+	g_assert_cmpint(g_mkdir_with_parents(efivardir, 0700), ==, 0);
+	(void)g_setenv("FWUPD_SYSFSFWDIR", tmpdir, TRUE);
+
+	/* not a valid load option, but still measured */
+	ret = fu_efivar_set_data(FU_EFIVAR_GUID_EFI_GLOBAL,
+				 "Boot0001",
+				 buf1,
+				 sizeof(buf1),
+				 attr,
+				 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	integrity = fu_engine_integrity_new(&error);
+	g_assert_no_error(error);
+	g_assert_nonnull(integrity);
+	csum = g_strdup(g_hash_table_lookup(integrity, "UEFI:Boot0001"));
+	g_assert_nonnull(csum);
+	g_clear_pointer(&integrity, g_hash_table_unref);
+
+	/* changing the malformed entry changes the measurement */
+	ret = fu_efivar_set_data(FU_EFIVAR_GUID_EFI_GLOBAL,
+				 "Boot0001",
+				 buf2,
+				 sizeof(buf2),
+				 attr,
+				 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	integrity = fu_engine_integrity_new(&error);
+	g_assert_no_error(error);
+	g_assert_nonnull(integrity);
+	g_assert_cmpstr(g_hash_table_lookup(integrity, "UEFI:Boot0001"), !=, csum);
+
+	/* restore */
+	(void)g_setenv("FWUPD_SYSFSFWDIR", sysfsfwdir_old, TRUE);
+	ret = fu_path_rmtree(tmpdir, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
+static void
+fu_engine_devices_file_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	FwupdDevice *device_tmp = NULL;
+	g_autofree gchar *cachedir = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *fn = g_build_filename(cachedir, "devices.json", NULL);
+	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) devices_old = NULL;
+	g_autoptr(GPtrArray) devices_reboot = NULL;
+	g_autoptr(GVariant) serial = NULL;
+	g_autoptr(GVariant) val = NULL;
+
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_NO_CACHE, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_path_mkdir_parent(fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* add a device with a serial number, which only trusted callers can see */
+	fu_device_set_id(device, "devices-file-dev0");
+	fu_device_add_vendor_id(device, "USB:FFFF");
+	fu_device_add_protocol(device, "com.acme");
+	fu_device_add_guid(device, "2d47f29b-83a2-4f31-a2e8-63474f4d4c2e");
+	fu_device_set_serial(device, "0123456789");
+	fu_engine_add_device(engine, device);
+	ret = fu_engine_update_devices_file(engine, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+#ifndef _WIN32
+	{
+		GStatBuf statbuf = {0};
+		g_assert_cmpint(g_stat(fn, &statbuf), ==, 0);
+		g_assert_cmpint(statbuf.st_mode & 0777, ==, 0600);
+	}
+#endif
+
+	/* the private details are saved, but still filtered for untrusted callers */
+	devices = fu_engine_load_devices_file(&error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices);
+	for (guint i = 0; i < devices->len; i++) {
+		FwupdDevice *device_loaded = g_ptr_array_index(devices, i);
+		if (g_strcmp0(fwupd_device_get_id(device_loaded), fu_device_get_id(device)) == 0)
+			device_tmp = device_loaded;
+	}
+	g_assert_nonnull(device_tmp);
+	g_assert_cmpstr(fwupd_device_get_serial(device_tmp), ==, "0123456789");
+	val = g_variant_ref_sink(fwupd_codec_to_variant(FWUPD_CODEC(device_tmp),
+							 FWUPD_CODEC_FLAG_NONE));
+	serial = g_variant_lookup_value(val, FWUPD_RESULT_KEY_SERIAL, NULL);
+	g_assert_null(serial);
+
+	/* saved by a different daemon version */
+	ret = g_file_set_contents(fn,
+				  "{\"DaemonVersion\":\"0.0.1\","
+				  "\"Devices\":[{\"DeviceId\":\"abc\"}]}",
+				  -1,
+				  &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	devices_old = fu_engine_load_devices_file(&error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_null(devices_old);
+	g_clear_error(&error);
+
+	/* saved before the last reboot */
+	ret = g_file_set_contents(fn,
+				  "{\"DaemonVersion\":\"" VERSION "\",\"BootId\":\"invalid\","
+				  "\"Devices\":[{\"DeviceId\":\"abc\"}]}",
+				  -1,
+				  &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	devices_reboot = fu_engine_load_devices_file(&error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_null(devices_reboot);
+}
+
 static void
 fu_engine_machine_hash_func(void)
 {
@@ -6487,6 +7130,7 @@ main(int argc, char **argv)
 		g_test_add_data_func("/fwupd/console", self, fu_console_func);
 	}
 	g_test_add_func("/fwupd/idle", fu_idle_func);
+	g_test_add_func("/fwupd/call-queue", fu_call_queue_func);
 	g_test_add_func("/fwupd/client-list", fu_client_list_func);
 	g_test_add_func("/fwupd/remote{download}", fu_remote_download_func);
 	g_test_add_func("/fwupd/remote{no-path}", fu_remote_nopath_func);
@@ -6495,12 +7139,17 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/remote{auth}", fu_remote_auth_func);
 	g_test_add_func("/fwupd/remote-list{repair}", fu_remote_list_repair_func);
 	g_test_add_func("/fwupd/unix-seekable-input-stream", fu_unix_seekable_input_stream_func);
+	g_test_add_func("/fwupd/unix-seekable-input-stream{sealed}",
+			fu_unix_seekable_input_stream_sealed_func);
 	g_test_add_data_func("/fwupd/backend{usb}", self, fu_backend_usb_func);
 	g_test_add_data_func("/fwupd/backend{usb-invalid}", self, fu_backend_usb_invalid_func);
 	g_test_add_data_func("/fwupd/plugin{module}", self, fu_plugin_module_func);
 	g_test_add_data_func("/fwupd/memcpy", self, fu_memcpy_func);
 	g_test_add_func("/fwupd/cabinet", fu_common_cabinet_func);
 	g_test_add_data_func("/fwupd/security-attr", self, fu_security_attr_func);
+	g_test_add_data_func("/fwupd/engine{security-attrs-cache}",
+			     self,
+			     fu_engine_security_attrs_cache_func);
 	g_test_add_data_func("/fwupd/device-list", self, fu_device_list_func);
 	g_test_add_data_func("/fwupd/device-list{delay}", self, fu_device_list_delay_func);
 	g_test_add_data_func("/fwupd/device-list{explicit-order}",
@@ -6522,6 +7171,7 @@ main(int argc, char **argv)
 			     self,
 			     fu_device_list_counterpart_func);
 	g_test_add_data_func("/fwupd/release{compare}", self, fu_release_compare_func);
+	g_test_add_data_func("/fwupd/engine{install-groups}", self, fu_engine_install_groups_func);
 	g_test_add_func("/fwupd/release{uri-scheme}", fu_release_uri_scheme_func);
 	g_test_add_data_func("/fwupd/release{trusted-report}",
 			     self,
@@ -6548,6 +7198,9 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/engine{multiple-releases}",
 			     self,
 			     fu_engine_multiple_rels_func);
+	g_test_add_data_func("/fwupd/engine{install-parallel}",
+			     self,
+			     fu_engine_install_parallel_func);
 	g_test_add_data_func("/fwupd/engine{install-request}", self, fu_engine_install_request);
 	g_test_add_data_func("/fwupd/engine{history-success}", self, fu_engine_history_func);
 	g_test_add_data_func("/fwupd/engine{history-verfmt}", self, fu_engine_history_verfmt_func);
@@ -6561,7 +7214,13 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/device-list{replug-user}",
 			     self,
 			     fu_device_list_replug_user_func);
+	g_test_add_data_func("/fwupd/device-list{replug-scope}",
+			     self,
+			     fu_device_list_replug_scope_func);
 	g_test_add_func("/fwupd/engine{machine-hash}", fu_engine_machine_hash_func);
+	g_test_add_data_func("/fwupd/engine{devices-file}", self, fu_engine_devices_file_func);
+	g_test_add_func("/fwupd/engine{integrity-boot-entries}",
+			fu_engine_integrity_boot_entries_func);
 	g_test_add_data_func("/fwupd/engine{require-hwid}", self, fu_engine_require_hwid_func);
 	g_test_add_data_func("/fwupd/engine{requires-reboot}",
 			     self,
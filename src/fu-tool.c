@@ -484,6 +484,65 @@ fu_util_get_plugins(FuUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_util_get_timings(FuUtilPrivate *priv, gchar **values, GError **error)
+{
+	g_autoptr(GVariant) val = NULL;
+	g_autoptr(GVariant) timings = NULL;
+
+	/* load engine */
+	if (!fu_util_start_engine(priv,
+				  FU_ENGINE_LOAD_FLAG_COLDPLUG |
+				      FU_ENGINE_LOAD_FLAG_BUILTIN_PLUGINS,
+				  priv->progress,
+				  error))
+		return FALSE;
+
+	/* as JSON */
+	val = g_variant_ref_sink(fu_engine_get_runner_stats(priv->engine));
+	timings = g_variant_get_child_value(val, 0);
+	if (priv->as_json) {
+		g_autoptr(JsonBuilder) builder = json_builder_new();
+		json_builder_begin_object(builder);
+		json_builder_set_member_name(builder, "Timings");
+		json_builder_add_value(builder, json_gvariant_serialize(timings));
+		json_builder_end_object(builder);
+		return fu_util_print_builder(priv->console, builder, error);
+	}
+
+	/* print */
+	for (gsize i = 0; i < g_variant_n_children(timings); i++) {
+		const gchar *kind = NULL;
+		const gchar *name = NULL;
+		const gchar *vfunc = NULL;
+		guint64 cnt = 0;
+		guint64 cnt_error = 0;
+		guint64 total_us = 0;
+		guint64 max_us = 0;
+		g_autoptr(GVariant) dict = g_variant_get_child_value(timings, i);
+
+		g_variant_lookup(dict, "Kind", "&s", &kind);
+		g_variant_lookup(dict, "Name", "&s", &name);
+		g_variant_lookup(dict, "Vfunc", "&s", &vfunc);
+		g_variant_lookup(dict, "Count", "t", &cnt);
+		g_variant_lookup(dict, "ErrorCount", "t", &cnt_error);
+		g_variant_lookup(dict, "TotalUs", "t", &total_us);
+		g_variant_lookup(dict, "MaxUs", "t", &max_us);
+		fu_console_print(priv->console,
+				 "%s %s %s(): %" G_GUINT64_FORMAT " calls, %" G_GUINT64_FORMAT
+				 " failed, %.1fms total, %.1fms max",
+				 kind,
+				 name != NULL ? name : "unknown",
+				 vfunc,
+				 cnt,
+				 cnt_error,
+				 (gdouble)total_us / 1000.0,
+				 (gdouble)max_us / 1000.0);
+	}
+
+	return TRUE;
+}
+
 static FuDevice *
 fu_util_prompt_for_device(FuUtilPrivate *priv, GPtrArray *devices_opt, GError **error)
 {
@@ -1236,6 +1295,82 @@ fu_util_release_sort_cb(gconstpointer a, gconstpointer b)
 	return fu_release_compare(release1, release2);
 }
 
+/* finds the releases in the cabinet that can be installed on any of the devices */
+static GPtrArray *
+fu_util_get_releases_for_cabinet(FuUtilPrivate *priv,
+				 FuCabinet *cabinet,
+				 GPtrArray *devices_possible,
+				 GError **error)
+{
+	g_autoptr(GPtrArray) components = NULL;
+	g_autoptr(GPtrArray) errors = NULL;
+	g_autoptr(GPtrArray) releases = NULL;
+
+	components = fu_cabinet_get_components(cabinet, error);
+	if (components == NULL)
+		return NULL;
+
+	/* for each component in the silo */
+	errors = g_ptr_array_new_with_free_func((GDestroyNotify)g_error_free);
+	releases = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	for (guint i = 0; i < components->len; i++) {
+		XbNode *component = g_ptr_array_index(components, i);
+
+		/* do any devices pass the requirements */
+		for (guint j = 0; j < devices_possible->len; j++) {
+			FuDevice *device = g_ptr_array_index(devices_possible, j);
+			g_autoptr(FuRelease) release = fu_release_new();
+			g_autoptr(GError) error_local = NULL;
+
+			/* is this component valid for the device */
+			fu_release_set_device(release, device);
+			fu_release_set_request(release, priv->request);
+			if (!fu_release_load(release,
+					     cabinet,
+					     component,
+					     NULL,
+					     priv->flags,
+					     &error_local)) {
+				g_debug("loading release failed on %s:%s failed: %s",
+					fu_device_get_id(device),
+					xb_node_query_text(component, "id", NULL),
+					error_local->message);
+				g_ptr_array_add(errors, g_steal_pointer(&error_local));
+				continue;
+			}
+			if (!fu_engine_requirements_check(priv->engine,
+							  release,
+							  priv->flags,
+							  &error_local)) {
+				g_debug("requirement on %s:%s failed: %s",
+					fu_device_get_id(device),
+					xb_node_query_text(component, "id", NULL),
+					error_local->message);
+				g_ptr_array_add(errors, g_steal_pointer(&error_local));
+				continue;
+			}
+
+			/* if component should have an update message from CAB */
+			fu_device_ensure_from_component(device, component);
+			fu_device_incorporate_from_component(device, component);
+
+			/* success */
+			g_ptr_array_add(releases, g_steal_pointer(&release));
+		}
+	}
+
+	/* order the install tasks by the device priority */
+	g_ptr_array_sort(releases, fu_util_release_sort_cb);
+
+	/* nothing suitable */
+	if (releases->len == 0) {
+		GError *error_tmp = fu_engine_error_array_get_best(errors);
+		g_propagate_error(error, error_tmp);
+		return NULL;
+	}
+	return g_steal_pointer(&releases);
+}
+
 static gchar *
 fu_util_download_if_required(FuUtilPrivate *priv, const gchar *perhapsfn, GError **error)
 {
@@ -1269,9 +1404,7 @@ fu_util_install(FuUtilPrivate *priv, gchar **values, GError **error)
 	g_autofree gchar *filename = NULL;
 	g_autoptr(FuCabinet) cabinet = NULL;
 	g_autoptr(GInputStream) stream = NULL;
-	g_autoptr(GPtrArray) components = NULL;
 	g_autoptr(GPtrArray) devices_possible = NULL;
-	g_autoptr(GPtrArray) errors = NULL;
 	g_autoptr(GPtrArray) releases = NULL;
 
 	/* progress */
@@ -1332,69 +1465,10 @@ fu_util_install(FuUtilPrivate *priv, gchar **values, GError **error)
 	cabinet = fu_engine_build_cabinet_from_stream(priv->engine, stream, error);
 	if (cabinet == NULL)
 		return FALSE;
-	components = fu_cabinet_get_components(cabinet, error);
-	if (components == NULL)
+	releases = fu_util_get_releases_for_cabinet(priv, cabinet, devices_possible, error);
+	if (releases == NULL)
 		return FALSE;
 
-	/* for each component in the silo */
-	errors = g_ptr_array_new_with_free_func((GDestroyNotify)g_error_free);
-	releases = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
-	for (guint i = 0; i < components->len; i++) {
-		XbNode *component = g_ptr_array_index(components, i);
-
-		/* do any devices pass the requirements */
-		for (guint j = 0; j < devices_possible->len; j++) {
-			FuDevice *device = g_ptr_array_index(devices_possible, j);
-			g_autoptr(FuRelease) release = fu_release_new();
-			g_autoptr(GError) error_local = NULL;
-
-			/* is this component valid for the device */
-			fu_release_set_device(release, device);
-			fu_release_set_request(release, priv->request);
-			if (!fu_release_load(release,
-					     cabinet,
-					     component,
-					     NULL,
-					     priv->flags,
-					     &error_local)) {
-				g_debug("loading release failed on %s:%s failed: %s",
-					fu_device_get_id(device),
-					xb_node_query_text(component, "id", NULL),
-					error_local->message);
-				g_ptr_array_add(errors, g_steal_pointer(&error_local));
-				continue;
-			}
-			if (!fu_engine_requirements_check(priv->engine,
-							  release,
-							  priv->flags,
-							  &error_local)) {
-				g_debug("requirement on %s:%s failed: %s",
-					fu_device_get_id(device),
-					xb_node_query_text(component, "id", NULL),
-					error_local->message);
-				g_ptr_array_add(errors, g_steal_pointer(&error_local));
-				continue;
-			}
-
-			/* if component should have an update message from CAB */
-			fu_device_ensure_from_component(device, component);
-			fu_device_incorporate_from_component(device, component);
-
-			/* success */
-			g_ptr_array_add(releases, g_steal_pointer(&release));
-		}
-	}
-
-	/* order the install tasks by the device priority */
-	g_ptr_array_sort(releases, fu_util_release_sort_cb);
-
-	/* nothing suitable */
-	if (releases->len == 0) {
-		GError *error_tmp = fu_engine_error_array_get_best(errors);
-		g_propagate_error(error, error_tmp);
-		return FALSE;
-	}
-
 	priv->current_operation = FU_UTIL_OPERATION_INSTALL;
 	g_signal_connect(FU_ENGINE(priv->engine),
 			 "device-changed",
@@ -1424,6 +1498,221 @@ fu_util_install(FuUtilPrivate *priv, gchar **values, GError **error)
 	return fu_util_prompt_complete(priv->console, priv->completion_flags, TRUE, error);
 }
 
+/*
+ * USB transfers are replayed inside libgusb, which is called directly by the plugins, and so the
+ * replayed device I/O cannot be separated from the plugin code that requests it.
+ */
+typedef struct {
+	guint64 total_us;
+	guint64 engine_us;	     /* engine bookkeeping */
+	guint64 plugin_us;	     /* plugin vfuncs, including the replayed device I/O */
+	guint64 device_load_us;	     /* loading the recorded devices into the backends */
+	guint64 sleep_suppressed_ms; /* delays not performed as the devices are emulated */
+} FuUtilBenchmarkRun;
+
+static gboolean
+fu_util_emulation_benchmark_run(FuUtilPrivate *priv,
+				GBytes *emulation_data,
+				FuCabinet *cabinet,
+				FuProgress *progress,
+				FuUtilBenchmarkRun *run,
+				GError **error)
+{
+	FuContext *ctx = fu_engine_get_context(priv->engine);
+	gint64 begin_us = g_get_monotonic_time();
+	guint64 plugin_us = fu_engine_get_plugin_runner_us(priv->engine);
+	guint64 device_load_us = fu_engine_get_emulation_load_us(priv->engine);
+	guint sleep_suppressed_ms = fu_context_get_sleep_skipped(ctx);
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) devices_possible = g_ptr_array_new();
+	g_autoptr(GPtrArray) releases = NULL;
+
+	/* this replaces the emulated devices from any previous run */
+	if (!fu_engine_emulation_load(priv->engine, emulation_data, error))
+		return FALSE;
+	devices = fu_engine_get_devices(priv->engine, error);
+	if (devices == NULL)
+		return FALSE;
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		if (fu_device_has_flag(device, FWUPD_DEVICE_FLAG_EMULATED))
+			g_ptr_array_add(devices_possible, device);
+	}
+	if (devices_possible->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOTHING_TO_DO,
+				    "no emulated devices were added");
+		return FALSE;
+	}
+	releases = fu_util_get_releases_for_cabinet(priv, cabinet, devices_possible, error);
+	if (releases == NULL)
+		return FALSE;
+	if (!fu_engine_install_releases(priv->engine,
+					priv->request,
+					releases,
+					cabinet,
+					progress,
+					priv->flags,
+					error))
+		return FALSE;
+
+	/* the plugins also include the time taken for the replayed device I/O */
+	run->total_us = g_get_monotonic_time() - begin_us;
+	run->plugin_us = fu_engine_get_plugin_runner_us(priv->engine) - plugin_us;
+	run->device_load_us = fu_engine_get_emulation_load_us(priv->engine) - device_load_us;
+	run->sleep_suppressed_ms = fu_context_get_sleep_skipped(ctx) - sleep_suppressed_ms;
+
+	/* emulated installs are never run in parallel, so the parts cannot overlap */
+	if (run->plugin_us + run->device_load_us > run->total_us) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "plugin time %" G_GUINT64_FORMAT "us and load time %" G_GUINT64_FORMAT
+			    "us exceed total time %" G_GUINT64_FORMAT "us",
+			    run->plugin_us,
+			    run->device_load_us,
+			    run->total_us);
+		return FALSE;
+	}
+	run->engine_us = run->total_us - run->plugin_us - run->device_load_us;
+	return TRUE;
+}
+
+static gboolean
+fu_util_emulation_benchmark(FuUtilPrivate *priv, gchar **values, GError **error)
+{
+	guint64 count = 10;
+	FuUtilBenchmarkRun mean = {0};
+	g_autoptr(FuCabinet) cabinet = NULL;
+	g_autoptr(GArray) runs = g_array_new(FALSE, TRUE, sizeof(FuUtilBenchmarkRun));
+	g_autoptr(GBytes) emulation_data = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+
+	/* check args */
+	if (g_strv_length(values) != 2 && g_strv_length(values) != 3) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_ARGS,
+				    "Invalid arguments, expected EMULATION-FILE FILE [COUNT]");
+		return FALSE;
+	}
+	if (g_strv_length(values) == 3) {
+		if (!fu_strtoull(values[2], &count, 1, 10000, error))
+			return FALSE;
+	}
+
+	/* progress */
+	fu_progress_set_id(priv->progress, G_STRLOC);
+	fu_progress_add_flag(priv->progress, FU_PROGRESS_FLAG_NO_PROFILE);
+	fu_progress_add_step(priv->progress, FWUPD_STATUS_LOADING, 5, "start-engine");
+	fu_progress_add_step(priv->progress, FWUPD_STATUS_DEVICE_WRITE, 95, NULL);
+
+	/* load engine */
+	if (!fu_util_start_engine(priv,
+				  FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_REMOTES,
+				  fu_progress_get_child(priv->progress),
+				  error))
+		return FALSE;
+	fu_progress_step_done(priv->progress);
+
+	/* fail early rather than on the first run */
+	if (!fu_engine_config_get_allow_emulation(fu_engine_get_config(priv->engine))) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "Device emulation is not enabled, set AllowEmulation=true "
+				    "in the [fwupd] section of fwupd.conf");
+		return FALSE;
+	}
+
+	/* the same recording and firmware is used for every run */
+	emulation_data = fu_bytes_get_contents(values[0], error);
+	if (emulation_data == NULL)
+		return FALSE;
+	stream = fu_input_stream_from_path(values[1], error);
+	if (stream == NULL) {
+		fu_util_maybe_prefix_sandbox_error(values[1], error);
+		return FALSE;
+	}
+	cabinet = fu_engine_build_cabinet_from_stream(priv->engine, stream, error);
+	if (cabinet == NULL)
+		return FALSE;
+
+	/* replay the install, never actually sleeping as the devices are emulated */
+	fu_progress_set_id(fu_progress_get_child(priv->progress), G_STRLOC);
+	fu_progress_set_steps(fu_progress_get_child(priv->progress), (guint)count);
+	for (guint i = 0; i < count; i++) {
+		FuUtilBenchmarkRun run = {0};
+		FuProgress *progress_child = fu_progress_get_child(priv->progress);
+		if (!fu_util_emulation_benchmark_run(priv,
+						     emulation_data,
+						     cabinet,
+						     fu_progress_get_child(progress_child),
+						     &run,
+						     error)) {
+			g_prefix_error(error, "run %u failed: ", i + 1);
+			return FALSE;
+		}
+		g_array_append_val(runs, run);
+		fu_progress_step_done(progress_child);
+	}
+	fu_progress_step_done(priv->progress);
+
+	/* as JSON */
+	if (priv->as_json) {
+		g_autoptr(JsonBuilder) builder = json_builder_new();
+		json_builder_begin_object(builder);
+		json_builder_set_member_name(builder, "Runs");
+		json_builder_begin_array(builder);
+		for (guint i = 0; i < runs->len; i++) {
+			FuUtilBenchmarkRun *run = &g_array_index(runs, FuUtilBenchmarkRun, i);
+			json_builder_begin_object(builder);
+			fwupd_codec_json_append_int(builder, "TotalUs", run->total_us);
+			fwupd_codec_json_append_int(builder, "EngineUs", run->engine_us);
+			fwupd_codec_json_append_int(builder, "PluginUs", run->plugin_us);
+			fwupd_codec_json_append_int(builder, "DeviceLoadUs", run->device_load_us);
+			fwupd_codec_json_append_int(builder,
+						    "SleepSuppressedMs",
+						    run->sleep_suppressed_ms);
+			json_builder_end_object(builder);
+		}
+		json_builder_end_array(builder);
+		json_builder_end_object(builder);
+		return fu_util_print_builder(priv->console, builder, error);
+	}
+
+	/* print */
+	for (guint i = 0; i < runs->len; i++) {
+		FuUtilBenchmarkRun *run = &g_array_index(runs, FuUtilBenchmarkRun, i);
+		fu_console_print(priv->console,
+				 "Run %u: %.1fms total, %.1fms engine bookkeeping, "
+				 "%.1fms plugin vfuncs and device I/O, %.1fms device loading, "
+				 "%" G_GUINT64_FORMAT "ms sleeps suppressed",
+				 i + 1,
+				 (gdouble)run->total_us / 1000.0,
+				 (gdouble)run->engine_us / 1000.0,
+				 (gdouble)run->plugin_us / 1000.0,
+				 (gdouble)run->device_load_us / 1000.0,
+				 run->sleep_suppressed_ms);
+		mean.total_us += run->total_us;
+		mean.engine_us += run->engine_us;
+		mean.plugin_us += run->plugin_us;
+		mean.device_load_us += run->device_load_us;
+		mean.sleep_suppressed_ms += run->sleep_suppressed_ms;
+	}
+	fu_console_print(priv->console,
+			 "Mean: %.1fms total, %.1fms engine bookkeeping, "
+			 "%.1fms plugin vfuncs and device I/O, %.1fms device loading, "
+			 "%" G_GUINT64_FORMAT "ms sleeps suppressed",
+			 (gdouble)mean.total_us / 1000.0 / runs->len,
+			 (gdouble)mean.engine_us / 1000.0 / runs->len,
+			 (gdouble)mean.plugin_us / 1000.0 / runs->len,
+			 (gdouble)mean.device_load_us / 1000.0 / runs->len,
+			 mean.sleep_suppressed_ms / runs->len);
+	return TRUE;
+}
+
 static gboolean
 fu_util_install_release(FuUtilPrivate *priv, FwupdRelease *rel, GError **error)
 {
@@ -4337,6 +4626,20 @@ main(int argc, char *argv[])
 			      /* TRANSLATORS: command description */
 			      _("Get all enabled plugins registered with the system"),
 			      fu_util_get_plugins);
+	fu_util_cmd_array_add(cmd_array,
+			      "get-timings",
+			      NULL,
+			      /* TRANSLATORS: command description */
+			      _("Show how long each plugin and backend took to run"),
+			      fu_util_get_timings);
+	fu_util_cmd_array_add(cmd_array,
+			      "emulation-benchmark",
+			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */
+			      _("EMULATION-FILE FILE [COUNT]"),
+			      /* TRANSLATORS: command description */
+			      _("Replay a recorded install and show where the time was spent, "
+				"which requires AllowEmulation"),
+			      fu_util_emulation_benchmark);
 	fu_util_cmd_array_add(cmd_array,
 			      "get-details",
 			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */
@@ -254,6 +254,12 @@ fu_udev_backend_uevent_cb(GUdevClient *gudev_client,
 			  GUdevDevice *udev_device,
 			  FuUdevBackend *self)
 {
+	FuContext *ctx = fu_backend_get_context(FU_BACKEND(self));
+
+	/* any shared nodes above or below this path are now out of date */
+	if (g_udev_device_get_sysfs_path(udev_device) != NULL)
+		fu_context_invalidate_udev_device(ctx, g_udev_device_get_sysfs_path(udev_device));
+
 	if (g_strcmp0(action, "add") == 0) {
 		fu_udev_backend_device_add(self, udev_device);
 		return;
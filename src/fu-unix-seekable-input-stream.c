@@ -8,6 +8,9 @@
 
 #include "config.h"
 
+#include <fcntl.h>
+#include <glib/gstdio.h>
+
 #include "fu-unix-seekable-input-stream.h"
 
 struct _FuUnixSeekableInputStream {
@@ -133,6 +136,42 @@ fu_unix_seekable_input_stream_new(gint fd, gboolean close_fd)
 			    NULL);
 }
 
+/**
+ * fu_unix_seekable_input_stream_new_sealed:
+ * @fd: a UNIX file descriptor, which is always closed when done
+ *
+ * Creates a new seekable stream for the given fd.
+ *
+ * If @fd is a memfd that has been sealed against writing and shrinking then it is mapped
+ * read-only and the stream reads the pages directly. The sender cannot change the contents once
+ * sealed, so anything validated from this stream stays valid.
+ *
+ * Returns: (transfer full): a #GInputStream
+ *
+ * Since: 2.0.0
+ **/
+GInputStream *
+fu_unix_seekable_input_stream_new_sealed(gint fd)
+{
+#ifdef F_GET_SEALS
+	gint seals = fcntl(fd, F_GET_SEALS);
+	if (seals >= 0 &&
+	    (seals & (F_SEAL_WRITE | F_SEAL_SHRINK)) == (F_SEAL_WRITE | F_SEAL_SHRINK)) {
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(GMappedFile) mmap = g_mapped_file_new_from_fd(fd, FALSE, &error_local);
+		if (mmap != NULL) {
+			g_autoptr(GBytes) blob = g_mapped_file_get_bytes(mmap);
+			g_close(fd, NULL);
+			return g_memory_input_stream_new_from_bytes(blob);
+		}
+		g_debug("failed to map sealed memfd, reading instead: %s", error_local->message);
+	} else {
+		g_debug("fd %i is not a sealed memfd, reading instead", fd);
+	}
+#endif
+	return fu_unix_seekable_input_stream_new(fd, TRUE);
+}
+
 static void
 fu_unix_seekable_input_stream_class_init(FuUnixSeekableInputStreamClass *klass)
 {
@@ -18,3 +18,5 @@ G_DECLARE_FINAL_TYPE(FuUnixSeekableInputStream,
 
 GInputStream *
 fu_unix_seekable_input_stream_new(gint fd, gboolean close_fd);
+GInputStream *
+fu_unix_seekable_input_stream_new_sealed(gint fd);